@@ -0,0 +1,51 @@
+#include "Arena.h"
+#include <stddef.h>
+
+struct ARENA_BLOCK
+{
+  ARENA_BLOCK *next;  // previous block of the arena
+  uint16_t size;
+  uint16_t used;
+  char data[];
+};
+
+void *arenaAlloc(ARENA *arena, uint16_t size)
+{
+  ARENA_BLOCK *block = arena->block;
+
+  if (block == NULL || block->size - block->used < size)
+  {
+    uint16_t blockSize = (size > ARENA_BLOCK_SIZE) ? size : ARENA_BLOCK_SIZE;
+
+    if ((block = memAlloc(arena->tag, sizeof(ARENA_BLOCK) + blockSize)) == NULL)
+      return NULL;
+
+    block->next = arena->block;
+    block->size = blockSize;
+    block->used = 0;
+    arena->block = block;
+    arena->blocks++;
+  }
+
+  block->used += size;
+  arena->used += size;
+
+  if (arena->used > arena->peak)
+    arena->peak = arena->used;
+
+  return block->data + block->used - size;
+}
+
+void arenaReset(ARENA *arena)
+{
+  while (arena->block != NULL)
+  {
+    ARENA_BLOCK *next = arena->block->next;
+
+    memFree(arena->block);
+    arena->block = next;
+  }
+
+  arena->used = 0;
+  arena->blocks = 0;
+}
@@ -0,0 +1,33 @@
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "MemStats.h"
+
+#define ARENA_BLOCK_SIZE 1024  // bytes of the heap blocks of an arena, a longer allocation gets its own block
+
+typedef struct ARENA_BLOCK ARENA_BLOCK;
+
+// bump allocator: allocations are taken one after the other from a few large heap blocks and
+// are all freed at once by arenaReset(), instead of fragmenting the heap with many small blocks
+typedef struct
+{
+  ARENA_BLOCK *block;  // current block, linked to the previous ones
+  uint32_t used;       // bytes allocated since the last reset
+  uint32_t peak;       // most bytes allocated between two resets
+  uint16_t blocks;     // heap blocks held
+  MEM_TAG tag;         // owner of the heap blocks
+} ARENA;
+
+void *arenaAlloc(ARENA *arena, uint16_t size);  // byte aligned, for strings
+void arenaReset(ARENA *arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -10,7 +10,6 @@ static uint8_t setFanSpeed[MAX_FAN_COUNT] = {0};
 static uint8_t curFanSpeed[MAX_FAN_COUNT] = {0};
 static uint8_t needSetFanSpeed = 0;
 
-static bool ctrlFanQueryWait = false;
 static uint32_t nextCtrlFanTime = 0;
 
 // Check whether the index is a valid fan index.
@@ -84,17 +83,3 @@ void loopFan(void)
     }
   }
 }
-
-void ctrlFanQuerySetWait(bool wait)
-{
-  ctrlFanQueryWait = wait;
-}
-
-// query for controller fan only
-void ctrlFanQuery(void)
-{
-  if (infoHost.connected && !infoHost.wait && !ctrlFanQueryWait && infoSettings.ctrl_fan_en)
-  {
-    ctrlFanQueryWait = storeCmd("M710\n");
-  }
-}
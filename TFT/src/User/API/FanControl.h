@@ -27,8 +27,6 @@ uint8_t fanGetCurSpeed(uint8_t i);
 void fanSetCurPercent(uint8_t i, uint8_t percent);
 uint8_t fanGetCurPercent(uint8_t i);
 void loopFan(void);
-void ctrlFanQuerySetWait(bool wait);
-void ctrlFanQuery(void);
 
 #ifdef __cplusplus
 }
@@ -1,5 +1,9 @@
 #include "FlashStore.h"
 #include "HAL_Flash.h"
+#include "my_misc.h"
+#include "boot.h"
+#include "w25qxx.h"
+#include <stddef.h>
 #include <string.h>
 
 #ifdef I2C_EEPROM  // added I2C_EEPROM suppport for MKS_TFT35_V1_0
@@ -21,6 +25,247 @@ SETTINGS infoSettings;
 
 uint8_t paraStatus = 0;
 
+#ifndef I2C_EEPROM
+
+// The settings buffer is stored as a log of records, each one holding a chunk of the buffer. Saving the
+// settings only appends the changed chunks, the pages are erased only when full. Then the whole buffer
+// is written to the next page, which becomes valid once its header is written (last)
+
+#define PARA_LOG_SIGN 0x20221019  // (YYYYMMDD) change if the log format changes
+#define PARA_CHUNKS   (PARA_SIZE / PARA_CHUNK_SIZE)
+
+typedef struct
+{
+  uint32_t sign;
+  uint32_t seq;  // incremented at each page change, the highest one is the page in use
+} PARA_PAGE_HEADER;
+
+typedef struct
+{
+  uint32_t key;  // index of the chunk, 0xFFFFFFFF if the record is free
+  uint8_t  data[PARA_CHUNK_SIZE];
+  uint32_t crc;  // CRC32 of key and data
+} PARA_RECORD;
+
+#define PARA_PAGE_RECORDS ((PARA_PAGE_SIZE - sizeof(PARA_PAGE_HEADER)) / sizeof(PARA_RECORD))
+
+static uint8_t paraStored[PARA_SIZE];  // settings buffer as currently stored
+static bool paraLogValid = false;
+static uint8_t paraPage;               // page in use
+static uint32_t paraSeq;               // sequence of the page in use
+static uint16_t paraRecord;            // next free record in the page in use
+
+static inline uint32_t paraRecordOffset(uint16_t record)
+{
+  return sizeof(PARA_PAGE_HEADER) + record * sizeof(PARA_RECORD);
+}
+
+// replay the records of the valid pages, oldest first, so a page not completed yet still
+// has the older ones below it. Return false if there is no log in flash
+static bool paraLogRead(uint8_t *data)
+{
+  PARA_PAGE_HEADER header[PARA_PAGE_COUNT];
+  uint8_t replayed = 0;
+
+  memset(data, 0xFF, PARA_SIZE);
+  paraLogValid = false;
+
+  for (uint8_t page = 0; page < PARA_PAGE_COUNT; page++)
+  {
+    HAL_FlashReadPage(page, 0, (uint8_t *)&header[page], sizeof(PARA_PAGE_HEADER));
+  }
+
+  while (true)
+  {
+    int16_t oldest = -1;
+
+    for (uint8_t page = 0; page < PARA_PAGE_COUNT; page++)
+    {
+      if (header[page].sign != PARA_LOG_SIGN || (paraLogValid && header[page].seq <= paraSeq))
+        continue;
+
+      if (oldest < 0 || header[page].seq < header[oldest].seq)
+        oldest = page;
+    }
+
+    if (oldest < 0)
+      break;
+
+    paraLogValid = true;
+    paraPage = oldest;
+    paraSeq = header[oldest].seq;
+    paraRecord = PARA_PAGE_RECORDS;  // full if no free record, to start a new page on next write
+
+    for (uint16_t i = 0; i < PARA_PAGE_RECORDS; i++)
+    {
+      PARA_RECORD record;
+
+      HAL_FlashReadPage(paraPage, paraRecordOffset(i), (uint8_t *)&record, sizeof(record));
+
+      if (record.key == 0xFFFFFFFF)
+      {
+        paraRecord = i;
+        break;
+      }
+
+      // a write interrupted by a reset, the page can't be written anymore after it
+      if (record.key >= PARA_CHUNKS || record.crc != getCRC32(0, (uint8_t *)&record, offsetof(PARA_RECORD, crc)))
+        break;
+
+      memcpy(data + record.key * PARA_CHUNK_SIZE, record.data, PARA_CHUNK_SIZE);
+    }
+
+    replayed++;
+  }
+
+  return replayed > 0;
+}
+
+static void paraLogWriteRecord(uint16_t key)
+{
+  PARA_RECORD record;
+
+  record.key = key;
+  memcpy(record.data, paraStored + key * PARA_CHUNK_SIZE, PARA_CHUNK_SIZE);
+  record.crc = getCRC32(0, (uint8_t *)&record, offsetof(PARA_RECORD, crc));
+
+  HAL_FlashWritePage(paraPage, paraRecordOffset(paraRecord++), (uint8_t *)&record, sizeof(record));
+}
+
+// write the whole settings buffer to the next page
+static void paraLogNewPage(void)
+{
+  PARA_PAGE_HEADER header = {PARA_LOG_SIGN, paraLogValid ? paraSeq + 1 : 0};
+
+  paraPage = paraLogValid ? (paraPage + 1) % PARA_PAGE_COUNT : 0;
+  paraSeq = header.seq;
+  paraRecord = 0;
+
+  HAL_FlashErasePage(paraPage);
+
+  for (uint16_t key = 0; key < PARA_CHUNKS; key++)
+  {
+    paraLogWriteRecord(key);
+  }
+
+  HAL_FlashWritePage(paraPage, 0, (uint8_t *)&header, sizeof(header));
+  paraLogValid = true;
+}
+
+#if PARA_PAGE_COUNT == 1
+
+// With a single page, a reset between its erase and its header write would lose all the settings (touch screen
+// calibration included), so the settings buffer is first copied to the W25Qxx and verified. The copy is read back
+// if the page was not completed, and voided once it is
+
+typedef struct
+{
+  uint32_t sign;  // PARA_LOG_SIGN, 0 once voided
+  uint8_t  data[PARA_SIZE];
+  uint32_t crc;   // CRC32 of sign and data
+} PARA_BACKUP;
+
+#define PARA_BACKUP_CHUNK 64  // bytes compared at once on verify
+
+// return false if there is no verified copy, the page must not be erased then
+static bool paraBackupWrite(const uint8_t *data)
+{
+  uint32_t capacity = W25Qxx_ReadCapacity();
+  PARA_BACKUP backup;
+
+  if (capacity == 0)  // unknown chip
+    return false;
+
+  backup.sign = PARA_LOG_SIGN;
+  memcpy(backup.data, data, PARA_SIZE);
+  backup.crc = getCRC32(0, (uint8_t *)&backup, offsetof(PARA_BACKUP, crc));
+
+  W25Qxx_EraseSector(PARA_BACKUP_ADDR(capacity));
+  W25Qxx_WriteBuffer((uint8_t *)&backup, PARA_BACKUP_ADDR(capacity), sizeof(backup));
+
+  for (uint16_t i = 0; i < sizeof(backup); i += PARA_BACKUP_CHUNK)
+  {
+    uint8_t verify[PARA_BACKUP_CHUNK];
+    uint16_t len = MIN(PARA_BACKUP_CHUNK, sizeof(backup) - i);
+
+    W25Qxx_ReadBuffer(verify, PARA_BACKUP_ADDR(capacity) + i, len);
+    if (memcmp(verify, (uint8_t *)&backup + i, len) != 0)
+      return false;
+  }
+  return true;
+}
+
+// void the copy, programming the sign to 0 needs no erase
+static void paraBackupClear(void)
+{
+  uint32_t sign = 0;
+
+  W25Qxx_WritePage((uint8_t *)&sign, PARA_BACKUP_ADDR(W25Qxx_ReadCapacity()), sizeof(sign));
+}
+
+// complete the page rewrite interrupted by a reset from the copy, return false if there is none
+static bool paraBackupRestore(uint8_t *data)
+{
+  uint32_t capacity = W25Qxx_ReadCapacity();
+  PARA_BACKUP backup;
+
+  if (capacity == 0)
+    return false;
+
+  W25Qxx_ReadBuffer((uint8_t *)&backup, PARA_BACKUP_ADDR(capacity), sizeof(backup));
+  if (backup.sign != PARA_LOG_SIGN || backup.crc != getCRC32(0, (uint8_t *)&backup, offsetof(PARA_BACKUP, crc)))
+    return false;
+
+  memcpy(data, backup.data, PARA_SIZE);
+  memcpy(paraStored, data, PARA_SIZE);
+  paraLogNewPage();
+  paraBackupClear();
+  return true;
+}
+
+#else  // a page is rewritten only while the other one is valid
+
+#define paraBackupWrite(data) true
+#define paraBackupClear()
+#define paraBackupRestore(data) false
+
+#endif
+
+static void paraLogWrite(const uint8_t *data)
+{
+  uint16_t changed[PARA_CHUNKS];
+  uint16_t count = 0;
+
+  for (uint16_t key = 0; key < PARA_CHUNKS; key++)
+  {
+    if (memcmp(paraStored + key * PARA_CHUNK_SIZE, data + key * PARA_CHUNK_SIZE, PARA_CHUNK_SIZE) != 0)
+      changed[count++] = key;
+  }
+
+  if (count == 0)
+    return;
+
+  if (!paraLogValid || paraRecord + count > PARA_PAGE_RECORDS)
+  {
+    if (paraBackupWrite(data))  // else the settings stored are kept, the next save retries
+    {
+      memcpy(paraStored, data, PARA_SIZE);
+      paraLogNewPage();
+      paraBackupClear();
+    }
+    return;
+  }
+
+  memcpy(paraStored, data, PARA_SIZE);
+
+  for (uint16_t i = 0; i < count; i++)
+  {
+    paraLogWriteRecord(changed[i]);
+  }
+}
+
+#endif  // not I2C_EEPROM
+
 void wordToByte(uint32_t word, uint8_t *bytes)
 {
   uint8_t len = 4;
@@ -54,7 +299,10 @@ void readStoredPara(void)
 #ifdef I2C_EEPROM  // added I2C_EEPROM suppport for MKS_TFT35_V1_0
   EEPROM_FlashRead(data, PARA_SIZE);
 #else
-  HAL_FlashRead(data, PARA_SIZE);
+  if (!paraLogRead(data) && !paraBackupRestore(data))
+    HAL_FlashRead(data, PARA_SIZE);  // stored as a single block by a previous release
+
+  memcpy(paraStored, data, PARA_SIZE);
 #endif
 
   sign = byteToWord(data + (index += 4), 4);
@@ -85,6 +333,7 @@ void storePara(void)
   uint8_t data[PARA_SIZE];
   uint32_t index = 0;
 
+  memset(data, 0, PARA_SIZE);  // unused bytes must not change, or they would be written to the log
   wordToByte(TSC_SIGN, data + (index += 4));
   for (int i = 0; i < sizeof(TSC_Para) / sizeof(TSC_Para[0]); i++)
   {
@@ -96,7 +345,7 @@ void storePara(void)
 #ifdef I2C_EEPROM                      // added I2C_EEPROM suppport for MKS_TFT35_V1_0
   EEPROM_FlashWrite(data, PARA_SIZE);  // store settings in I2C_EEPROM
 #else
-  HAL_FlashWrite(data, PARA_SIZE);
+  paraLogWrite(data);  // only the changed chunks
 #endif
 }
 
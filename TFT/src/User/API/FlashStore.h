@@ -9,7 +9,8 @@ extern "C" {
 #include <stdint.h>
 #include "Settings.h"
 
-#define PARA_SIZE (128 * 3)  // Max size of settings buffer to read/write
+#define PARA_SIZE       (128 * 3)  // Max size of settings buffer to read/write
+#define PARA_CHUNK_SIZE 16         // bytes of the settings buffer per record of the log in flash, only changed ones are written
 
 extern int32_t TSC_Para[7];
 extern SETTINGS infoSettings;
@@ -17,7 +17,7 @@ void clearRequestCommandInfo(void)
 {
   if (requestCommandInfo.cmd_rev_buf != NULL)
   {
-    free(requestCommandInfo.cmd_rev_buf);
+    memFree(requestCommandInfo.cmd_rev_buf);
     requestCommandInfo.cmd_rev_buf = NULL;
   }
 }
@@ -32,7 +32,7 @@ static void resetRequestCommandInfo(
 {
   clearRequestCommandInfo();  // release requestCommandInfo.cmd_rev_buf before allocating a new one
 
-  requestCommandInfo.cmd_rev_buf = malloc(CMD_MAX_REV);
+  requestCommandInfo.cmd_rev_buf = memAlloc(MEM_GCODE, CMD_MAX_REV);
 
   while (!requestCommandInfo.cmd_rev_buf)
     ;  // malloc failed
@@ -228,20 +228,6 @@ void request_M25(void)
   mustStoreCmd("M25 P1\n");
 }
 
-/**
- * @brief Print status (start auto report)
- * @param seconds: Pass 0 to disable auto report. Pass delay in seconds
- *                 for auto query if available in marlin.
- *
- * ->  SD printing byte 123/12345
- * ->  Not SD printing
- */
-void request_M27(uint8_t seconds)
-{
-  if (infoMachineSettings.autoReportSDStatus == 1)
-    mustStoreCmd("M27 S%d\n", seconds);
-}
-
 /**
  * Park Head / Pause Print
  */
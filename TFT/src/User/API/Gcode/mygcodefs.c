@@ -69,7 +69,7 @@ void getName(bool filename, char * longPath, const char * shortPath, const char
     if (strcmp(name, "???") != 0)  // if long name exists
     {
       strLen = strlen(name) + strLenExtra;
-      longName = malloc(strLen);
+      longName = allocInfoFileName(strLen);
       if (longName == NULL)  // in case of error, free the buffer allocated by M33 (including "name") and exit
       {
         clearRequestCommandInfo();
@@ -87,14 +87,9 @@ void getName(bool filename, char * longPath, const char * shortPath, const char
   //
 
   strLen = strlen(relativePath) + strLenExtra;
-  shortName = malloc(strLen);
-  if (shortName == NULL)  // in case of error, free the buffer allocated for "longName", if any, and exit
-  {
-    if (longName != NULL)
-      free(longName);
-
+  shortName = allocInfoFileName(strLen);
+  if (shortName == NULL)  // in case of error, exit ("longName", if any, is freed with the file list)
     return;
-  }
 
   strncpy(shortName, relativePath, strLen);  // set "shortName" and set the flag for filename extension check, if any
 
@@ -152,7 +147,7 @@ bool scanPrintFilesGcodeFs(void)
   }
 
   char * ret = request_M20();             // retrieve file list
-  char * data = malloc(strlen(ret) + 1);
+  char * data = memAlloc(MEM_FILES, strlen(ret) + 1);
   strcpy(data, ret);                      // copy file list in "data"
   clearRequestCommandInfo();              // free the buffer allocated by M20 (including "ret")
 
@@ -286,6 +281,6 @@ bool scanPrintFilesGcodeFs(void)
     }
   }
 
-  free(data);
+  memFree(data);
   return true;
 }
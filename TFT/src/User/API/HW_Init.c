@@ -24,6 +24,25 @@ void HW_GetClocksFreq(CLOCKS *clk)
     clk->PCLK2_Timer_Frequency = clk->rccClocks.PCLK2_Frequency;
 }
 
+#if defined(SERIAL_DEBUG_PORT) && defined(SERIAL_DEBUG_ENABLED)
+// time a full screen clear (done on most menu changes) with the fill path of this board
+static void HW_ClearBenchmark(void)
+{
+  #ifndef STM32_HAS_FSMC
+    const char * fillPath = "GPIO burst";
+  #elif LCD_DATA_16BIT == 1
+    const char * fillPath = "FSMC DMA";
+  #else
+    const char * fillPath = "FSMC CPU";
+  #endif
+  uint32_t start = OS_GetTimeUs();
+
+  GUI_Clear(BLACK);
+  lcd_frame_wait();
+  dbg_printf("LCD clear %dx%d by %s fill: %lu us\n", LCD_WIDTH, LCD_HEIGHT, fillPath, OS_GetTimeUs() - start);
+}
+#endif
+
 void HW_Init(void)
 {
   HW_GetClocksFreq(&mcuClocks);
@@ -60,6 +79,7 @@ void HW_Init(void)
 
   #if defined(SERIAL_DEBUG_PORT) && defined(SERIAL_DEBUG_ENABLED)
     Serial_Init(ALL_PORTS);  // initialize serial ports first if debugging is enabled
+    HW_ClearBenchmark();
   #endif
 
   #ifdef USB_FLASH_DRIVE_SUPPORT
@@ -60,6 +60,11 @@ bool LCD_IsBlocked(void)
   return true;
 }
 
+bool LCD_IsDimmed(void)
+{
+  return lcd_dim.dimmed;
+}
+
 void LCD_Wake(void)
 {
   if (infoSettings.lcd_idle_time != IDLE_TIME_OFF)
@@ -68,6 +68,7 @@ extern "C" {
   extern const LABEL lcd_idle_time_names[LCD_IDLE_TIME_COUNT];
 
   bool LCD_IsBlocked(void);
+  bool LCD_IsDimmed(void);
   void LCD_Wake(void);
   void LCD_CheckDimming(void);
 
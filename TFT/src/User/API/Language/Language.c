@@ -52,8 +52,14 @@
 //
 // Add new Keywords in Language.inc file Only
 //
+#define LABEL_READ_CHUNK 32  // labels are read from flash by chunks up to their end, most of them are short
+
 uint8_t tempLabelString[MAX_LANG_LABEL_LENGTH];
 
+static uint8_t labelCache[LABEL_CACHE_SIZE];
+static uint16_t labelCacheOffset[LABEL_NUM];  // offset + 1 of the label in labelCache, 0: not cached
+static uint16_t labelCacheUsed = 0;
+
 const char *const default_pack[LABEL_NUM] = {
   #define X_WORD(NAME) STRING_##NAME ,
     #include "Language.inc"
@@ -68,6 +74,43 @@ const char *const lang_key_list[LABEL_NUM] =
   #undef X_WORD
 };
 
+void labelCacheClear(void)
+{
+  memset(labelCacheOffset, 0, sizeof(labelCacheOffset));
+  labelCacheUsed = 0;
+}
+
+bool labelCacheLoad(uint16_t index)
+{
+  uint32_t addr;
+  uint16_t len = 0;
+  bool kept = true;
+
+  if (index >= LABEL_NUM || labelCacheOffset[index] != 0)
+    return true;
+
+  addr = getLabelFlashAddr(index);
+  do
+  {
+    W25Qxx_ReadBuffer(tempLabelString + len, addr + len, LABEL_READ_CHUNK);
+    len += LABEL_READ_CHUNK;
+  } while (len < MAX_LANG_LABEL_LENGTH && memchr(tempLabelString + len - LABEL_READ_CHUNK, '\0', LABEL_READ_CHUNK) == NULL);
+
+  len = strnlen((char *)tempLabelString, MAX_LANG_LABEL_LENGTH - 1);
+  tempLabelString[len++] = '\0';
+
+  if (len > LABEL_CACHE_SIZE - labelCacheUsed)  // full, start again with the labels in use from now on
+  {
+    labelCacheClear();
+    kept = false;
+  }
+
+  memcpy(labelCache + labelCacheUsed, tempLabelString, len);
+  labelCacheOffset[index] = labelCacheUsed + 1;
+  labelCacheUsed += len;
+  return kept;
+}
+
 uint8_t *textSelect(uint16_t sel)
 {
   switch (infoSettings.language)
@@ -75,8 +118,11 @@ uint8_t *textSelect(uint16_t sel)
     case LANG_DEFAULT:
       return (uint8_t *)default_pack[sel];
     case LANG_FLASH:
-      loadLabelText(tempLabelString, sel);
-      return tempLabelString;
+      if (sel >= LABEL_NUM)
+        return tempLabelString;
+
+      labelCacheLoad(sel);
+      return labelCache + labelCacheOffset[sel] - 1;
     default:
       return NULL;
   }
@@ -92,7 +138,7 @@ bool loadLabelText(uint8_t* buf, uint16_t index)
 {
   if (index >= LABEL_NUM) return false;
   if (infoSettings.language == LANG_FLASH)
-    W25Qxx_ReadBuffer(buf, getLabelFlashAddr(index), MAX_LANG_LABEL_LENGTH);
+    strcpy((char *)buf, (char *)textSelect(index));
   else
     memcpy(buf, textSelect(index), sizeof(tempLabelString));
   return true;
@@ -10,6 +10,15 @@ extern "C" {
 
 #define MAX_LANG_LABEL_LENGTH W25QXX_SPI_PAGESIZE
 
+// RAM for the labels of the language pack in SPI flash, read once and packed one after another
+#ifndef LABEL_CACHE_SIZE
+  #if RAM_SIZE < 96
+    #define LABEL_CACHE_SIZE 1024
+  #else
+    #define LABEL_CACHE_SIZE 4096
+  #endif
+#endif
+
 #define ENGLISH       0
 #define CHINESE       1
 #define RUSSIAN       2
@@ -65,6 +74,12 @@ uint32_t getLabelFlashAddr(uint16_t index);
 // load selected label text into buffer form spi flash
 bool loadLabelText(uint8_t * buf, uint16_t index);
 
+// drop the cached labels, the language pack in SPI flash is rewritten
+void labelCacheClear(void);
+
+// load the label in the cache, false if the cache had to be cleared to make room
+bool labelCacheLoad(uint16_t index);
+
 // initialize and preload label text
 #define LABELCHAR(x, i)  char x[MAX_LANG_LABEL_LENGTH]; loadLabelText((uint8_t*)&x, i);
 
@@ -0,0 +1,214 @@
+#include "MemStats.h"
+#include "includes.h"
+#include <malloc.h>
+
+#define MEM_MAGIC   0xA5C3      // in the header of each block, a different value means it was overwritten
+#define MEM_GUARD   0x3CA55AC3  // written right after each block, a different value means an overrun
+#define STACK_PAINT 0xC5C5C5C5  // fill of the stack not used yet
+
+// bookkeeping before each block, 8 bytes to keep the alignment of malloc()
+typedef struct
+{
+  uint32_t size;
+  uint8_t tag;
+  uint8_t reserved;
+  uint16_t magic;
+} MEM_HEADER;
+
+static const char *const memTagNames[MEM_TAG_COUNT] = {"Serial", "Files", "Gcode", "FatFs", "Mesh", "UI", "Boot"};
+
+static MEM_STATS memStats[MEM_TAG_COUNT];
+static uint32_t memTracked = 0;
+static uint16_t memCorrupted = 0;  // blocks freed with an overwritten header, their owner is unknown
+
+#ifndef NATIVE_HOST
+  extern char _end[], _estack[], _Min_Stack_Size[];  // from the linker script
+
+  static uint32_t *stackBottom = NULL;  // lowest word painted
+#endif
+
+void *memAlloc(MEM_TAG tag, size_t size)
+{
+  MEM_STATS *stats = &memStats[tag];
+  MEM_HEADER *header = malloc(sizeof(MEM_HEADER) + size + sizeof(uint32_t));
+  uint32_t guard = MEM_GUARD;
+
+  if (header == NULL)
+  {
+    stats->fails++;
+    return NULL;
+  }
+
+  header->size = size;
+  header->tag = tag;
+  header->magic = MEM_MAGIC;
+  memcpy((uint8_t *)(header + 1) + size, &guard, sizeof(guard));  // the end of the block may be unaligned
+
+  stats->used += size;
+  stats->blocks++;
+  memTracked += sizeof(MEM_HEADER) + size + sizeof(uint32_t);
+
+  if (stats->used > stats->peak)
+    stats->peak = stats->used;
+
+  return header + 1;
+}
+
+void *memCalloc(MEM_TAG tag, size_t count, size_t size)
+{
+  void *ptr = memAlloc(tag, count * size);
+
+  if (ptr != NULL)
+    memset(ptr, 0, count * size);
+
+  return ptr;
+}
+
+void memFree(void *ptr)
+{
+  MEM_HEADER *header;
+  uint32_t guard;
+
+  if (ptr == NULL)
+    return;
+
+  header = (MEM_HEADER *)ptr - 1;
+
+  if (header->magic != MEM_MAGIC || header->tag >= MEM_TAG_COUNT)
+  {
+    memCorrupted++;  // the size is not reliable either, leak the block rather than corrupt the heap further
+    return;
+  }
+
+  MEM_STATS *stats = &memStats[header->tag];
+
+  memcpy(&guard, (uint8_t *)ptr + header->size, sizeof(guard));
+  if (guard != MEM_GUARD)
+    stats->overruns++;
+
+  stats->used -= header->size;
+  stats->blocks--;
+  memTracked -= sizeof(MEM_HEADER) + header->size + sizeof(uint32_t);
+
+  header->magic = 0;  // catch a second free of the block
+  free(header);
+}
+
+const char *memTagName(MEM_TAG tag)
+{
+  return memTagNames[tag];
+}
+
+const MEM_STATS *memGetStats(MEM_TAG tag)
+{
+  return &memStats[tag];
+}
+
+uint32_t memTrackedBytes(void)
+{
+  return memTracked;
+}
+
+void getHeapInfo(HEAP_INFO *info)
+{
+  #ifdef NATIVE_HOST
+    struct mallinfo2 heap = mallinfo2();  // mallinfo() is deprecated by glibc
+  #else
+    struct mallinfo heap = mallinfo();
+  #endif
+
+  info->size = heap.arena;
+  info->used = heap.uordblks;
+  info->free = heap.fordblks;
+}
+
+#ifndef NATIVE_HOST
+
+// first word above the heap, the heap starts at the end of the static RAM
+static uint32_t *heapTop(void)
+{
+  HEAP_INFO heap;
+
+  getHeapInfo(&heap);
+  return (uint32_t *)(((uintptr_t)_end + heap.size + 3) & ~3);
+}
+
+#endif
+
+// fill the RAM between the heap and the stack with a pattern, the stack use is where the pattern is gone
+void memStackPaint(void)
+{
+  #ifndef NATIVE_HOST
+    uint32_t *p = heapTop();
+    uint32_t *sp = (uint32_t *)&p;
+
+    stackBottom = p;
+    while (p < sp - 16)  // keep clear of the frame of this function
+      *p++ = STACK_PAINT;
+  #endif
+}
+
+void getStackInfo(STACK_INFO *info)
+{
+  #ifdef NATIVE_HOST
+    memset(info, 0, sizeof(STACK_INFO));  // no linker script on the host
+  #else
+    uint32_t *top = heapTop();
+    uint32_t *p = MAX(top, stackBottom);
+
+    while (p < (uint32_t *)_estack && *p == STACK_PAINT)
+      p++;
+
+    info->size = (uint32_t)_Min_Stack_Size;
+    info->used = _estack - (char *)p;
+    info->gap = (p > top) ? (char *)p - (char *)top : 0;  // no gap: the stack ran into the heap
+  #endif
+}
+
+// run by the loop tasks once a second
+void memCheck(void)
+{
+  static MEM_STATS notified[MEM_TAG_COUNT];  // counters already notified
+  static uint16_t corrupted = 0;
+  static bool stackLow = false;
+
+  char msg[MAX_MSG_LENGTH];
+
+  for (uint8_t i = 0; i < MEM_TAG_COUNT; i++)
+  {
+    if (memStats[i].fails != notified[i].fails)
+    {
+      sprintf(msg, "Out of heap, %u allocations failed (%s)", memStats[i].fails, memTagNames[i]);
+      addNotification(DIALOG_TYPE_ERROR, "Memory", msg, false);
+    }
+
+    if (memStats[i].overruns != notified[i].overruns)
+    {
+      sprintf(msg, "%u heap blocks overrun (%s)", memStats[i].overruns, memTagNames[i]);
+      addNotification(DIALOG_TYPE_ERROR, "Memory", msg, false);
+    }
+
+    notified[i] = memStats[i];
+  }
+
+  if (memCorrupted != corrupted)
+  {
+    corrupted = memCorrupted;
+    sprintf(msg, "%u heap blocks overwritten", corrupted);
+    addNotification(DIALOG_TYPE_ERROR, "Memory", msg, false);
+  }
+
+  if (!stackLow)
+  {
+    STACK_INFO stack;
+
+    getStackInfo(&stack);
+
+    if (stack.size != 0 && stack.gap < MEM_LOW_LIMIT)
+    {
+      stackLow = true;
+      sprintf(msg, "Stack %lu bytes from the heap", (unsigned long)stack.gap);
+      addNotification(DIALOG_TYPE_ERROR, "Memory", msg, false);
+    }
+  }
+}
@@ -0,0 +1,69 @@
+#ifndef _MEM_STATS_H_
+#define _MEM_STATS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define MEM_LOW_LIMIT 2048  // bytes, warn when the stack gets closer than this to the heap
+
+// owners of the heap blocks allocated by memAlloc()
+typedef enum
+{
+  MEM_SERIAL = 0,  // serial port DMA caches
+  MEM_FILES,       // file list names and file scan buffers
+  MEM_GCODE,       // gcode requests replies
+  MEM_FATFS,       // FatFs long filename buffers and SD speed test
+  MEM_MESH,        // mesh editor
+  MEM_UI,          // settings copy, Marlin mode glyphs, popup messages
+  MEM_BOOT,        // boot and config file parsing
+  MEM_TAG_COUNT
+} MEM_TAG;
+
+typedef struct
+{
+  uint32_t used;      // bytes allocated
+  uint32_t peak;      // most bytes allocated at once
+  uint16_t blocks;    // blocks allocated
+  uint16_t fails;     // allocations failed for lack of heap
+  uint16_t overruns;  // blocks found written past their end when freed
+} MEM_STATS;
+
+typedef struct
+{
+  uint32_t size;  // heap size, the high-water mark of the heap as the heap never shrinks
+  uint32_t used;  // bytes allocated
+  uint32_t free;  // free bytes within the heap size, in between the allocated blocks
+} HEAP_INFO;
+
+typedef struct
+{
+  uint32_t size;  // stack reserved by the linker script
+  uint32_t used;  // most bytes used since boot
+  uint32_t gap;   // bytes never touched between the top of the heap and the deepest stack use
+} STACK_INFO;
+
+void *memAlloc(MEM_TAG tag, size_t size);
+void *memCalloc(MEM_TAG tag, size_t count, size_t size);
+void memFree(void *ptr);
+
+const char *memTagName(MEM_TAG tag);
+const MEM_STATS *memGetStats(MEM_TAG tag);
+uint32_t memTrackedBytes(void);  // bytes allocated by memAlloc(), with their bookkeeping
+
+void getHeapInfo(HEAP_INFO *info);
+
+void memStackPaint(void);  // call first in main(), to measure the stack use
+void getStackInfo(STACK_INFO *info);
+
+void memCheck(void);  // notify the memory shortages and the overruns, once each
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
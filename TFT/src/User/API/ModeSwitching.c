@@ -33,7 +33,7 @@ void Mode_Switch(void)
 
           heatSetUpdateSeconds(TEMPERATURE_QUERY_FAST_SECONDS);
           LOGO_ReadDisplay();
-          updateNextHeatCheckTime();  // send "M105" after a delay, because of mega2560 will be hanged when received data at startup
+          telemetryPostpone(TELEMETRY_TEMP);  // send "M105" after a delay, because of mega2560 will be hanged when received data at startup
 
           while (OS_GetTimeMs() - startUpTime < BTT_BOOTSCREEN_TIME)  // display logo BTT_BOOTSCREEN_TIME ms
           {
@@ -49,7 +49,7 @@ void Mode_Switch(void)
     case MODE_MARLIN:
       #ifdef HAS_EMULATOR
         if (infoSettings.serial_always_on == ENABLED)
-          updateNextHeatCheckTime();  // send "M105" after a delay, because of mega2560 will be hanged when received data at startup
+          telemetryPostpone(TELEMETRY_TEMP);  // send "M105" after a delay, because of mega2560 will be hanged when received data at startup
 
         REPLACE_MENU(menuMarlinMode);
       #endif
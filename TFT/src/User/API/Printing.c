@@ -24,7 +24,6 @@ typedef struct
 PRINTING infoPrinting = {0};
 PRINT_SUMMARY infoPrintSummary = {.name[0] = '\0', 0, 0, 0, 0, false};
 
-static bool updateM27Waiting = false;
 static bool extrusionDuringPause = false;  // flag for extrusion during Print -> Pause
 static bool filamentRunoutAlarm = false;
 static float lastEPos = 0;                 // used only to update stats in infoPrintSummary
@@ -305,11 +304,6 @@ void sendPrintCodes(uint8_t index)
   }
 }
 
-void printSetUpdateWaiting(bool isWaiting)
-{
-  updateM27Waiting = isWaiting;
-}
-
 void updatePrintUsedFilament(void)
 {
   float ePos = coordinateGetAxis(E_AXIS);
@@ -346,8 +340,8 @@ void printComplete(void)
     case FS_ONBOARD_MEDIA:
     case FS_ONBOARD_MEDIA_REMOTE:
       infoHost.status = HOST_STATUS_IDLE;
-      request_M27(0);
-      coordinateQueryTurnOff();  // disable position auto report, if any
+      telemetrySetSeconds(TELEMETRY_PRINT, 0);
+      telemetrySetSeconds(TELEMETRY_POS, 0);  // set by the Printing menu
       break;
 
     case FS_REMOTE_HOST:
@@ -385,7 +379,7 @@ bool printRemoteStart(const char * filename)
     resetInfoFile();                            // then reset infoFile (source is restored)
     enterFolder(stripHead(filename));           // set path as last
 
-    request_M27(infoSettings.m27_refresh_time);  // use gcode M27 in case of a print running from remote onboard media
+    telemetrySetSeconds(TELEMETRY_PRINT, infoSettings.m27_refresh_time);  // print status of the remote onboard media
   }
   else
   {
@@ -467,7 +461,7 @@ bool printStart(void)
     infoHost.status = HOST_STATUS_RESUMING;
 
     request_M24(0);                              // start print from onboard media
-    request_M27(infoSettings.m27_refresh_time);  // use gcode M27 in case of a print running from onboard media
+    telemetrySetSeconds(TELEMETRY_PRINT, infoSettings.m27_refresh_time);  // print status of the onboard media
   }
 
   initPrintSummary();  // init print summary as last (it requires infoFile is properly set)
@@ -868,37 +862,3 @@ void loopPrintFromTFT(void)
     printAbort();
   }
 }
-
-void loopPrintFromOnboard(void)
-{
-  #ifdef HAS_EMULATOR
-    if (MENU_IS(menuMarlinMode)) return;
-  #endif
-
-  if (!infoPrinting.printing) return;
-  if (infoFile.source < FS_ONBOARD_MEDIA || infoFile.source > FS_ONBOARD_MEDIA_REMOTE) return;  // if not printing from (remote) onboard media
-  if (infoMachineSettings.autoReportSDStatus == ENABLED) return;
-  if (!infoSettings.m27_active) return;
-  if (MENU_IS(menuTerminal)) return;
-
-  static uint32_t nextCheckPrintTime = 0;
-  uint32_t update_M27_time = SEC_TO_MS(infoSettings.m27_refresh_time);
-
-  do
-  { // WAIT FOR M27
-    if (updateM27Waiting == true)
-    {
-      nextCheckPrintTime = OS_GetTimeMs() + update_M27_time;
-      break;
-    }
-
-    if (OS_GetTimeMs() < nextCheckPrintTime)
-      break;
-
-    if (storeCmd("M27\n") == false)
-      break;
-
-    nextCheckPrintTime = OS_GetTimeMs() + update_M27_time;
-    updateM27Waiting = true;
-  } while (0);
-}
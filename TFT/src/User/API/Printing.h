@@ -105,7 +105,6 @@ bool getPrintRunout(void);
 //void preparePrintSummary(void);
 //void sendPrintCodes(uint8_t index);
 
-void printSetUpdateWaiting(bool isWaiting);           // called in interfaceCmd.c
 void updatePrintUsedFilament(void);                   // called in PrintingMenu.c
 void clearInfoPrint(void);                            // called in PrintingMenu.c
 
@@ -141,8 +140,7 @@ void setPrintAbort(void);
 void setPrintPause(HOST_STATUS hostStatus, PAUSE_TYPE pauseType);
 void setPrintResume(HOST_STATUS hostStatus);
 
-void loopPrintFromTFT(void);      // called in loopBackEnd(). It handles a print from TFT media, if any
-void loopPrintFromOnboard(void);  // called in loopBackEnd(). It handles a print from (remote) onboard media, if any
+void loopPrintFromTFT(void);  // called in loopBackEnd(). It handles a print from TFT media, if any
 
 #ifdef __cplusplus
 }
@@ -113,7 +113,7 @@ void probeHeightQueryCoord(void)
 {
   if (OS_GetTimeMs() > nextQueryTime)
   {
-    coordinateQuery(0);  // query position manually for delay less than 1 second
+    telemetryQuery(TELEMETRY_POS);  // query position manually for delay less than 1 second
     nextQueryTime = OS_GetTimeMs() + PROBE_UPDATE_DELAY;
   }
 }
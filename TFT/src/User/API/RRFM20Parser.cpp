@@ -71,6 +71,15 @@ int compare_items(void *arg, const void *a, const void *b)
   return strcmp(((M20_LIST_ITEM *)a)->file_name, ((M20_LIST_ITEM *)b)->file_name);
 }
 
+#ifdef NATIVE_HOST  // glibc qsort_r() takes the comparison function first and passes its argument last
+static int compare_items_gnu(const void *a, const void *b, void *arg)
+{
+  return compare_items(arg, a, b);
+}
+
+#define qsort_r(base, nmemb, size, arg, compar) qsort_r(base, nmemb, size, compar##_gnu, arg)
+#endif
+
 void RRFM20Parser::startObject()
 {
   in_object = in_files;
@@ -115,8 +124,7 @@ void RRFM20Parser::endDocument()
     if (fileList[i].is_directory)
     {
       infoFile.folder[infoFile.folderCount++] = fileList[i].file_name;
-      free(fileList[i].display_name);
-      fileList[i].display_name = NULL;
+      fileList[i].display_name = NULL;  // freed with the file list
     }
     else
     {
@@ -156,7 +164,7 @@ void RRFM20Parser::value(const char *value)
     if (fileCount >= FILE_NUM)
       return;
 
-    uint16_t len = strlen(value + 1);
+    uint16_t len = strlen(value) + 1;
 
     switch (state)
     {
@@ -166,11 +174,11 @@ void RRFM20Parser::value(const char *value)
 
       case name:
       {
-        if ((fileList[fileCount].file_name = (TCHAR *)malloc(len)) != NULL)
+        if ((fileList[fileCount].file_name = allocInfoFileName(len)) != NULL)
           strcpy(fileList[fileCount].file_name, value);
         const char *skipped = macro_sort ? skip_number(value) : value;
         len = strlen(skipped) + 1;
-        if (macro_sort && value != skipped && (fileList[fileCount].display_name = (TCHAR *)malloc(len)) != NULL)
+        if (macro_sort && value != skipped && (fileList[fileCount].display_name = allocInfoFileName(len)) != NULL)
         {
           strcpy(fileList[fileCount].display_name, skipped);
         }
@@ -214,12 +222,12 @@ void RRFM20Parser::value(const char *value)
     }
     uint16_t len = strlen(value) + 1;
 
-    if ((fileList[current].file_name = (TCHAR *)malloc(len)) != NULL)
+    if ((fileList[current].file_name = allocInfoFileName(len)) != NULL)
       strcpy(fileList[current].file_name, value);
 
     value = macro_sort ? skip_number(value) : value;
     len = strlen(value) + 1;
-    if ((fileList[current].display_name = (TCHAR *)malloc(len)) != NULL)
+    if ((fileList[current].display_name = allocInfoFileName(len)) != NULL)
       strcpy(fileList[current].display_name, value);
   }
 }
@@ -88,13 +88,13 @@ void ParseACKJsonParser::endDocument()
 
   if (m291_msg != NULL)
   {
-    free(m291_msg);
+    memFree(m291_msg);
     m291_msg = NULL;
   }
 
   if (m291_title != NULL)
   {
-    free(m291_title);
+    memFree(m291_title);
     m291_title = NULL;
   }
   need_parser_reset = true;
@@ -103,8 +103,8 @@ void ParseACKJsonParser::endDocument()
 void ParseACKJsonParser::value(const char *value)
 {
   uint32_t seq;
-  char *string_end;
-  char *string_start;
+  const char *string_end;
+  const char *string_start;
   switch (state)
   {
     case status:
@@ -187,11 +187,11 @@ void ParseACKJsonParser::value(const char *value)
       m291_mode = strtod((char *)value, NULL);
       break;
     case mbox_msg:
-      m291_msg = (char*)malloc(strlen(value) + 1);
+      m291_msg = (char*)memAlloc(MEM_UI, strlen(value) + 1);
       strcpy(m291_msg, value);
       break;
     case mbox_title:
-      m291_title = (char*)malloc(strlen(value) + 1);
+      m291_title = (char*)memAlloc(MEM_UI, strlen(value) + 1);
       strcpy(m291_title, value);
       break;
     case mbox_timeo:
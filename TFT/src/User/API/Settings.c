@@ -208,7 +208,7 @@ void initMachineSettings(void)
 
   // reset the state to restart the temperature polling process
   // needed by parseAck() function to establish the connection
-  heatSetUpdateWaiting(false);
+  telemetryReset();
 }
 
 void setupMachine(FW_TYPE fwType)
@@ -324,6 +324,9 @@ void checkflashSign(void)
     ypos += BYTE_HEIGHT;
     GUI_DispStringInRectEOL(10, ypos + 10, LCD_WIDTH, LCD_HEIGHT, (uint8_t *)"Insert the SD card with the required\n"
                                                                              "files and press the reset button\nto update.");
+    #ifdef NATIVE_HOST
+      NATIVE_Exit(1, "SPI flash is missing fonts/icons/config, provide them with " NATIVE_SDCARD_FILE);
+    #endif
     while (1);
   }
 }
@@ -9,7 +9,6 @@ static uint16_t setPercent[SPEED_NUM] = {100, 100};
 static uint16_t curPercent[SPEED_NUM] = {100, 100};
 static uint8_t  needSetPercent = 0;
 
-static bool speedQueryWait = false;
 static uint32_t nextSpeedTime = 0;
 
 void speedSetPercent(uint8_t tool, uint16_t per)
@@ -55,21 +54,3 @@ void loopSpeed(void)
     }
   }
 }
-
-void speedQuerySetWait(bool wait)
-{
-  speedQueryWait = wait;
-}
-
-void speedQuery(void)
-{
-  if (infoHost.connected && !infoHost.wait && !speedQueryWait && infoMachineSettings.firmwareType != FW_REPRAPFW)
-  {
-    speedQueryWait = storeCmd("M220\n");
-
-    if (infoSettings.ext_count > 0)
-    {
-      speedQueryWait |= storeCmd("M221\n");  // speedQueryWait set to "true" if at least one command will be sent
-    }
-  }
-}
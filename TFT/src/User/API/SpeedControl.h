@@ -17,8 +17,6 @@ uint16_t speedGetSetPercent(uint8_t tool);
 void speedSetCurPercent(uint8_t tool, uint16_t per);
 uint16_t speedGetCurPercent(uint8_t tool);
 void loopSpeed(void);
-void speedQuerySetWait(bool wait);
-void speedQuery(void);
 
 #ifdef __cplusplus
 }
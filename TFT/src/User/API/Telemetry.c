@@ -0,0 +1,221 @@
+#include "Telemetry.h"
+#include "includes.h"
+
+// The printer states kept up to date on the TFT (temperatures, position etc...) are all handled here. The screens
+// set the update interval they need, then each state is updated the cheapest way the printer offers: an auto report
+// set once (capabilities found in M115), else a query every interval. A query is never queued while the previous
+// one is not answered, and while printing from TFT media the queries take turns in a single queue slot
+
+typedef struct
+{
+  uint32_t nextTime;    // next query or, with an auto report, time by which the next report is due
+  uint8_t seconds;      // update interval wanted, 0 for no updates
+  uint8_t autoSeconds;  // auto report interval set on the printer
+  bool pending;         // query queued and not answered yet, until nextTime
+  bool once;            // query requested by telemetryQuery()
+} TELEMETRY_STATE;
+
+static const char *const telemetryAutoCmd[TELEMETRY_COUNT] = {"M155 S%u\n", "M154 S%u\n", "M27 S%u\n", NULL, NULL};
+static const char *const telemetryQueryCmd[TELEMETRY_COUNT] = {"M105\n", "M114\n", "M27\n", "M220\n", "M710\n"};
+
+static TELEMETRY_STATE telemetry[TELEMETRY_COUNT] = {
+  [TELEMETRY_TEMP] = {.seconds = TEMPERATURE_QUERY_SLOW_SECONDS},
+};
+
+static uint32_t printSlotTime = 0;
+static uint8_t firstSignal = 0;  // first signal checked, the queries sharing the print slot take turns
+
+static bool telemetryHasAutoReport(TELEMETRY signal)
+{
+  switch (signal)
+  {
+    case TELEMETRY_TEMP:
+      return infoMachineSettings.autoReportTemp == ENABLED;
+
+    case TELEMETRY_POS:
+      return infoMachineSettings.autoReportPos == ENABLED;
+
+    case TELEMETRY_PRINT:
+      return infoMachineSettings.autoReportSDStatus == ENABLED;
+
+    default:
+      return false;
+  }
+}
+
+static bool telemetryIsAvailable(TELEMETRY signal)
+{
+  // the temperatures are queried also to detect the printer. RRF reports them to M408 (see rrfStatusQuery())
+  if (signal == TELEMETRY_TEMP)
+    return infoMachineSettings.firmwareType != FW_REPRAPFW;
+
+  if (!infoHost.connected)
+    return false;
+
+  switch (signal)
+  {
+    case TELEMETRY_POS:
+    case TELEMETRY_SPEED:
+      return infoMachineSettings.firmwareType != FW_REPRAPFW;
+
+    case TELEMETRY_PRINT:
+      #ifdef HAS_EMULATOR
+        if (MENU_IS(menuMarlinMode))
+          return false;
+      #endif
+
+      return infoMachineSettings.onboardSD == ENABLED &&
+             (telemetryHasAutoReport(signal) || (infoSettings.m27_active && MENU_IS_NOT(menuTerminal)));
+
+    case TELEMETRY_CTRL_FAN:
+      return infoSettings.ctrl_fan_en;
+
+    default:
+      return false;
+  }
+}
+
+static uint8_t telemetryInterval(TELEMETRY signal)
+{
+  uint8_t seconds = telemetry[signal].seconds;
+
+  #ifdef LCD_LED_PWM_CHANNEL
+    // nobody is looking at the screen, only the heaters waited for keep their rate
+    if (seconds != 0 && LCD_IsDimmed() && !(signal == TELEMETRY_TEMP && heatHasWaiting()))
+      seconds = MAX(seconds, TELEMETRY_DIMMED_SECONDS);
+  #endif
+
+  return seconds;
+}
+
+static inline bool telemetryIsPrintingFromTFT(void)
+{
+  return isPrinting() && !isPaused() && infoFile.source < FS_ONBOARD_MEDIA;
+}
+
+static bool telemetryStoreQuery(TELEMETRY signal)
+{
+  if (!storeCmd(telemetryQueryCmd[signal]))  // not queued twice, e.g. when sent by the user its reply will do
+    return false;
+
+  if (signal == TELEMETRY_SPEED && infoSettings.ext_count > 0)
+    storeCmd("M221\n");  // either reply ends the query
+
+  return true;
+}
+
+void telemetrySetSeconds(TELEMETRY signal, uint8_t seconds)
+{
+  uint32_t nextTime = OS_GetTimeMs() + SEC_TO_MS(seconds);
+
+  telemetry[signal].seconds = seconds;
+
+  if (telemetry[signal].nextTime > nextTime)  // a shorter interval applies at once
+    telemetry[signal].nextTime = nextTime;
+}
+
+uint8_t telemetryGetSeconds(TELEMETRY signal)
+{
+  return telemetry[signal].seconds;
+}
+
+void telemetryQuery(TELEMETRY signal)
+{
+  telemetry[signal].once = true;
+}
+
+void telemetrySync(TELEMETRY signal, uint8_t seconds)
+{
+  telemetry[signal].seconds = telemetry[signal].autoSeconds = seconds;
+}
+
+void telemetryReceived(TELEMETRY signal)
+{
+  telemetry[signal].pending = false;
+  telemetryPostpone(signal);
+}
+
+void telemetryPostpone(TELEMETRY signal)
+{
+  telemetry[signal].nextTime = OS_GetTimeMs() + SEC_TO_MS(telemetryInterval(signal));
+}
+
+void telemetryClearPending(void)
+{
+  for (uint8_t i = 0; i < TELEMETRY_COUNT; i++)
+  {
+    telemetry[i].pending = false;
+  }
+}
+
+void telemetryReset(void)
+{
+  for (uint8_t i = 0; i < TELEMETRY_COUNT; i++)
+  {
+    telemetry[i].pending = telemetry[i].once = false;
+    telemetry[i].autoSeconds = 0;
+  }
+}
+
+void loopTelemetry(void)
+{
+  uint32_t now = OS_GetTimeMs();
+  bool printing = telemetryIsPrintingFromTFT();
+  bool slotFree = !printing || now >= printSlotTime;
+
+  if (requestCommandInfoIsRunning())  // to avoid a collision with the response of a request
+    return;
+
+  for (uint8_t i = 0; i < TELEMETRY_COUNT; i++)
+  {
+    TELEMETRY signal = (firstSignal + i) % TELEMETRY_COUNT;
+    TELEMETRY_STATE *state = &telemetry[signal];
+    uint8_t seconds = telemetryInterval(signal);
+
+    if (!telemetryIsAvailable(signal))
+      continue;
+
+    if (state->pending && now < state->nextTime)
+      continue;
+
+    state->pending = false;  // the reply is late, query again
+
+    if (telemetryHasAutoReport(signal))
+    {
+      // set the auto report when its interval changes, and again when the temperatures stop coming (printer reset)
+      if (state->autoSeconds != seconds ||
+          (signal == TELEMETRY_TEMP && seconds != 0 && now > state->nextTime + TELEMETRY_GRACE_MS))
+      {
+        if (storeCmd(telemetryAutoCmd[signal], seconds))
+        {
+          state->autoSeconds = seconds;
+          state->nextTime = now + SEC_TO_MS(seconds);
+        }
+      }
+
+      if (!state->once)
+        continue;
+    }
+    else if (!state->once && (seconds == 0 || now < state->nextTime))
+    {
+      continue;
+    }
+
+    if (!slotFree)
+      continue;
+
+    if (telemetryStoreQuery(signal))
+    {
+      state->pending = true;
+      state->once = false;
+      state->nextTime = now + (seconds != 0 ? SEC_TO_MS(seconds) : TELEMETRY_GRACE_MS);
+
+      if (printing)  // one query per slot, the next signal goes first at the next slot
+      {
+        printSlotTime = now + TELEMETRY_PRINT_SLOT_MS;
+        slotFree = false;
+        firstSignal = (signal + 1) % TELEMETRY_COUNT;
+      }
+    }
+  }
+}
@@ -0,0 +1,40 @@
+#ifndef _TELEMETRY_H_
+#define _TELEMETRY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TELEMETRY_GRACE_MS       3000  // a reply or an auto report later than its interval + this is considered lost
+#define TELEMETRY_DIMMED_SECONDS 10    // longest interval used while the LCD is dimmed
+#define TELEMETRY_PRINT_SLOT_MS  2000  // while printing from TFT media, the queries share one queue slot every this ms
+
+// printer states kept up to date by queries or, when the printer supports it, by auto reports
+typedef enum
+{
+  TELEMETRY_TEMP = 0,  // temperatures: M155 auto report or M105
+  TELEMETRY_POS,       // position: M154 auto report or M114
+  TELEMETRY_PRINT,     // print from onboard media: M27 S auto report or M27
+  TELEMETRY_SPEED,     // speed and flow rate: M220 and M221
+  TELEMETRY_CTRL_FAN,  // controller fan: M710
+  TELEMETRY_COUNT
+} TELEMETRY;
+
+void telemetrySetSeconds(TELEMETRY signal, uint8_t seconds);  // update interval wanted by the screen, 0 to stop the updates
+uint8_t telemetryGetSeconds(TELEMETRY signal);
+void telemetryQuery(TELEMETRY signal);                         // query once, as soon as possible
+void telemetrySync(TELEMETRY signal, uint8_t seconds);         // auto report interval set by a gcode from the user or a host
+void telemetryReceived(TELEMETRY signal);                      // called by parseACK() on each reply or auto report
+void telemetryPostpone(TELEMETRY signal);                      // no query before one interval
+void telemetryClearPending(void);                              // the queries queued were dropped, they won't be answered
+void telemetryReset(void);                                     // new connection, also forget the auto reports set
+void loopTelemetry(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -8,15 +8,9 @@ const char *const heatCmd[MAX_HEATER_COUNT]       = HEAT_CMD;
 const char *const heatWaitCmd[MAX_HEATER_COUNT]   = HEAT_WAIT_CMD;
 
 static HEATER  heater = {{}, NOZZLE0};
-static uint8_t heat_update_seconds = TEMPERATURE_QUERY_SLOW_SECONDS;
-static bool    heat_update_waiting = false;
 static uint8_t heat_send_waiting = 0;
 static uint8_t heat_feedback_waiting = 0;
 
-uint32_t nextHeatCheckTime = 0;
-
-#define AUTOREPORT_TIMEOUT (nextHeatCheckTime + 3000)  // update interval + 3 second grace period
-
 // Verify that the heater index is valid, and fix the index of multiple in and 1 out tool nozzles
 static uint8_t heaterIndexFix(uint8_t index)
 {
@@ -92,9 +86,6 @@ void heatSetCurrentTemp(uint8_t index, int16_t temp)
     return;
 
   heater.T[index].current = NOBEYOND(-99, temp, 999);
-
-  if (infoMachineSettings.autoReportTemp)
-    updateNextHeatCheckTime();  // set next timeout for temperature auto-report
 }
 
 // Get current temperature
@@ -200,76 +191,18 @@ bool heaterDisplayIsValid(uint8_t index)
 // Set temperature update time interval
 void heatSetUpdateSeconds(uint8_t seconds)
 {
-  if (heat_update_seconds == seconds)
-    return;
-
-  heat_update_seconds = seconds;
-
-  if (infoMachineSettings.autoReportTemp && !heat_update_waiting)
-    heat_update_waiting = storeCmd("M155 S%u\n", heatGetUpdateSeconds());
+  telemetrySetSeconds(TELEMETRY_TEMP, seconds);
 }
 
 // Get query temperature seconds
 uint8_t heatGetUpdateSeconds(void)
 {
-  return heat_update_seconds;
-}
-
-// Set query temperature seconds
-void heatSyncUpdateSeconds(uint8_t seconds)
-{
-  heat_update_seconds = seconds;
-}
-
-// Set whether we need to query the current temperature
-void heatSetUpdateWaiting(bool isWaiting)
-{
-  heat_update_waiting = isWaiting;
-}
-
-void updateNextHeatCheckTime(void)
-{
-  nextHeatCheckTime = OS_GetTimeMs() + SEC_TO_MS(heat_update_seconds);
+  return telemetryGetSeconds(TELEMETRY_TEMP);
 }
 
+// heaters status and target temperatures to send, the temperatures are updated by loopTelemetry()
 void loopCheckHeater(void)
 {
-  // Send M105 to query the temperatures, if motherboard does not supports M155 (AUTO_REPORT_TEMPERATURES) feature
-  // to automatically report the temperatures.
-  if (!infoMachineSettings.autoReportTemp)
-  {
-    do
-    {
-      // Send M105 query temperature continuously
-      if (heat_update_waiting == true)
-      {
-        updateNextHeatCheckTime();
-        break;
-      }
-
-      if (OS_GetTimeMs() < nextHeatCheckTime)
-        break;
-
-      if (requestCommandInfoIsRunning())  // To avoid colision in gcode response processing
-        break;
-
-      if ((infoMachineSettings.firmwareType != FW_REPRAPFW) && !storeCmd("M105\n"))
-        break;
-
-      updateNextHeatCheckTime();
-      heat_update_waiting = true;
-    } while (0);
-  }
-  else  // check temperature auto-report timout and resend M155 command
-  {
-    if (OS_GetTimeMs() > AUTOREPORT_TIMEOUT && !heat_update_waiting)
-    {
-      heat_update_waiting = storeCmd("M155 S%u\n", heatGetUpdateSeconds());
-      if (heat_update_waiting)
-        updateNextHeatCheckTime();  // set next timeout for temperature auto-report
-    }
-  }
-
   for (uint8_t i = 0; i < MAX_HEATER_COUNT; i++)
   {
     if (heater.T[i].waiting && inRange(heater.T[i].current, heater.T[i].target, TEMPERATURE_RANGE))
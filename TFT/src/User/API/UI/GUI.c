@@ -48,14 +48,16 @@ GUI_NUM_MODE GUI_GetNumMode(void)
   return guiNumMode;
 }
 
+// fill the area from (sx, sy) to (ex - 1, ey - 1), by DMA if the LCD supports it
+static inline void GUI_FillArea(uint16_t sx, uint16_t sy, uint16_t ex, uint16_t ey, uint16_t color)
+{
+  if (ex > sx && ey > sy)
+    lcd_frame_fill(sx, sy, ex - sx, ey - sy, color);
+}
+
 void GUI_Clear(uint16_t color)
 {
-  uint32_t index=0;
-  LCD_SetWindow(0, 0, LCD_WIDTH-1, LCD_HEIGHT-1);
-  for (index=0; index<LCD_WIDTH*LCD_HEIGHT; index++)
-  {
-    LCD_WR_16BITS_DATA(color);
-  }
+  GUI_FillArea(0, 0, LCD_WIDTH, LCD_HEIGHT, color);
 }
 
 static uint8_t pixel_limit_flag = 0;
@@ -107,15 +109,7 @@ void GUI_DrawPoint(uint16_t x, uint16_t y)
 */
 void GUI_FillRect(uint16_t sx, uint16_t sy, uint16_t ex, uint16_t ey)
 {
-  uint16_t i=0, j=0;
-  LCD_SetWindow(sx, sy, ex-1, ey-1);
-  for (i=sx; i<ex; i++)
-  {
-    for (j=sy; j<ey; j++)
-    {
-      LCD_WR_16BITS_DATA(foreGroundColor);
-    }
-  }
+  GUI_FillArea(sx, sy, ex, ey, foreGroundColor);
 }
 
 void GUI_FillPrect(const GUI_RECT *rect)
@@ -131,15 +125,7 @@ void GUI_FillPrect(const GUI_RECT *rect)
 */
 void GUI_ClearRect(uint16_t sx, uint16_t sy, uint16_t ex, uint16_t ey)
 {
-  uint16_t i=0, j=0;
-  LCD_SetWindow( sx, sy, ex-1, ey-1);
-  for (i=sx; i<ex; i++)
-  {
-    for (j=sy; j<ey; j++)
-    {
-      LCD_WR_16BITS_DATA(backGroundColor);
-    }
-  }
+  GUI_FillArea(sx, sy, ex, ey, backGroundColor);
 }
 
 void GUI_ClearPrect(const GUI_RECT *rect)
@@ -156,15 +142,7 @@ void GUI_ClearPrect(const GUI_RECT *rect)
 */
 void GUI_FillRectColor(uint16_t sx, uint16_t sy, uint16_t ex, uint16_t ey, uint16_t color)
 {
-  uint16_t i=0, j=0;
-  LCD_SetWindow(sx, sy, ex-1, ey-1);
-  for (i=sx; i<ex; i++)
-  {
-    for (j=sy; j<ey; j++)
-    {
-      LCD_WR_16BITS_DATA(color);
-    }
-  }
+  GUI_FillArea(sx, sy, ex, ey, color);
 }
 
 void GUI_FillRectArry(uint16_t sx, uint16_t sy, uint16_t ex, uint16_t ey, uint8_t * arry)
@@ -692,47 +670,253 @@ void GUI_DispOne(int16_t sx, int16_t sy, const CHAR_INFO *pInfo)
   }
 }
 
-void _GUI_DispString(int16_t x, int16_t y, const uint8_t *p)
-{
-  if (p == NULL) return;
+// Scanline text renderer.
+// A run of characters is composed in RAM into a band buffer one text row high and it is then pushed
+// to the LCD with a single window, instead of setting one window (or one window per pixel) per character
+#define TEXT_BAND_SIZE NOBEYOND(1024, RAM_SIZE * 24, 4096)  // in pixels, always large enough for the widest character
+
+static uint16_t textBand[TEXT_BAND_SIZE];
+static uint16_t textIconIndex;   // icon used as background in GUI_TEXTMODE_ON_ICON mode
+static GUI_POINT textIconPoint;  // screen position of the icon used as background
 
+// start reading in background the bitmap of the first drawable character of p
+static void GUI_PrefetchChar(const uint8_t *p)
+{
   CHAR_INFO info;
 
   while (*p)
   {
     getCharacterInfo(p, &info);
-    GUI_DispOne(x, y, &info);
-    x += info.pixelWidth;
+
+    if (info.pixelWidth != 0)
+    {
+      W25Qxx_Prefetch(info.bitMapAddr, info.pixelHeight * info.pixelWidth / 8);
+      return;
+    }
+
     p += info.bytes;
   }
 }
 
-const uint8_t* _GUI_DispLenString(int16_t x, int16_t y, const uint8_t *p, uint16_t pixelWidth, bool truncate)
+// compose the bitmap of a character into the band at the provided column (only text pixels are written).
+// The bitmap of the character following it in next is read while this one is composed
+static void GUI_BandChar(uint16_t bandWidth, uint16_t col, const CHAR_INFO *pInfo, uint16_t color, const uint8_t *next)
 {
-  if (p == NULL) return NULL;
+  uint8_t w = pInfo->pixelWidth;
+  uint8_t h = pInfo->pixelHeight;
+  uint16_t bitMapSize = (h * w / 8);
+  uint8_t font[bitMapSize];
+  uint8_t jj = (h + 8 - 1) / 8;
+  uint32_t pixel = 1 << (h - 1);
+  uint32_t temp = 0;
+  uint16_t i = 0;
+  uint16_t *buf;
 
-  CHAR_INFO info;
-  uint16_t curPixelWidth = 0;
+  W25Qxx_ReadBuffer(font, pInfo->bitMapAddr, bitMapSize);
+  GUI_PrefetchChar(next);
 
-  if (truncate) pixelWidth -= BYTE_HEIGHT;
+  for (uint8_t x = 0; x < w; x++)
+  {
+    for (uint8_t j = 0; j < jj; j++)
+    {
+      temp <<= 8;
+      temp |= font[i++];
+    }
+
+    buf = &textBand[col + x];
+
+    for (uint8_t y = 0; y < h; y++)
+    {
+      if (temp & pixel)  // draw text pixel
+        *buf = color;
+
+      buf += bandWidth;
+      temp <<= 1;
+    }
+  }
+}
+
+// push the band to the LCD with a single window, clipped to the range set by GUI_SetRange()
+static void GUI_BandDisplay(int16_t sx, int16_t sy, uint16_t w, uint16_t h)
+{
+  GUI_RECT limit = {0};
+
+  if (pixel_limit_flag == 1)
+  {
+    if (sx < pixel_limit_rect.x0)
+      limit.x0 = pixel_limit_rect.x0 - sx;
+
+    if (sx + w >= pixel_limit_rect.x1)
+      limit.x1 = sx + w - pixel_limit_rect.x1;
+
+    if (sy < pixel_limit_rect.y0)
+      limit.y0 = pixel_limit_rect.y0 - sy;
+
+    if (sy + h >= pixel_limit_rect.y1)
+      limit.y1 = sy + h - pixel_limit_rect.y1;
+
+    if (limit.x0 + limit.x1 >= w || limit.y0 + limit.y1 >= h)  // band completely out of range
+      return;
+  }
+
+  lcd_buffer_display(sx, sy, w, h, textBand, &limit);
+}
+
+// push only the text pixels of the band (GUI_TEXTMODE_TRANS), one window per horizontal span of text pixels
+static void GUI_BandSpans(int16_t sx, int16_t sy, uint16_t w, uint16_t h)
+{
+  int16_t x0 = sx, x1 = sx + w;
+  int16_t y0 = sy, y1 = sy + h;
+
+  if (pixel_limit_flag == 1)
+  {
+    x0 = MAX(x0, pixel_limit_rect.x0);
+    x1 = MIN(x1, pixel_limit_rect.x1);
+    y0 = MAX(y0, pixel_limit_rect.y0);
+    y1 = MIN(y1, pixel_limit_rect.y1);
+  }
+
+  for (int16_t y = y0; y < y1; y++)
+  {
+    const uint16_t *row = &textBand[(y - sy) * w];
+    int16_t x = x0;
+
+    while (x < x1)
+    {
+      if (row[x - sx] != foreGroundColor)
+      {
+        x++;
+        continue;
+      }
+
+      int16_t start = x;
 
-  while (curPixelWidth < pixelWidth && *p)
+      while (x < x1 && row[x - sx] == foreGroundColor)
+      {
+        x++;
+      }
+
+      LCD_SetWindow(start, y, x - 1, y);
+
+      for (int16_t i = start; i < x; i++)
+      {
+        LCD_WR_16BITS_DATA(foreGroundColor);
+      }
+    }
+  }
+}
+
+// draw the characters fitting in maxWidth pixels as bands, applying the current text mode.
+// Return the pointer to the first character not drawn and provide the drawn pixel width
+static const uint8_t * GUI_DispRun(int16_t x, int16_t y, const uint8_t *p, uint16_t maxWidth, uint16_t *drawnWidth)
+{
+  CHAR_INFO info;
+  uint16_t totalWidth = 0;
+
+  while (*p)
   {
     getCharacterInfo(p, &info);
-    if (curPixelWidth + info.pixelWidth > pixelWidth)
+
+    if (info.pixelWidth == 0)  // nothing to draw for control characters
+    {
+      p += info.bytes;
+      continue;
+    }
+
+    if (totalWidth + info.pixelWidth > maxWidth)
+      break;
+
+    // measure the band: characters with the same height fitting both the band buffer and maxWidth
+    uint8_t h = info.pixelHeight;
+    uint16_t bandMaxWidth = TEXT_BAND_SIZE / h;
+    uint16_t bandWidth = 0;
+    const uint8_t *end = p;
+
+    while (*end)
     {
-      if (truncate)
+      getCharacterInfo(end, &info);
+
+      if (info.pixelWidth != 0)
       {
-        getCharacterInfo((uint8_t *)"…", &info);
-        GUI_DispOne(x, y, &info);
+        if (info.pixelHeight != h || bandWidth + info.pixelWidth > bandMaxWidth ||
+            totalWidth + bandWidth + info.pixelWidth > maxWidth)
+          break;
+
+        bandWidth += info.pixelWidth;
       }
-      return p;
+
+      end += info.bytes;
     }
-    GUI_DispOne(x, y, &info);
-    x += info.pixelWidth;
-    curPixelWidth += info.pixelWidth;
-    p += info.bytes;
+
+    // fill the band background
+    if (guiTextMode == GUI_TEXTMODE_NORMAL)
+    {
+      for (uint16_t i = 0; i < bandWidth * h; i++)
+      {
+        textBand[i] = backGroundColor;
+      }
+    }
+    else if (guiTextMode == GUI_TEXTMODE_ON_ICON)
+    {
+      ICON_ReadBuffer(textBand, x - textIconPoint.x, y - textIconPoint.y, bandWidth, h, textIconIndex);
+    }
+    else  // if GUI_TEXTMODE_TRANS, any color other than the text color marks a transparent pixel
+    {
+      for (uint16_t i = 0; i < bandWidth * h; i++)
+      {
+        textBand[i] = ~foreGroundColor;
+      }
+    }
+
+    // compose the characters
+    for (uint16_t col = 0; p < end; p += info.bytes)
+    {
+      getCharacterInfo(p, &info);
+
+      if (info.pixelWidth == 0)
+        continue;
+
+      // the last character of the band prefetches the first one of the next band, read during GUI_BandDisplay()
+      GUI_BandChar(bandWidth, col, &info, foreGroundColor, p + info.bytes);
+      col += info.pixelWidth;
+    }
+
+    if (guiTextMode == GUI_TEXTMODE_TRANS)
+      GUI_BandSpans(x, y, bandWidth, h);
+    else
+      GUI_BandDisplay(x, y, bandWidth, h);
+
+    x += bandWidth;
+    totalWidth += bandWidth;
   }
+
+  if (drawnWidth != NULL)
+    *drawnWidth = totalWidth;
+
+  return p;
+}
+
+void _GUI_DispString(int16_t x, int16_t y, const uint8_t *p)
+{
+  if (p == NULL) return;
+
+  GUI_DispRun(x, y, p, UINT16_MAX, NULL);
+}
+
+const uint8_t* _GUI_DispLenString(int16_t x, int16_t y, const uint8_t *p, uint16_t pixelWidth, bool truncate)
+{
+  if (p == NULL) return NULL;
+
+  uint16_t curPixelWidth = 0;
+
+  if (truncate) pixelWidth -= BYTE_HEIGHT;
+
+  p = GUI_DispRun(x, y, p, pixelWidth, &curPixelWidth);
+
+  // if the next character doesn't fit, draw the ellipsis in place of the remaining text
+  if (truncate && *p && curPixelWidth < pixelWidth)
+    GUI_DispRun(x + curPixelWidth, y, (uint8_t *)"…", UINT16_MAX, NULL);
+
   return p;
 }
 
@@ -863,21 +1047,11 @@ void _GUI_DispStringOnIcon(uint16_t iconIndex, GUI_POINT iconPoint, GUI_POINT te
 {
   if (p == NULL) return;
 
-  CHAR_INFO info;
-  uint16_t _iconBuffer[LARGE_BYTE_WIDTH * LARGE_BYTE_HEIGHT];
-
-  iconBuffer = _iconBuffer;
+  textIconIndex = iconIndex;
+  textIconPoint = iconPoint;
   GUI_SetTextMode(GUI_TEXTMODE_ON_ICON);
 
-  while (*p)
-  {
-    getCharacterInfo(p, &info);
-    ICON_ReadBuffer(iconBuffer, textPos.x, textPos.y, info.pixelWidth, info.pixelHeight, iconIndex);
-    GUI_DispOne(iconPoint.x + textPos.x, iconPoint.y + textPos.y, &info);
-
-    textPos.x += info.pixelWidth;
-    p += info.bytes;
-  }
+  GUI_DispRun(iconPoint.x + textPos.x, iconPoint.y + textPos.y, p, UINT16_MAX, NULL);
 
   GUI_SetTextMode(GUI_TEXTMODE_NORMAL);
 }
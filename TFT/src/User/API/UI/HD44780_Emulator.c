@@ -7,6 +7,13 @@
 #ifdef LCD2004_EMULATOR
 uint8_t HD44780_CGRAM[8][8];  // [64*2] = [4 * 16*2*8], means 4 * [16*16] bitmap font,
 
+// characters displayed on the LCD and the cells changed since the last flush (1 bit per column)
+static uint8_t HD44780_DDRAM[YROWS][XROWS];
+static uint32_t HD44780_dirtyCells[YROWS];
+
+// ASCII glyphs (' ' ~ '~') loaded from SPI flash once when Marlin mode starts, NULL if there was not enough memory
+static uint8_t *HD44780_glyphs = NULL;
+
 HD44780_PIXEL HD44780 = {
   .x = 0,             // current x pixel, range is 0 - 127
   .y = 0,             // current y pixel, range is 0 - 63
@@ -31,11 +38,18 @@ HD44780_REG HD44780_reg = {
 // cmd : 1 << 0
 void HD44780_BI10_DisplayClear(uint8_t cmd)
 {
-  GUI_FillRectColor(XSTART,
-                    YSTART,
-                    LCD_WIDTH,
-                    LCD_HEIGHT,
-                    infoSettings.marlin_bg_color);
+  // Fill DDRAM with "20H"(space code), only the cells which weren't blank are drawn again
+  for (uint8_t y = 0; y < YROWS; y++)
+  {
+    for (uint8_t x = 0; x < XROWS; x++)
+    {
+      if (HD44780_DDRAM[y][x] != ' ')
+      {
+        HD44780_DDRAM[y][x] = ' ';
+        HD44780_dirtyCells[y] |= 1 << x;
+      }
+    }
+  }
   HD44780.x = HD44780.y = 0;
   HD44780_reg.bi.ems.id = 1;
 }
@@ -111,84 +125,114 @@ void HD44780_BI17_SetDDRAMAddress(uint8_t cmd)
   HD44780_reg.data_type = HD44780_DATA_DDRAM;
 }
 
-void HD44780_DrawPixel(int16_t x, int16_t y, bool isForeGround, bool isFont)
+// write a line of a cell, "count" pixels from the MSB of "bits" each "scale" LCD pixels wide, the rest of the cell is background
+static inline void HD44780_DrawCellLine(uint16_t bits, uint8_t count, uint8_t scale, uint16_t msb)
 {
-  if (isFont)
+  uint16_t width = CELL_WIDTH;
+
+  for (; count > 0 && width > 0; count--)
   {
-    GUI_FillRectColor(XSTART + FONT_PIXEL * x,
-                      YSTART + FONT_PIXEL * y,
-                      XSTART + FONT_PIXEL * (x + 1),
-                      YSTART + FONT_PIXEL * (y + 1),
-                      isForeGround ? infoSettings.marlin_font_color : infoSettings.marlin_bg_color);
+    uint16_t color = (bits & msb) ? infoSettings.marlin_font_color : infoSettings.marlin_bg_color;
+
+    for (uint8_t i = 0; i < scale && width > 0; i++, width--)
+    {
+      LCD_WR_16BITS_DATA(color);
+    }
+    bits <<= 1;
   }
-  else
+
+  for (; width > 0; width--)
   {
-    GUI_FillRectColor(XSTART + BITMAP_PIXEL * x,
-                      YSTART + YOFFSET + BITMAP_PIXEL * y,
-                      XSTART + BITMAP_PIXEL * (x + 1),
-                      YSTART + YOFFSET + BITMAP_PIXEL * (y + 1),
-                      isForeGround ? infoSettings.marlin_font_color : infoSettings.marlin_bg_color);
+    LCD_WR_16BITS_DATA(infoSettings.marlin_bg_color);
   }
 }
 
-// Display CGRAM fonts
-void HD44780_DispDDRAM(uint8_t data)
+// draw a character cell in a single LCD window, from the CGRAM for 0 ~ 7 or from the ASCII glyphs
+static void HD44780_DrawCell(uint8_t x, uint8_t y)
 {
-  uint16_t i  = 0,
-           ex = 0,
-           ey = 0;
+  uint8_t data = HD44780_DDRAM[y][x];
+
+  LCD_SetWindow(XSTART + x * CELL_WIDTH, YSTART + y * CELL_HEIGHT,
+                XSTART + (x + 1) * CELL_WIDTH - 1, YSTART + (y + 1) * CELL_HEIGHT - 1);
+
   if (data < 8)
-  { // 5*8 bitmap
-    ex = HD44780.x * 6 + 6;
-    ey = HD44780.y * 12 + 8;
-    for (uint16_t y = HD44780.y * 12; y < ey; y++)
+  { // 5*8 bitmap, YOFFSET from the top of the cell
+    for (int16_t ly = 0; ly < CELL_HEIGHT; ly++)
     {
-      uint8_t temp = HD44780_CGRAM[data][i++];
-      for (uint16_t x = HD44780.x * 6; x < ex; x++)
-      {
-        HD44780_DrawPixel(x, y, temp & 0x10, 0);
-        temp <<= 1;
-      }
+      int16_t row = (ly - YOFFSET) / BITMAP_PIXEL;
+      uint8_t bits = (ly >= YOFFSET && row < 8) ? HD44780_CGRAM[data][row] : 0;
+
+      HD44780_DrawCellLine(bits, 5, BITMAP_PIXEL, 0x10);
     }
   }
   else
-  { //font
-    if (data < ' ' || data > '~') return;
-    ex = HD44780.x * BYTE_WIDTH + BYTE_WIDTH - 1;
-    ey = HD44780.y * BYTE_HEIGHT + BYTE_HEIGHT - 1;
-    CHAR_INFO info = {.bytes = 0};
+  { // font, unknown characters are displayed blank
+    uint8_t font[GLYPH_SIZE];
+    const uint8_t *glyph = font;
 
-    getCharacterInfo(&data, &info);
-    uint16_t x = 0,
-             y = 0,
-             j = 0;
-    uint16_t bitMapSize = (info.pixelHeight * info.pixelWidth / 8);
-    uint8_t  font[bitMapSize];
-    uint32_t temp = 0;
+    if (data < ' ' || data > '~')
+    {
+      memset(font, 0, GLYPH_SIZE);
+    }
+    else if (HD44780_glyphs != NULL)
+    {
+      glyph = HD44780_glyphs + (data - ' ') * GLYPH_SIZE;
+    }
+    else
+    {
+      CHAR_INFO info = {.bytes = 0};
 
-    W25Qxx_ReadBuffer(font, info.bitMapAddr, bitMapSize);
+      getCharacterInfo(&data, &info);
+      W25Qxx_ReadBuffer(font, info.bitMapAddr, GLYPH_SIZE);
+    }
 
-    for (x = HD44780.x * BYTE_WIDTH; x < ex; x++)
+    for (uint8_t row = 0; row < BYTE_HEIGHT; row++)
     {
-      for (j = 0; j < (BYTE_HEIGHT + 8 - 1) / 8; j++)
+      uint16_t bits = 0;
+
+      // glyphs are stored column by column, (BYTE_HEIGHT / 8) bytes each, MSB on top
+      for (uint8_t col = 0; col < BYTE_WIDTH; col++)
       {
-        temp <<= 8;
-        temp |= font[i++];
+        bits = (bits << 1) | ((glyph[col * (BYTE_HEIGHT / 8) + row / 8] >> (7 - row % 8)) & 1);
       }
 
-      for (y = HD44780.y * BYTE_HEIGHT; y < ey ;y++)
+      for (uint8_t i = 0; i < FONT_PIXEL; i++)
       {
-        HD44780_DrawPixel(x, y, temp & (1 << (BYTE_HEIGHT - 1)), 1);
-        temp <<= 1;
+        HD44780_DrawCellLine(bits, BYTE_WIDTH, FONT_PIXEL, 1 << (BYTE_WIDTH - 1));
       }
     }
   }
+}
+
+// store a character in DDRAM, the cell is drawn by HD44780_Flush() if it changed
+void HD44780_DispDDRAM(uint8_t data)
+{
+  if (HD44780.x < XROWS && HD44780.y < YROWS && HD44780_DDRAM[HD44780.y][HD44780.x] != data)
+  {
+    HD44780_DDRAM[HD44780.y][HD44780.x] = data;
+    HD44780_dirtyCells[HD44780.y] |= 1 << HD44780.x;
+  }
   HD44780.x ++;
 }
 
 void HD44780_SetCGRAMData(uint8_t data)
 {
-  HD44780_CGRAM[HD44780.y][HD44780.x++] = data;
+  if (HD44780_CGRAM[HD44780.y][HD44780.x] != data)
+  {
+    HD44780_CGRAM[HD44780.y][HD44780.x] = data;
+
+    // invalidate only the cells displaying this custom character
+    for (uint8_t y = 0; y < YROWS; y++)
+    {
+      for (uint8_t x = 0; x < XROWS; x++)
+      {
+        if (HD44780_DDRAM[y][x] == HD44780.y)
+          HD44780_dirtyCells[y] |= 1 << x;
+      }
+    }
+  }
+
+  HD44780.x++;
   if (HD44780.x > 7)
   {
     HD44780.x = 0;
@@ -234,6 +278,45 @@ void HD44780_ParseWData(uint8_t data)
   }
 }
 
+// Reset the DDRAM to the cleared LCD and load the ASCII glyphs
+void HD44780_Init(void)
+{
+  memset(HD44780_DDRAM, ' ', sizeof(HD44780_DDRAM));
+  memset(HD44780_dirtyCells, 0, sizeof(HD44780_dirtyCells));
+
+  HD44780_glyphs = memAlloc(MEM_UI, ('~' - ' ' + 1) * GLYPH_SIZE);
+  if (HD44780_glyphs != NULL)
+  {
+    uint8_t ch = ' ';
+    CHAR_INFO info = {.bytes = 0};
+
+    getCharacterInfo(&ch, &info);
+    W25Qxx_ReadBuffer(HD44780_glyphs, info.bitMapAddr, ('~' - ' ' + 1) * GLYPH_SIZE);  // ASCII glyphs are contiguous
+  }
+}
+
+void HD44780_DeInit(void)
+{
+  memFree(HD44780_glyphs);
+  HD44780_glyphs = NULL;
+}
+
+// draw the cells changed since the last call, called once the received data have been parsed
+void HD44780_Flush(void)
+{
+  for (uint8_t y = 0; y < YROWS; y++)
+  {
+    for (uint8_t x = 0; HD44780_dirtyCells[y] != 0; x++)
+    {
+      if (HD44780_dirtyCells[y] & (1 << x))
+      {
+        HD44780_DrawCell(x, y);
+        HD44780_dirtyCells[y] &= ~(1 << x);
+      }
+    }
+  }
+}
+
 // Parse queue data
 void HD44780_ParseRecv(uint8_t val)
 {
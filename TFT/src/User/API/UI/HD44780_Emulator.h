@@ -15,6 +15,9 @@ extern "C" {
 #define XSTART       ((LCD_WIDTH - FONT_PIXEL * XROWS * BYTE_WIDTH) / 2)
 #define YSTART       ((LCD_HEIGHT - FONT_PIXEL * YROWS * BYTE_HEIGHT) / 2)
 #define YOFFSET      (BYTE_HEIGHT * FONT_PIXEL - 9 * BITMAP_PIXEL)
+#define CELL_WIDTH   (FONT_PIXEL * BYTE_WIDTH)   // LCD pixels of a character cell
+#define CELL_HEIGHT  (FONT_PIXEL * BYTE_HEIGHT)
+#define GLYPH_SIZE   (BYTE_WIDTH * BYTE_HEIGHT / 8)  // bytes of an ASCII glyph, column by column as stored in SPI flash
 
 typedef void (*HD44780_CMD)(uint8_t);
 
@@ -207,7 +210,10 @@ typedef struct
   HD44780_DATA_TYPE data_type;
 } HD44780_REG;  // Extended Instruction
 
+void HD44780_Init(void);
+void HD44780_DeInit(void);
 void HD44780_ParseRecv(uint8_t val);
+void HD44780_Flush(void);
 
 #ifdef __cplusplus
 }
@@ -39,6 +39,72 @@ const uint16_t st7920_gy_start = ST7920_GYSTART;
 const uint16_t st7920_gx_dot = ST7920_GXDOT;
 const uint16_t st7920_gy_dot = ST7920_GYDOT;
 
+// pixels displayed on the LCD (1 bit per pixel, MSB first like GDRAM) and the rows changed since the last flush
+static uint8_t st7920Shadow[ST7920_GYROWS][ST7920_GXROWS / 8];
+static uint64_t st7920DirtyRows;
+
+static struct
+{
+  uint32_t lastTime;  // start of the current report period (ms)
+  uint32_t frames;    // flushes which changed the LCD
+  uint32_t rows;      // rows drawn
+  uint32_t time;      // time spent drawing (us)
+} st7920Fps;
+
+#if ST7920_FLUSH_ROWS
+
+// LCD coordinates of the emulated pixel edges, the scaling of a pixel may not be an integer in fullscreen mode
+static uint16_t st7920XEdge[ST7920_GXROWS + 1];
+static uint16_t st7920YEdge[ST7920_GYROWS + 1];
+
+static void ST7920_InitEdges(void)
+{
+  for (uint8_t x = 0; x <= ST7920_GXROWS; x++)
+  {
+    st7920XEdge[x] = infoSettings.marlin_fullscreen ? (uint16_t)(st7920_gx_start_full + st7920_gx_dot_full * x)
+                                                    : st7920_gx_start + st7920_gx_dot * x;
+  }
+
+  for (uint8_t y = 0; y <= ST7920_GYROWS; y++)
+  {
+    st7920YEdge[y] = infoSettings.marlin_fullscreen ? (uint16_t)(st7920_gy_start_full + st7920_gy_dot_full * y)
+                                                    : st7920_gy_start + st7920_gy_dot * y;
+  }
+}
+
+// draw a row of the shadow GDRAM, scaled, in a single LCD window
+static void ST7920_DrawRow(uint8_t y)
+{
+  uint16_t sy = st7920YEdge[y];
+  uint16_t ey = st7920YEdge[y + 1];
+
+  if (ey <= sy)
+    return;
+
+  LCD_SetWindow(st7920XEdge[0], sy, st7920XEdge[ST7920_GXROWS] - 1, ey - 1);
+
+  for (; sy < ey; sy++)
+  {
+    for (uint8_t xByte = 0; xByte < ST7920_GXROWS / 8; xByte++)
+    {
+      uint8_t drawByte = st7920Shadow[y][xByte];
+
+      for (uint8_t x = xByte * 8; x < xByte * 8 + 8; x++)
+      {
+        uint16_t color = (drawByte & (1 << 7)) ? infoSettings.marlin_font_color : infoSettings.marlin_bg_color;
+
+        for (uint16_t n = st7920XEdge[x + 1] - st7920XEdge[x]; n > 0; n--)
+        {
+          LCD_WR_16BITS_DATA(color);
+        }
+        drawByte <<= 1;
+      }
+    }
+  }
+}
+
+#else
+
 void ST7920_DrawPixel(int16_t x, int16_t y, bool isForeGround)
 {
   if (infoSettings.marlin_fullscreen)
@@ -59,6 +125,51 @@ void ST7920_DrawPixel(int16_t x, int16_t y, bool isForeGround)
   }
 }
 
+#endif
+
+// report the frames per second drawn on the LCD, the rows drawn and the time spent drawing them
+static inline void ST7920_ReportFps(void)
+{
+  #if defined(SERIAL_DEBUG_ENABLED) && defined(SERIAL_DEBUG_PORT)
+    if (OS_GetTimeMs() - st7920Fps.lastTime < 1000)
+      return;
+
+    dbg_printf("ST7920: %lu fps, %lu rows in %lu us\n", st7920Fps.frames, st7920Fps.rows, st7920Fps.time);
+    st7920Fps.frames = st7920Fps.rows = st7920Fps.time = 0;
+    st7920Fps.lastTime = OS_GetTimeMs();
+  #endif
+}
+
+// draw the rows changed since the last call, called once the received data have been parsed
+void ST7920_Flush(void)
+{
+  if (st7920DirtyRows != 0)
+  {
+    #if ST7920_FLUSH_ROWS
+      uint32_t start = OS_GetTimeUs();
+    #endif
+
+    for (uint8_t y = 0; y < ST7920_GYROWS; y++)
+    {
+      if (st7920DirtyRows & ((uint64_t)1 << y))
+      {
+        #if ST7920_FLUSH_ROWS
+          ST7920_DrawRow(y);
+        #endif
+        st7920Fps.rows++;
+      }
+    }
+
+    #if ST7920_FLUSH_ROWS
+      st7920Fps.time += OS_GetTimeUs() - start;
+    #endif
+    st7920Fps.frames++;
+    st7920DirtyRows = 0;
+  }
+
+  ST7920_ReportFps();
+}
+
 void ST7920_ClearRAM(void)
 {
   // Clear CGRAM buffer
@@ -77,6 +188,13 @@ void ST7920_Init(ST7920 *pStruct)
   pSt7920->position = st7920_init_position;
   pSt7920->reg = st7920_inti_reg;
   ST7920_ClearRAM();
+  // the LCD has been cleared with the background color
+  memset(st7920Shadow, 0, sizeof(st7920Shadow));
+  st7920DirtyRows = 0;
+  st7920Fps.lastTime = OS_GetTimeMs();
+  #if ST7920_FLUSH_ROWS
+    ST7920_InitEdges();
+  #endif
   // Init 8x16Font
   W25Qxx_ReadBuffer((uint8_t *)pSt7920->_8x16Font, _8X16_FONT_ADDR, sizeof(pSt7920->_8x16Font));
 }
@@ -124,11 +242,28 @@ void ST7920_DrawByte(uint8_t xByte, uint8_t yPixel)
   }
 
   drawByte ^= pSt7920->GDRAM[yPixel][xByte];  // XOR GDRAM
-  for (uint8_t i = 0; i < 8; i++)
-  {
-    ST7920_DrawPixel(xByte * 8 + i, yPixel, drawByte & (1 << 7));
-    drawByte <<= 1;
-  }
+
+  if (yPixel >= ST7920_GYROWS)
+    return;
+
+  #if ST7920_FLUSH_ROWS
+    if (st7920Shadow[yPixel][xByte] == drawByte)  // unchanged pixels are not drawn again
+      return;
+  #endif
+
+  st7920Shadow[yPixel][xByte] = drawByte;
+  st7920DirtyRows |= (uint64_t)1 << yPixel;
+
+  #if !ST7920_FLUSH_ROWS
+    uint32_t start = OS_GetTimeUs();
+
+    for (uint8_t i = 0; i < 8; i++)
+    {
+      ST7920_DrawPixel(xByte * 8 + i, yPixel, drawByte & (1 << 7));
+      drawByte <<= 1;
+    }
+    st7920Fps.time += OS_GetTimeUs() - start;
+  #endif
 }
 
 // Display graphic
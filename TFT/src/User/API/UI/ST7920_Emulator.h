@@ -26,6 +26,10 @@ extern "C" {
 #define ST7920_GXSTART ((LCD_WIDTH - ST7920_GXDOT * ST7920_GXROWS) / 2)
 #define ST7920_GYSTART ((LCD_HEIGHT - ST7920_GYDOT * ST7920_GYROWS) / 2)
 
+// 1: changed rows of the shadow GDRAM are drawn by ST7920_Flush() as one LCD window each
+// 0: each pixel is drawn as a rectangle as soon as it is received (slower, kept for comparison)
+#define ST7920_FLUSH_ROWS 1
+
 typedef void (*FP_CMD)(uint8_t);
 
 typedef enum
@@ -259,6 +263,7 @@ typedef struct
 
 void ST7920_Init(ST7920 *pStruct);
 void ST7920_ParseRecv(uint8_t val);
+void ST7920_Flush(void);
 
 #ifdef __cplusplus
 }
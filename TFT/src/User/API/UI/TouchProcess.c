@@ -26,17 +26,221 @@
 #define F TSC_Para[5]
 #define K TSC_Para[6]
 
+#define TOUCH_SAMPLE_MS     2    // conversion period while the pen is down
+#define TOUCH_ERR_RANGE     50   // max spread of the AD values filtered by the median
+#define TOUCH_DEBOUNCE_MS   20   // pen down time before a press is reported
+#define TOUCH_RELEASE_MS    4    // pen up time before a release is reported
+#define TOUCH_MOVE_PIXELS   3    // distance between two move events
+#define TOUCH_IIR_SHIFT     2    // filtered += (sample - filtered) / 4
+#define TOUCH_QUEUE_SIZE    16   // power of 2
+#define TOUCH_EVENT_TIMEOUT 500  // a press not handled within this time (e.g. by a busy or non touch menu) is discarded
+
 int32_t TSC_Para[7];
 static volatile bool touchScreenIsPress = false;
 bool touchSound = true;
 
+// filtered touch panel values (AD << 4), updated by the sampler
+static volatile int32_t touchRawX = 0, touchRawY = 0;
+
+// single producer (sampler), single consumer (KEY_GetValue) event queue
+static TOUCH_EVENT touchQueue[TOUCH_QUEUE_SIZE];
+static volatile uint8_t touchQueueHead = 0;  // written by the producer only
+static volatile uint8_t touchQueueTail = 0;  // written by the consumer only
+static volatile uint16_t touchQueueDropped = 0;
+
+// key pressed and not released yet, see KEY_GetValue()
+static uint16_t keyPressed = IDLE_TOUCH;
+static bool keyFirstPress = true;
+static FP_MENU keyMenu = NULL;  // menu of the last KEY_GetValue() call
+
+// the panel is sampled at the lowest interrupt priority (loopTouchScreen() in PendSV_Handler(), pended by the 1 ms tick).
+// On HW_SPI_TOUCH boards the SPI is shared with the W25Qxx, the main loop (loop task and the readers below) samples there
+#ifdef HW_SPI_TOUCH
+  static void TS_Sample(void);
+
+  #define TS_POLL() TS_Sample()
+#else
+  #define TS_POLL()
+#endif
+
+static void TS_ToLcd(int32_t raw_x, int32_t raw_y, uint16_t *x, uint16_t *y)
+{
+  if (K == 0)  // not calibrated yet
+  {
+    *x = *y = 0;
+    return;
+  }
+
+  raw_x >>= 4;
+  raw_y >>= 4;
+  *x = (A * raw_x + B * raw_y + C) / K;
+  *y = (D * raw_x + E * raw_y + F) / K;
+}
+
+static void TS_Get_Raw(uint16_t *x, uint16_t *y)
+{
+  TS_POLL();
+  *x = touchRawX >> 4;
+  *y = touchRawY >> 4;
+}
+
 void TS_Get_Coordinates(uint16_t *x, uint16_t *y)
 {
-  uint16_t tp_x = XPT2046_Repeated_Compare_AD(CMD_RDX);
-  uint16_t tp_y = XPT2046_Repeated_Compare_AD(CMD_RDY);
+  TS_POLL();
+  TS_ToLcd(touchRawX, touchRawY, x, y);
+}
+
+static void TS_PushEvent(TOUCH_EVENT_TYPE type, uint32_t time, uint16_t x, uint16_t y)
+{
+  TOUCH_EVENT *event = &touchQueue[touchQueueHead & (TOUCH_QUEUE_SIZE - 1)];
+
+  // moves only use half of the queue, so presses and releases are never lost
+  if ((uint8_t)(touchQueueHead - touchQueueTail) >= ((type == TOUCH_MOVE) ? TOUCH_QUEUE_SIZE / 2 : TOUCH_QUEUE_SIZE))
+  {
+    touchQueueDropped++;
+    return;
+  }
+
+  event->time = time;
+  event->x = x;
+  event->y = y;
+  event->type = type;
+  __sync_synchronize();  // the event is written before it is published
+  touchQueueHead++;
+}
+
+bool TS_IsEventPending(void)
+{
+  return touchQueueTail != touchQueueHead;
+}
+
+// drop the queued events and the key being pressed, e.g. the events of a screen waiting with isPress()
+void TS_FlushEvents(void)
+{
+  touchQueueTail = touchQueueHead;
+  keyPressed = IDLE_TOUCH;
+  keyFirstPress = true;
+}
+
+bool TS_GetEvent(TOUCH_EVENT *event)
+{
+  TS_POLL();
+
+  if (touchQueueTail == touchQueueHead)
+    return false;
+
+  *event = touchQueue[touchQueueTail & (TOUCH_QUEUE_SIZE - 1)];
+  __sync_synchronize();  // the event is read before its slot is released
+  touchQueueTail++;
+  return true;
+}
+
+static uint16_t TS_Median(const uint16_t *v, uint16_t *spread)
+{
+  uint16_t min = MIN(v[0], MIN(v[1], v[2]));
+  uint16_t max = MAX(v[0], MAX(v[1], v[2]));
+
+  *spread = max - min;
+  return v[0] + v[1] + v[2] - min - max;
+}
+
+// a conversion per axis, filtered by the median of the last 3 ones then smoothed by an IIR filter.
+// False until the filtered value is valid (3 conversions since "restart" and close enough to each other)
+static bool TS_Filter(bool restart)
+{
+  static uint16_t history_x[3], history_y[3];
+  static uint8_t count = 0, index = 0;
+  static bool seeded = false;
+  uint16_t sample_x = XPT2046_Read_AD(CMD_RDX);
+  uint16_t sample_y = XPT2046_Read_AD(CMD_RDY);
+  uint16_t spread_x, spread_y;
+  int32_t median_x, median_y;
+
+  if (restart)
+    count = index = seeded = 0;
+
+  if (XPT2046_Read_Pen())  // the pen was lifted during the conversions
+    return false;
+
+  history_x[index] = sample_x;
+  history_y[index] = sample_y;
+  index = (index + 1) % 3;
+  if (count < 3 && ++count < 3)
+    return false;
+
+  median_x = TS_Median(history_x, &spread_x);
+  median_y = TS_Median(history_y, &spread_y);
+  if (spread_x >= TOUCH_ERR_RANGE || spread_y >= TOUCH_ERR_RANGE)
+    return seeded;  // keep the last filtered value
+
+  if (!seeded)
+  {
+    touchRawX = median_x << 4;
+    touchRawY = median_y << 4;
+    seeded = true;
+  }
+  else
+  {
+    touchRawX += ((median_x << 4) - touchRawX) >> TOUCH_IIR_SHIFT;
+    touchRawY += ((median_y << 4) - touchRawY) >> TOUCH_IIR_SHIFT;
+  }
+  return true;
+}
+
+// debounce the pen, sample the panel every TOUCH_SAMPLE_MS while it is down and queue the press/move/release events
+static void TS_Sample(void)
+{
+  static bool penDown = false;
+  static uint32_t penDownTime, penLastTime, sampleTime;
+  static uint16_t lastX, lastY;
+  uint32_t now = OS_GetTimeMs();
+  uint16_t x, y;
+
+  if (!XPT2046_Read_Pen())
+  {
+    if (!penDown)
+    {
+      penDown = true;
+      penDownTime = now;
+      sampleTime = now - TOUCH_SAMPLE_MS;
+    }
+    penLastTime = now;
+
+    if (now - sampleTime < TOUCH_SAMPLE_MS)
+      return;
+
+    sampleTime = now;
+    if (!TS_Filter(sampleTime == penDownTime))
+      return;
+
+    TS_ToLcd(touchRawX, touchRawY, &x, &y);
 
-  *x = (A * tp_x + B * tp_y + C) / K;
-  *y = (D * tp_x + E * tp_y + F) / K;
+    if (!touchScreenIsPress)
+    {
+      if (now - penDownTime >= TOUCH_DEBOUNCE_MS)
+      {
+        touchScreenIsPress = true;
+        TS_PushEvent(TOUCH_PRESS, penDownTime, x, y);
+        lastX = x;
+        lastY = y;
+      }
+    }
+    else if (ABS(x - lastX) >= TOUCH_MOVE_PIXELS || ABS(y - lastY) >= TOUCH_MOVE_PIXELS)
+    {
+      TS_PushEvent(TOUCH_MOVE, now, x, y);
+      lastX = x;
+      lastY = y;
+    }
+  }
+  else if (penDown && now - penLastTime >= TOUCH_RELEASE_MS)
+  {
+    penDown = false;
+    if (touchScreenIsPress)
+    {
+      touchScreenIsPress = false;
+      TS_PushEvent(TOUCH_RELEASE, now, lastX, lastY);
+    }
+  }
 }
 
 #define TS_ERR_RANGE 10
@@ -56,8 +260,8 @@ uint8_t calibrationEnsure(uint16_t x, uint16_t y)
     GUI_DrawPoint(x, y - i);
   }
   while (!isPress());
-  tp_x = XPT2046_Repeated_Compare_AD(CMD_RDX);
-  tp_y = XPT2046_Repeated_Compare_AD(CMD_RDY);
+  TS_Get_Raw(&tp_x, &tp_y);
+  TS_FlushEvents();
 
   lcd_x = (A * tp_x + B * tp_y + C) / K;
   lcd_y = (D * tp_x + E * tp_y + F) / K;
@@ -88,6 +292,12 @@ void TSC_Calibration(void)
   uint32_t tp_num = 0;
   int i;
 
+  #ifdef NATIVE_HOST  // no touch panel on the host, use 1:1 parameters
+    A = E = K = 1;
+    B = C = D = F = 0;
+    return;
+  #endif
+
   do
   {
     GUI_Clear(WHITE);
@@ -107,9 +317,9 @@ void TSC_Calibration(void)
         GUI_DrawPoint(LCD_X[tp_num], LCD_Y[tp_num] - i);
       }
       while (isPress() == false);
-      TP_X[tp_num] = XPT2046_Repeated_Compare_AD(CMD_RDX);
-      TP_Y[tp_num] = XPT2046_Repeated_Compare_AD(CMD_RDY);
+      TS_Get_Raw(&TP_X[tp_num], &TP_Y[tp_num]);
       while (isPress() != false);
+      TS_FlushEvents();
     }
     K = (X1 - X3) * (Y2 - Y3) - (X2 - X3) * (Y1 - Y3);
     A = ((XL1 - XL3) * (Y2 - Y3) - (XL2 - XL3) * (Y1 - Y3));
@@ -123,13 +333,9 @@ void TSC_Calibration(void)
   GUI_RestoreColorDefault();
 }
 
-uint16_t Key_value(uint8_t total_rect, const GUI_RECT *menuRect)
+static uint16_t Key_valueAt(uint16_t x, uint16_t y, uint8_t total_rect, const GUI_RECT *menuRect)
 {
-  uint8_t i = 0;
-  uint16_t x, y;
-
-  TS_Get_Coordinates(&x, &y);
-  for (i = 0; i < total_rect; i++)
+  for (uint8_t i = 0; i < total_rect; i++)
   {
     if ((x > menuRect[i].x0) && (x < menuRect[i].x1) && (y > menuRect[i].y0) && (y < menuRect[i].y1))
     {
@@ -142,67 +348,78 @@ uint16_t Key_value(uint8_t total_rect, const GUI_RECT *menuRect)
   return IDLE_TOUCH;
 }
 
-void loopTouchScreen(void)  // Handle in interrupt
+uint16_t Key_value(uint8_t total_rect, const GUI_RECT *menuRect)
 {
-  static uint8_t touch;
-  if (!XPT2046_Read_Pen())
-  {
-    if (touch >= 20)  // 20ms
-    {
-      touchScreenIsPress = true;
-    }
-    else
-    {
-      touch++;
-    }
-  }
-  else
-  {
-    touchScreenIsPress = false;
-    touch = 0;
-  }
+  uint16_t x, y;
+
+  TS_Get_Coordinates(&x, &y);
+  return Key_valueAt(x, y, total_rect, menuRect);
+}
+
+void loopTouchScreen(void)  // Handle in the low priority interrupt, or in the loop tasks on HW_SPI_TOUCH boards
+{
+  TS_Sample();
 }
 
 uint8_t isPress(void)
 {
+  TS_POLL();
   return touchScreenIsPress;
 }
 
 void (*TSC_ReDrawIcon)(uint8_t position, uint8_t is_press) = NULL;
 
-uint16_t KEY_GetValue(uint8_t total_rect, const GUI_RECT* menuRect)
+// report the time from the pen down to the pressed icon being drawn
+static inline void KEY_ReportLatency(uint32_t penDownTime)
 {
-  static uint16_t key_num = IDLE_TOUCH;
-  static bool firstPress = true;
+  #if defined(SERIAL_DEBUG_ENABLED) && defined(SERIAL_DEBUG_PORT)
+    dbg_printf("touch: %lu ms to response, %u events dropped\n", OS_GetTimeMs() - penDownTime, touchQueueDropped);
+  #endif
+}
 
+uint16_t KEY_GetValue(uint8_t total_rect, const GUI_RECT* menuRect)
+{
   uint16_t key_return = IDLE_TOUCH;
+  TOUCH_EVENT event;
 
-  if (touchScreenIsPress)
+  // the events queued before the menu changed were meant for the previous menu (e.g. a second tap on the key opening this one)
+  if (infoMenu.menu[infoMenu.cur] != keyMenu)
   {
-    if (firstPress)
-    {
-      key_num = Key_value(total_rect, menuRect);
-      firstPress = false;
-      if (TSC_ReDrawIcon)
-        TSC_ReDrawIcon(key_num, 1);
-    }
+    keyMenu = infoMenu.menu[infoMenu.cur];
+    TS_FlushEvents();
   }
-  else
+
+  while (key_return == IDLE_TOUCH && TS_GetEvent(&event))
   {
-    if (firstPress == false)
+    if (event.type == TOUCH_PRESS)
     {
-      if (TSC_ReDrawIcon)
-        TSC_ReDrawIcon(key_num, 0);
-      key_return = key_num;
-      key_num = IDLE_TOUCH;
-      firstPress = true;
-
-      #ifdef LCD_LED_PWM_CHANNEL
-        // if LCD is blocked (on idle), skip the first touch, preventing to trigger any undesired action,
-        // and wait the LCD brightness is restored first
-        if (LCD_IsBlocked())
-          key_return = IDLE_TOUCH;
-      #endif
+      if (keyFirstPress && OS_GetTimeMs() - event.time < TOUCH_EVENT_TIMEOUT)
+      {
+        keyPressed = Key_valueAt(event.x, event.y, total_rect, menuRect);
+        keyFirstPress = false;
+        if (TSC_ReDrawIcon)
+          TSC_ReDrawIcon(keyPressed, 1);
+
+        KEY_ReportLatency(event.time);
+      }
+    }
+    else if (event.type == TOUCH_RELEASE)
+    {
+      if (keyFirstPress == false)
+      {
+        if (TSC_ReDrawIcon)
+          TSC_ReDrawIcon(keyPressed, 0);
+        key_return = keyPressed;
+        keyPressed = IDLE_TOUCH;
+        keyFirstPress = true;
+
+        #ifdef LCD_LED_PWM_CHANNEL
+          // if LCD is blocked (on idle), skip the first touch, preventing to trigger any undesired action,
+          // and wait the LCD brightness is restored first
+          if (LCD_IsBlocked())
+            key_return = IDLE_TOUCH;
+        #endif
+      }
     }
   }
   return key_return;
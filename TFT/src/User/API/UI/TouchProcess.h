@@ -30,6 +30,21 @@ enum
 #define KEY_LONG_RELEASE 0x4000  // The second bit is used to identify the release action after a long press
 #define KEY_LONG_CLICK   0x8000  // The first bit is used to identify the long press action
 
+typedef enum
+{
+  TOUCH_PRESS = 0,
+  TOUCH_MOVE,
+  TOUCH_RELEASE,
+} TOUCH_EVENT_TYPE;
+
+typedef struct
+{
+  uint32_t time;  // OS_GetTimeMs() of the event, the pen down time for TOUCH_PRESS
+  uint16_t x;     // LCD coordinates
+  uint16_t y;
+  TOUCH_EVENT_TYPE type;
+} TOUCH_EVENT;
+
 extern bool touchSound;
 
 void TSC_Calibration(void);
@@ -38,6 +53,10 @@ uint16_t KEY_GetValue(uint8_t total_rect, const GUI_RECT *menuRect);
 uint16_t Key_value(uint8_t total_rect, const GUI_RECT *menuRect);
 uint16_t KNOB_GetRV(GUI_RECT *knob);
 
+bool TS_IsEventPending(void);
+bool TS_GetEvent(TOUCH_EVENT *event);
+void TS_FlushEvents(void);
+
 void loopTouchScreen(void);
 
 extern void (*TSC_ReDrawIcon)(uint8_t position, uint8_t is_press);
@@ -10,40 +10,6 @@
   #include "base64.h"
 #endif
 
-#ifdef STM32_HAS_FSMC
-
-void lcd_frame_display(uint16_t sx, uint16_t sy, uint16_t w, uint16_t h, uint32_t addr);
-
-#else
-
-void lcd_frame_display(uint16_t sx, uint16_t sy, uint16_t w, uint16_t h, uint32_t addr)
-{
-  uint16_t x, y;
-  uint16_t color = 0;
-
-  LCD_SetWindow(sx, sy, sx + w - 1, sy + h - 1);
-
-  W25Qxx_SPI_CS_Set(0);
-  W25Qxx_SPI_Read_Write_Byte(CMD_READ_DATA);
-  W25Qxx_SPI_Read_Write_Byte((addr & 0xFF0000) >> 16);
-  W25Qxx_SPI_Read_Write_Byte((addr & 0xFF00) >> 8);
-  W25Qxx_SPI_Read_Write_Byte(addr & 0xFF);
-
-  for (y = sy; y < sy + h; y++)
-  {
-    for (x = sx; x < sx + w; x++)
-    {
-      color = (W25Qxx_SPI_Read_Write_Byte(W25QXX_DUMMY_BYTE) << 8);
-      color |= W25Qxx_SPI_Read_Write_Byte(W25QXX_DUMMY_BYTE);
-      LCD_WR_16BITS_DATA(color);
-    }
-  }
-
-  W25Qxx_SPI_CS_Set(1);
-}
-
-#endif
-
 void lcd_buffer_display(uint16_t sx, uint16_t sy, uint16_t w, uint16_t h, uint16_t *buf, GUI_RECT *limit)
 {
   uint16_t wl = w - limit->x1;
@@ -71,6 +37,123 @@ void getBMPsize(BMP_INFO *bmp)
   bmp->address += COLOR_BYTE_SIZE;
   W25Qxx_ReadBuffer((uint8_t*)&bmp->height, bmp->address, COLOR_BYTE_SIZE);
   bmp->address += COLOR_BYTE_SIZE;
+
+  bmp->rle = (bmp->width & BMP_RLE_FLAG) != 0;
+  bmp->width &= ~BMP_RLE_FLAG;
+}
+
+#define RLE_READ_SIZE 64  // bytes read from flash at once by the RLE decoder
+
+typedef struct
+{
+  uint32_t address;  // flash address of the next byte to be read in buf
+  uint8_t  buf[RLE_READ_SIZE];
+  uint8_t  len;
+  uint8_t  pos;
+} RLE_READER;
+
+static inline void rleSeek(RLE_READER *rd, uint32_t address)
+{
+  rd->address = address;
+  rd->len = rd->pos = 0;
+}
+
+static inline uint8_t rleReadByte(RLE_READER *rd)
+{
+  if (rd->pos == rd->len)
+  {
+    W25Qxx_ReadBuffer(rd->buf, rd->address, RLE_READ_SIZE);
+    rd->address += RLE_READ_SIZE;
+    rd->len = RLE_READ_SIZE;
+    rd->pos = 0;
+  }
+
+  return rd->buf[rd->pos++];
+}
+
+static inline uint16_t rleReadColor(RLE_READER *rd)
+{
+  uint16_t color = rleReadByte(rd) << 8;
+
+  return color | rleReadByte(rd);
+}
+
+static inline void rleSkip(RLE_READER *rd, uint32_t bytes)
+{
+  uint8_t buffered = rd->len - rd->pos;
+
+  if (bytes <= buffered)
+    rd->pos += bytes;
+  else
+    rleSeek(rd, rd->address + bytes - buffered);
+}
+
+// seek to the tokens of row y of a RLE image, bmp->address must point to its row table
+static void rleSeekRow(RLE_READER *rd, const BMP_INFO *bmp, uint16_t y)
+{
+  uint16_t offset;
+
+  W25Qxx_ReadBuffer((uint8_t *)&offset, bmp->address + y * sizeof(offset), sizeof(offset));
+  rleSeek(rd, bmp->address + bmp->height * sizeof(offset) + offset);
+}
+
+// decode RLE tokens, the first skip pixels are dropped and the next count pixels
+// are written (AND mask) to buf, or to the current LCD window if buf is NULL
+static void rleDecode(RLE_READER *rd, uint32_t skip, uint32_t count, uint16_t *buf, uint16_t mask)
+{
+  while (count > 0)
+  {
+    uint8_t token = rleReadByte(rd);
+    uint16_t n = (token & (BMP_RLE_MAX_RUN - 1)) + 1;
+    uint16_t color;
+
+    if (token & BMP_RLE_MAX_RUN)
+    { // run of one color
+      color = rleReadColor(rd) & mask;
+
+      if (skip >= n)
+      {
+        skip -= n;
+        continue;
+      }
+
+      n = MIN(n - skip, count);
+      skip = 0;
+      count -= n;
+
+      while (n--)
+      {
+        if (buf)
+          *buf++ = color;
+        else
+          LCD_WR_16BITS_DATA(color);
+      }
+    }
+    else
+    { // literal colors
+      if (skip >= n)
+      {
+        rleSkip(rd, n * COLOR_BYTE_SIZE);
+        skip -= n;
+        continue;
+      }
+
+      rleSkip(rd, skip * COLOR_BYTE_SIZE);
+      n = MIN(n - skip, count);
+      skip = 0;
+      count -= n;
+
+      while (n--)
+      {
+        color = rleReadColor(rd) & mask;
+
+        if (buf)
+          *buf++ = color;
+        else
+          LCD_WR_16BITS_DATA(color);
+      }
+    }
+  }
 }
 
 void bmpToBuffer(uint16_t *buf, GUI_POINT startPoint, GUI_POINT endPoint, BMP_INFO *iconInfo)
@@ -81,37 +164,46 @@ void bmpToBuffer(uint16_t *buf, GUI_POINT startPoint, GUI_POINT endPoint, BMP_IN
   uint16_t frameWidth = (endPoint.x - startPoint.x);  // total frame width
   uint16_t blockWidth = (endPoint.x >= iconInfo->width) ? (iconInfo->width - startPoint.x) : frameWidth;  // total drawable width
   uint16_t bgWidth = frameWidth - blockWidth;  // total empty width to be filled with bg color
-  uint16_t color = 0;
+  RLE_READER rd;
 
-  // move address to block starting point
-  iconInfo->address += ((iconInfo->width * startPoint.y) + startPoint.x) * COLOR_BYTE_SIZE;
+  // move address to block starting point and start reading the first row by DMA
+  if (!iconInfo->rle && blockLines > 0)
+  {
+    iconInfo->address += ((iconInfo->width * startPoint.y) + startPoint.x) * COLOR_BYTE_SIZE;
+    lcd_frame_read((uint8_t *)buf, iconInfo->address, blockWidth * COLOR_BYTE_SIZE);
+  }
 
   for (uint16_t y = 0; y < blockLines; y++)
   {
-    W25Qxx_SPI_CS_Set(0);
-    W25Qxx_SPI_Read_Write_Byte(CMD_READ_DATA);
-    W25Qxx_SPI_Read_Write_Byte((iconInfo->address & 0xFF0000) >> 16);
-    W25Qxx_SPI_Read_Write_Byte((iconInfo->address & 0xFF00) >> 8);
-    W25Qxx_SPI_Read_Write_Byte(iconInfo->address & 0xFF);
-
-    for (uint8_t x = 0; x < blockWidth; x++)
+    if (iconInfo->rle)
     {
-      color = (W25Qxx_SPI_Read_Write_Byte(W25QXX_DUMMY_BYTE) << 8);
-      color |= W25Qxx_SPI_Read_Write_Byte(W25QXX_DUMMY_BYTE);
-      buf[(y * frameWidth) + x] = color;
+      rleSeekRow(&rd, iconInfo, startPoint.y + y);
+      rleDecode(&rd, startPoint.x, blockWidth, buf + (y * frameWidth), 0xFFFF);
     }
+    else
+    {
+      uint16_t *row = buf + (y * frameWidth);
 
-    W25Qxx_SPI_CS_Set(1);
+      lcd_frame_wait();
+      iconInfo->address += iconInfo->width * COLOR_BYTE_SIZE;
+
+      // the next row is read while this one is swapped
+      if (y + 1 < blockLines)
+        lcd_frame_read((uint8_t *)(row + frameWidth), iconInfo->address, blockWidth * COLOR_BYTE_SIZE);
+
+      for (uint16_t x = 0; x < blockWidth; x++)
+      {
+        row[x] = (row[x] << 8) | (row[x] >> 8);  // the flash data are big endian
+      }
+    }
 
     if (bgWidth)
     {
-      for (uint8_t x = blockWidth; x < frameWidth; x++)
+      for (uint16_t x = blockWidth; x < frameWidth; x++)
       {
         buf[(y * frameWidth) + x] = infoSettings.bg_color;
       }
     }
-
-    iconInfo->address += iconInfo->width * COLOR_BYTE_SIZE;
   }
 
   // fill empty frame lines with background color
@@ -121,13 +213,21 @@ void bmpToBuffer(uint16_t *buf, GUI_POINT startPoint, GUI_POINT endPoint, BMP_IN
   }
 }
 
+// draw a RLE image, its rows are stored back to back so the tokens are decoded in one go
+static void rleDisplay(uint16_t sx, uint16_t sy, const BMP_INFO *bmp, uint16_t mask)
+{
+  RLE_READER rd;
+
+  LCD_SetWindow(sx, sy, sx + bmp->width - 1, sy + bmp->height - 1);
+  rleSeek(&rd, bmp->address + bmp->height * sizeof(uint16_t));
+  rleDecode(&rd, 0, bmp->width * bmp->height, NULL, mask);
+}
+
 // draw an image from specific address on flash (sx & sy cordinates for top left of image, w width, h height, addr flash byte address)
+// for uncompressed images only (logo, info box), icons may be RLE compressed so use ICON_ReadDisplay()
 void IMAGE_ReadDisplay(uint16_t sx, uint16_t sy, uint32_t address)
 {
-  BMP_INFO bmpInfo = {.index = ICON_NULL, .address = address};
-
-  getBMPsize(&bmpInfo);
-  lcd_frame_display(sx, sy, bmpInfo.width, bmpInfo.height, bmpInfo.address);
+  lcd_image_display(sx, sy, address);
 }
 
 void LOGO_ReadDisplay(void)
@@ -137,7 +237,14 @@ void LOGO_ReadDisplay(void)
 
 void ICON_ReadDisplay(uint16_t sx, uint16_t sy, uint8_t icon)
 {
-  IMAGE_ReadDisplay(sx, sy, ICON_ADDR(icon));
+  BMP_INFO bmpInfo = {.index = icon, .address = 0};
+
+  getBMPsize(&bmpInfo);
+
+  if (bmpInfo.rle)
+    rleDisplay(sx, sy, &bmpInfo, 0xFFFF);
+  else
+    lcd_frame_display(sx, sy, bmpInfo.width, bmpInfo.height, bmpInfo.address);
 }
 
 // load the selected area of bmp icon from flash to buffer
@@ -151,29 +258,6 @@ void ICON_ReadBuffer(uint16_t *buf, uint16_t x, uint16_t y, int16_t w, int16_t h
   bmpToBuffer(buf, startPoint, endPoint, &iconInfo);
 }
 
-uint16_t ICON_ReadPixel(uint32_t address, uint16_t w, uint16_t h, int16_t x, int16_t y)
-{
-  // Out of range calls
-  if (x > w || y > h)
-    return infoSettings.bg_color;
-
-  uint16_t color;
-  address += ((w * y) + x) * COLOR_BYTE_SIZE;
-
-  W25Qxx_SPI_CS_Set(0);
-  W25Qxx_SPI_Read_Write_Byte(CMD_READ_DATA);
-  W25Qxx_SPI_Read_Write_Byte((address & 0xFF0000) >> 16);
-  W25Qxx_SPI_Read_Write_Byte((address & 0xFF00) >> 8);
-  W25Qxx_SPI_Read_Write_Byte(address & 0xFF);
-
-  color  = (W25Qxx_SPI_Read_Write_Byte(W25QXX_DUMMY_BYTE) << 8);
-  color |= W25Qxx_SPI_Read_Write_Byte(W25QXX_DUMMY_BYTE);
-
-  W25Qxx_SPI_CS_Set(1);
-
-  return color;
-}
-
 uint16_t modelFileReadHalfword(FIL *fp)
 {
   uint8_t buf[4];
@@ -547,13 +631,15 @@ void ICON_PressedDisplay(uint16_t sx, uint16_t sy, uint8_t icon)
   BMP_INFO bmpInfo = {.index = icon, .address = 0};
   getBMPsize(&bmpInfo);
 
+  if (bmpInfo.rle)
+  {
+    rleDisplay(sx, sy, &bmpInfo, mode);
+    return;
+  }
+
   LCD_SetWindow(sx, sy, sx + bmpInfo.width - 1, sy + bmpInfo.height - 1);
 
-  W25Qxx_SPI_CS_Set(0);
-  W25Qxx_SPI_Read_Write_Byte(CMD_READ_DATA);
-  W25Qxx_SPI_Read_Write_Byte((bmpInfo.address & 0xFF0000) >> 16);
-  W25Qxx_SPI_Read_Write_Byte((bmpInfo.address & 0xFF00) >> 8);
-  W25Qxx_SPI_Read_Write_Byte(bmpInfo.address & 0xFF);
+  W25Qxx_ReadStart(bmpInfo.address);
 
   for (y = sy; y < sy + bmpInfo.width; y++)
   {
@@ -9,6 +9,7 @@ extern "C" {
 #include <stdint.h>
 #include "variants.h"
 #include "GUI.h"
+#include "lcd_dma.h"
 
 #ifdef PORTRAIT_MODE
   #define SPACE_X          ((LCD_WIDTH - ICON_WIDTH * 3) / 3)
@@ -38,12 +39,37 @@ extern "C" {
 
 #define COLOR_BYTE_SIZE sizeof(uint16_t)  // RGB565 color byte is equal to uint16_t
 
+// RLE compressed images have this flag set in the width of the header, followed by
+// a table of uint16_t row offsets (from the end of the table) and the rows of tokens:
+// 0x80 | (n - 1): the next color is repeated n times, (n - 1): n colors follow (n <= 128)
+#define BMP_RLE_FLAG    0x8000
+#define BMP_RLE_MAX_RUN 128
+
+// RLE images are decoded by the CPU. Without LCD_FRAME_ASYNC the CPU writes the raw ones to the LCD too, so an icon
+// is stored compressed only if it is drawn faster that way. Draw time estimates in 1/12 of the SPI flash byte time, for the
+// slowest boards (72 MHz core, 18 MHz SPI): the raw image is its flash bytes, the RLE image its token bytes (plus
+// the command of each 64 bytes read) and the CPU time of the decoder
+#define BMP_RAW_COST_BYTE  12  // flash byte moved by DMA
+#define BMP_RLE_COST_BYTE  13  // flash byte read by the decoder
+#define BMP_RLE_COST_TOKEN 3   // token decoded
+#define BMP_RLE_COST_RUN   3   // pixel of a run written to the LCD
+#define BMP_RLE_COST_LIT   8   // literal pixel read and written to the LCD
+
+// when the frames are drawn by DMA (LCD_FRAME_ASYNC) a raw icon costs no CPU time at all, and the compression saves
+// no flash as each icon has its ICON_MAX_SIZE slot anyway: the icons are only compressed on the other boards
+#ifdef LCD_FRAME_ASYNC
+  #define BMP_RLE_ICONS false
+#else
+  #define BMP_RLE_ICONS true
+#endif
+
 typedef struct
 {
   uint16_t index;
   uint32_t address;
   uint16_t width;
   uint16_t height;
+  bool     rle;
 } BMP_INFO;
 
 // uint32_t _getBMPsizeAddr(uint8_t *w, uint8_t *h, uint32_t address);
@@ -56,7 +82,6 @@ void lcd_buffer_display(uint16_t sx, uint16_t sy, uint16_t w, uint16_t h, uint16
 void LOGO_ReadDisplay(void);
 void ICON_ReadDisplay(uint16_t sx, uint16_t sy, uint8_t icon);
 void ICON_ReadBuffer(uint16_t *buf, uint16_t x, uint16_t y, int16_t w, int16_t h, uint16_t icon);
-uint16_t ICON_ReadPixel(uint32_t address, uint16_t w, uint16_t h, int16_t x, int16_t y);
 bool model_DirectDisplay(GUI_POINT pos, char *gcode);
 bool model_DecodeToFlash(char *gcode);
 void IMAGE_ReadDisplay(uint16_t sx, uint16_t sy, uint32_t address);
@@ -75,6 +75,20 @@ bool scanPrintFiles(void)
   }
 }
 
+// names of the file list, all freed at once by clearInfoFile()
+static ARENA infoFileNames = {NULL, 0, 0, 0, MEM_FILES};
+
+// allocate a name of the file list
+TCHAR * allocInfoFileName(uint16_t size)
+{
+  return arenaAlloc(&infoFileNames, size);
+}
+
+const ARENA * getInfoFileNames(void)
+{
+  return &infoFileNames;
+}
+
 // clear and free memory for file list
 void clearInfoFile(void)
 {
@@ -82,30 +96,20 @@ void clearInfoFile(void)
 
   for (i = 0; i < infoFile.folderCount; i++)
   {
-    free(infoFile.folder[i]);
     infoFile.folder[i] = NULL;
-
-    if (infoFile.longFolder[i] != NULL)  // long folder name is optional so we need to check its presence
-    {
-      free(infoFile.longFolder[i]);
-      infoFile.longFolder[i] = NULL;
-    }
+    infoFile.longFolder[i] = NULL;  // long folder name is optional, it must be NULL when not set by the next scan
   }
 
   for (i = 0; i < infoFile.fileCount; i++)
   {
-    free(infoFile.file[i]);
     infoFile.file[i] = NULL;
-
-    if (infoFile.longFile[i] != NULL)  // long filename is optional so we need to check its presence
-    {
-      free(infoFile.longFile[i]);
-      infoFile.longFile[i] = NULL;
-    }
+    infoFile.longFile[i] = NULL;  // long filename is optional, it must be NULL when not set by the next scan
   }
 
   infoFile.folderCount = 0;
   infoFile.fileCount = 0;
+
+  arenaReset(&infoFileNames);
 }
 
 // clear file list and path
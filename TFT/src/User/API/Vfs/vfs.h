@@ -8,6 +8,7 @@ extern "C" {
 #include <stdbool.h>
 #include <stdint.h>
 #include "ff.h"
+#include "Arena.h"
 
 #define FOLDER_NUM   255
 #define FILE_NUM     255
@@ -55,6 +56,8 @@ bool isPrintModelIcon(void);
 TCHAR * getFS(void);                            // get FS's ID of current source
 bool mountFS(void);                             // mount FS of current source
 bool scanPrintFiles(void);                      // scan files in current source and create a file list
+TCHAR * allocInfoFileName(uint16_t size);       // allocate a name of the file list, freed by clearInfoFile()
+const ARENA * getInfoFileNames(void);           // memory of the file list names
 void clearInfoFile(void);                       // clear and free memory for file list
 
 void resetInfoFile(void);                       // clear file list and path
@@ -42,11 +42,237 @@ const char * const smallIconBmpName[] = {
   // add new icons in small_icon_list.inc only
 };
 
-BMPUPDATE_STAT bmpDecode(char * bmp, uint32_t addr)
+#define ASSET_MANIFEST_SIGN 20261019  // (YYYYMMDD) change if the way icons or fonts are stored in flash changes
+
+// index of the assets in the manifest
+#define ASSET_LOGO      0
+#define ASSET_ICON(num) (1 + (num))
+#define ASSET_INFOBOX   ASSET_ICON(COUNT(iconBmpName))
+#define ASSET_FONT(num) (ASSET_INFOBOX + 1 + (num))
+#define ASSET_COUNT     ASSET_FONT(COUNT(fontAddrList))
+
+typedef struct
+{
+  uint32_t addr;  // flash address of the asset
+  uint32_t size;  // size of the file the asset was stored from, 0 if not stored
+  uint32_t crc;   // CRC32 of the file
+} ASSET_INFO;
+
+// stored after the flash signs, so an update only erases and rewrites the assets whose file changed
+typedef struct
+{
+  uint32_t sign;
+  ASSET_INFO asset[ASSET_COUNT];
+} ASSET_MANIFEST;
+
+static ASSET_MANIFEST * manifest = NULL;  // only allocated while scanning for updates
+static bool manifestUpdated;
+
+// erase the sectors of a flash range, by 64K blocks where aligned
+static void eraseFlash(uint32_t addr, uint32_t size)
+{
+  uint32_t end = addr + size;
+
+  addr &= ~(W25QXX_SECTOR_SIZE - 1);
+
+  while (addr < end)
+  {
+    if ((addr & (W25QXX_BLOCK_SIZE - 1)) == 0 && end - addr >= W25QXX_BLOCK_SIZE)
+    {
+      W25Qxx_EraseBlock(addr);
+      addr += W25QXX_BLOCK_SIZE;
+    }
+    else
+    {
+      W25Qxx_EraseSector(addr);
+      addr += W25QXX_SECTOR_SIZE;
+    }
+  }
+}
+
+static void manifestLoad(void)
+{
+  manifestUpdated = false;
+
+  if (sizeof(ASSET_MANIFEST) > FLASH_SIGN_ADDR + FLASH_SIGN_SIZE - ASSET_MANIFEST_ADDR)
+    return;  // no room after the flash signs, all the assets are updated
+
+  manifest = memAlloc(MEM_BOOT, sizeof(ASSET_MANIFEST));
+
+  if (manifest == NULL)
+    return;
+
+  W25Qxx_ReadBuffer((uint8_t *)manifest, ASSET_MANIFEST_ADDR, sizeof(ASSET_MANIFEST));
+
+  if (manifest->sign != ASSET_MANIFEST_SIGN + ASSET_COUNT)  // no manifest yet or different icon/font list
+  {
+    memset(manifest, 0, sizeof(ASSET_MANIFEST));
+    manifest->sign = ASSET_MANIFEST_SIGN + ASSET_COUNT;
+  }
+}
+
+static void manifestFree(void)
+{
+  memFree(manifest);
+  manifest = NULL;
+}
+
+// return true if the file is the one already stored at addr, else provide its size and CRC32 in info
+static bool assetUnchanged(uint16_t index, const char * path, uint32_t addr, ASSET_INFO * info)
+{
+  FIL file;
+  UINT br;
+  uint8_t buf[256];
+
+  info->addr = addr;
+  info->size = info->crc = 0;
+
+  if (manifest == NULL || f_open(&file, path, FA_OPEN_EXISTING | FA_READ) != FR_OK)
+    return false;
+
+  info->size = f_size(&file);
+
+  while (f_read(&file, buf, sizeof(buf), &br) == FR_OK && br > 0)
+  {
+    info->crc = getCRC32(info->crc, buf, br);
+  }
+
+  f_close(&file);
+
+  if (memcmp(&manifest->asset[index], info, sizeof(ASSET_INFO)) == 0)
+    return true;
+
+  // the asset is going to be rewritten, clear its size in the stored manifest (no erase needed to clear
+  // bits) so a power loss before the manifest is saved again doesn't leave it recorded as valid
+  if (manifest->asset[index].size != 0)
+  {
+    uint32_t size = 0;
+
+    W25Qxx_WritePage((uint8_t *)&size, ASSET_MANIFEST_ADDR + offsetof(ASSET_MANIFEST, asset) +
+                     index * sizeof(ASSET_INFO) + offsetof(ASSET_INFO, size), sizeof(size));
+    manifest->asset[index].size = 0;
+  }
+
+  return false;
+}
+
+static void assetStored(uint16_t index, const ASSET_INFO * info)
+{
+  if (manifest == NULL || info->size == 0)
+    return;
+
+  manifest->asset[index] = *info;
+  manifestUpdated = true;
+}
+
+// compress a row of pixels into RLE tokens (see BMP_RLE_FLAG), return the number of bytes written to out.
+// The CPU time to decode them is added to cpuCost (see BMP_RLE_COST_TOKEN)
+static uint16_t rleEncodeRow(const uint16_t * row, uint16_t w, uint8_t * out, uint32_t * cpuCost)
+{
+  uint16_t len = 0;
+  uint16_t i = 0;
+
+  while (i < w)
+  {
+    uint16_t n = 1;
+
+    while (i + n < w && n < BMP_RLE_MAX_RUN && row[i + n] == row[i])
+      n++;
+
+    if (n > 1)
+    { // run of one color
+      out[len++] = BMP_RLE_MAX_RUN | (n - 1);
+      out[len++] = (uint8_t)(row[i] >> 8);
+      out[len++] = (uint8_t)(row[i] & 0xFF);
+      i += n;
+      *cpuCost += BMP_RLE_COST_TOKEN + n * BMP_RLE_COST_RUN;
+    }
+    else
+    { // literal colors up to the next run
+      uint16_t start = len++;
+
+      n = 0;
+      while (i < w && n < BMP_RLE_MAX_RUN && (i + 1 == w || row[i] != row[i + 1]))
+      {
+        out[len++] = (uint8_t)(row[i] >> 8);
+        out[len++] = (uint8_t)(row[i] & 0xFF);
+        i++;
+        n++;
+      }
+
+      out[start] = n - 1;
+      *cpuCost += BMP_RLE_COST_TOKEN + n * BMP_RLE_COST_LIT;
+    }
+  }
+
+  return len;
+}
+
+// store the bmp RLE compressed, return false if it would not be drawn faster than the raw bitmap
+static bool bmpEncodeRLE(FIL * bmpFile, uint32_t addr, uint16_t w, uint16_t h, short bpp, int offset, int bytePerLine)
+{
+  uint16_t header[2] = {w | BMP_RLE_FLAG, h};
+  uint32_t tokenAddr = addr + sizeof(header) + h * sizeof(uint16_t);  // tokens follow the row table
+  uint32_t rawSize = w * h * COLOR_BYTE_SIZE;
+  uint32_t size = 0;
+  uint32_t cpuCost = 0;
+  uint16_t * rowOffset = memAlloc(MEM_BOOT, h * sizeof(uint16_t));
+  uint16_t * row = memAlloc(MEM_BOOT, w * sizeof(uint16_t));
+  uint8_t * tokens = memAlloc(MEM_BOOT, w * COLOR_BYTE_SIZE + (w + BMP_RLE_MAX_RUN - 1) / BMP_RLE_MAX_RUN);
+  bool success = (rowOffset != NULL && row != NULL && tokens != NULL);
+  uint8_t lcdcolor[4];
+  UINT mybr;
+  GUI_COLOR pix;
+
+  for (int j = 0; success && j < h; j++)
+  {
+    f_lseek(bmpFile, offset + (h - j - 1) * bytePerLine);
+
+    for (int i = 0; i < w; i++)
+    {
+      f_read(bmpFile, (char *)&lcdcolor, bpp, &mybr);
+
+      pix.RGB.r = lcdcolor[2] >> 3;
+      pix.RGB.g = lcdcolor[1] >> 2;
+      pix.RGB.b = lcdcolor[0] >> 3;
+      row[i] = pix.color;
+    }
+
+    uint16_t len = rleEncodeRow(row, w, tokens, &cpuCost);
+
+    if (size + len > UINT16_MAX || h * sizeof(uint16_t) + size + len >= rawSize)
+    {
+      success = false;
+      break;
+    }
+
+    rowOffset[j] = size;
+    W25Qxx_WriteBuffer(tokens, tokenAddr + size, len);
+    size += len;
+  }
+
+  if (success && size * BMP_RLE_COST_BYTE + cpuCost >= rawSize * BMP_RAW_COST_BYTE)
+    success = false;
+
+  if (success)
+  {
+    W25Qxx_WriteBuffer((uint8_t *)header, addr, sizeof(header));
+    W25Qxx_WriteBuffer((uint8_t *)rowOffset, addr + sizeof(header), h * sizeof(uint16_t));
+  }
+
+  memFree(tokens);
+  memFree(row);
+  memFree(rowOffset);
+
+  return success;
+}
+
+BMPUPDATE_STAT bmpDecode(char * bmp, uint32_t addr, bool rle)
 {
   FIL bmpFile;
   char magic[2];
   uint16_t w, h;
+  int32_t bmpW, bmpH;
   int bytePerLine;
   short bpp;
   int offset;
@@ -70,8 +296,10 @@ BMPUPDATE_STAT bmpDecode(char * bmp, uint32_t addr)
   f_lseek(&bmpFile, 10);
   f_read(&bmpFile, &offset, sizeof(int), &mybr);
   f_lseek(&bmpFile, 18);
-  f_read(&bmpFile, &w, sizeof(int), &mybr);
-  f_read(&bmpFile, &h, sizeof(int), &mybr);
+  f_read(&bmpFile, &bmpW, sizeof(bmpW), &mybr);  // 32 bit fields, don't read them straight into w and h
+  f_read(&bmpFile, &bmpH, sizeof(bmpH), &mybr);
+  w = bmpW;
+  h = bmpH;
   f_lseek(&bmpFile, 28);
   f_read(&bmpFile, &bpp, sizeof(short), &mybr);
 
@@ -89,9 +317,18 @@ BMPUPDATE_STAT bmpDecode(char * bmp, uint32_t addr)
   if (bytePerLine % 4 != 0)  // bmp
     bytePerLine = (bytePerLine / 4 + 1) * 4;
 
-  for (bnum = 0; bnum < (w * h * 2 + W25QXX_SECTOR_SIZE - 1) / W25QXX_SECTOR_SIZE; bnum++)
+  eraseFlash(addr, w * h * 2);
+
+  if (rle)
   {
-    W25Qxx_EraseSector(addr + bnum * W25QXX_SECTOR_SIZE);
+    if (bmpEncodeRLE(&bmpFile, addr, w, h, bpp, offset, bytePerLine))
+    {
+      f_close(&bmpFile);
+      return BMP_SUCCESS;
+    }
+
+    // not drawn faster compressed, store it as raw bitmap
+    eraseFlash(addr, w * h * 2);
   }
 
   bnum = 0;
@@ -133,10 +370,45 @@ BMPUPDATE_STAT bmpDecode(char * bmp, uint32_t addr)
   return BMP_SUCCESS;
 }
 
+// store a bmp unless the same file is already stored, the time spent is reported on the debug port
+static BMPUPDATE_STAT updateBmp(uint16_t index, char * bmp, uint32_t addr, bool rle, uint16_t * unchanged)
+{
+  #if defined(SERIAL_DEBUG_ENABLED) && defined(SERIAL_DEBUG_PORT)
+    uint32_t startTime = OS_GetTimeMs();
+  #endif
+  BMPUPDATE_STAT bmpState = BMP_SUCCESS;
+  ASSET_INFO info;
+
+  if (assetUnchanged(index, bmp, addr, &info))
+  {
+    uint16_t size[2];
+
+    // bmp_size is used to clear the previously displayed image
+    W25Qxx_ReadBuffer((uint8_t *)size, addr, sizeof(size));
+    bmp_size.x = size[0] & ~BMP_RLE_FLAG;
+    bmp_size.y = size[1];
+    (*unchanged)++;
+  }
+  else
+  {
+    bmpState = bmpDecode(bmp, addr, rle);
+
+    if (bmpState == BMP_SUCCESS)
+      assetStored(index, &info);
+  }
+
+  #if defined(SERIAL_DEBUG_ENABLED) && defined(SERIAL_DEBUG_PORT)
+    dbg_printf("%s: %lu ms\n", bmp, OS_GetTimeMs() - startTime);
+  #endif
+
+  return bmpState;
+}
+
 static inline bool updateIcon(char * rootDir)
 {
   uint16_t found = 0;
   uint16_t notfound = 0;
+  uint16_t unchanged = 0;
   char curBmpPath[64];
   char tempstr[50];
   BMPUPDATE_STAT bmpState;
@@ -146,7 +418,7 @@ static inline bool updateIcon(char * rootDir)
   GUI_ClearPrect(&iconUpdateRect);
 
   GET_FULL_PATH(curBmpPath, rootDir, BMP_UPDATE_DIR "/Logo" STR_PORTRAIT ".bmp");
-  bmpState = bmpDecode(curBmpPath, LOGO_ADDR);
+  bmpState = updateBmp(ASSET_LOGO, curBmpPath, LOGO_ADDR, false, &unchanged);
 
   if (bmpState == BMP_SUCCESS)
   {
@@ -169,13 +441,13 @@ static inline bool updateIcon(char * rootDir)
     GUI_ClearPrect(&labelUpdateRect);
     GUI_DispString(labelUpdateRect.x0, labelUpdateRect.y0, (uint8_t *)curBmpPath);
 
-    bmpState = bmpDecode(curBmpPath, ICON_ADDR(i));
+    bmpState = updateBmp(ASSET_ICON(i), curBmpPath, ICON_ADDR(i), BMP_RLE_ICONS, &unchanged);
 
     if (bmpState == BMP_SUCCESS)
     {  // display bmp update success
       found++;
       GUI_ClearRect(iconUpdateRect.x0, iconUpdateRect.y0, iconUpdateRect.x0 + last_size.x, iconUpdateRect.y0 + last_size.y);
-      IMAGE_ReadDisplay(iconUpdateRect.x0, iconUpdateRect.y0, ICON_ADDR(i));
+      ICON_ReadDisplay(iconUpdateRect.x0, iconUpdateRect.y0, i);
     }
     else
     {  // display bmp update fail
@@ -184,12 +456,12 @@ static inline bool updateIcon(char * rootDir)
       dispIconFail((uint8_t *)curBmpPath, bmpState);
     }
     // Display icon update progress
-    sprintf(tempstr, "Updated: %d | Not Updated: %d", found, notfound);
+    sprintf(tempstr, "Updated: %d | Not Updated: %d | Same: %d", found - unchanged, notfound, unchanged);
     GUI_DispString(statUpdateRect.x0, statUpdateRect.y0, (uint8_t *)tempstr);
   }
 
   GET_FULL_PATH(curBmpPath, rootDir, BMP_UPDATE_DIR "/InfoBox.bmp");
-  bmpState = bmpDecode(curBmpPath, INFOBOX_ADDR);
+  bmpState = updateBmp(ASSET_INFOBOX, curBmpPath, INFOBOX_ADDR, false, &unchanged);
 
   if (bmpState == BMP_SUCCESS)
   {
@@ -237,7 +509,7 @@ void dispIconFail(uint8_t * lbl, BMPUPDATE_STAT bmpState)
   Delay_ms(1000);  // give some time to the user to read failed icon name.
 }
 
-bool updateFont(char * font, uint32_t addr)
+bool updateFont(uint8_t index, char * font, uint32_t addr)
 {
   uint8_t progress = 0;
   UINT rnum = 0;
@@ -245,11 +517,19 @@ bool updateFont(char * font, uint32_t addr)
   char buffer[128];
   FIL myfp;
   uint8_t * tempbuf = NULL;
+  uint32_t startTime = OS_GetTimeMs();
+  ASSET_INFO info;
+
+  if (assetUnchanged(ASSET_FONT(index), font, addr, &info))
+  {
+    dbg_printf("%s: unchanged, %lu ms\n", font, OS_GetTimeMs() - startTime);
+    return true;
+  }
 
   if (f_open(&myfp, font, FA_OPEN_EXISTING|FA_READ) != FR_OK)
     return false;
 
-  tempbuf = malloc(W25QXX_SECTOR_SIZE);
+  tempbuf = memAlloc(MEM_BOOT, W25QXX_SECTOR_SIZE);
 
   if (tempbuf == NULL)
     return false;
@@ -259,11 +539,12 @@ bool updateFont(char * font, uint32_t addr)
   GUI_DispString(0, 100, (uint8_t *)buffer);
   GUI_DispString(0, 140, (uint8_t *)"Updating:   %");
 
+  eraseFlash(addr, f_size(&myfp));
+
   while (!f_eof(&myfp))
   {
     if (f_read(&myfp, tempbuf, W25QXX_SECTOR_SIZE, &rnum) != FR_OK) break;
 
-    W25Qxx_EraseSector(addr + offset);
     W25Qxx_WriteBuffer(tempbuf, addr + offset, W25QXX_SECTOR_SIZE);
     offset += rnum;
 
@@ -276,8 +557,15 @@ bool updateFont(char * font, uint32_t addr)
     if (rnum !=W25QXX_SECTOR_SIZE) break;
   }
 
+  if (offset == info.size)
+    assetStored(ASSET_FONT(index), &info);
+
   f_close(&myfp);
-  free(tempbuf);
+  memFree(tempbuf);
+
+  sprintf(buffer, "Time: %lu ms", OS_GetTimeMs() - startTime);
+  GUI_DispString(0, 180, (uint8_t *)buffer);
+  dbg_printf("%s: %lu ms\n", font, OS_GetTimeMs() - startTime);
   return true;
 }
 
@@ -365,6 +653,9 @@ static inline void saveflashSign(uint8_t * buf, uint32_t size)
   W25Qxx_EraseSector(FLASH_SIGN_ADDR);
   Delay_ms(100);  // give time for spi flash to settle
   W25Qxx_WriteBuffer(buf, FLASH_SIGN_ADDR, size);
+
+  if (manifest != NULL)  // same sector
+    W25Qxx_WriteBuffer((uint8_t *)manifest, ASSET_MANIFEST_ADDR, sizeof(ASSET_MANIFEST));
 }
 
 void scanUpdates(void)
@@ -388,6 +679,7 @@ checkupdate:
     uint32_t saved_flash_sign[sign_count];
 
     W25Qxx_ReadBuffer((uint8_t *)&saved_flash_sign, FLASH_SIGN_ADDR, sizeof(saved_flash_sign));
+    manifestLoad();
 
     // check for font update
     GET_FULL_PATH(curfilePath, rootDir, FONT_UPDATE_DIR);
@@ -397,7 +689,7 @@ checkupdate:
       for (uint8_t i = 0; i < COUNT(fontAddrList); i++)
       {
         GET_FULL_PATH(curfilePath, rootDir, fontPathList[i]);
-        if (!updateFont(curfilePath, fontAddrList[i]))
+        if (!updateFont(i, curfilePath, fontAddrList[i]))
           updateOk = false;  // set update to false if any font fails to update
       }
 
@@ -440,11 +732,13 @@ checkupdate:
     // check for reset file
     scanResetDir(rootDir);
 
-    // update flash sign
-    if (flash_sign_updated)
+    // update flash sign and assets manifest
+    if (flash_sign_updated || manifestUpdated)
     {
       saveflashSign((uint8_t *)saved_flash_sign, sizeof(saved_flash_sign));
     }
+
+    manifestFree();
   }
 
   #ifdef USB_FLASH_DRIVE_SUPPORT
@@ -9,7 +9,8 @@ extern "C" {
 #include <stdint.h>
 #include "variants.h"
 
-#define W25QXX_SECTOR_SIZE (0x1000)  // 4096-4K
+#define W25QXX_SECTOR_SIZE (0x1000)   // 4096-4K
+#define W25QXX_BLOCK_SIZE  (0x10000)  // 65536-64K
 
 #ifndef LOGO_MAX_SIZE
   #define LOGO_MAX_SIZE            0x4B000
@@ -41,12 +42,14 @@ extern "C" {
 #define PREHEAT_STORE_ADDR      (STRINGS_STORE_ADDR + STRINGS_STORE_MAX_SIZE)  // for preheat settings from config file
 #define PRINT_GCODES_ADDR       (PREHEAT_STORE_ADDR + PREHEAT_STORE_MAX_SIZE)  // for start/end/cancel gcodes from config file
 #define CUSTOM_GCODE_ADDR       (PRINT_GCODES_ADDR + PRINT_GCODES_MAX_SIZE)    // for custom gcodes from config file
+#define ASSET_MANIFEST_ADDR     (FLASH_SIGN_ADDR + 0x100)                      // size and CRC32 of the files of the stored icons and fonts
 
 #define ICON_ADDR(num)          ((num) * ICON_MAX_SIZE + CUSTOM_GCODE_ADDR + CUSTOM_GCODE_MAX_SIZE)
 #define INFOBOX_ADDR            (ICON_ADDR(ICON_PREVIEW) + ICON_MAX_SIZE)      // total byte size 0xA7F8
 #define SMALL_ICON_START_ADDR   (INFOBOX_ADDR + INFOBOX_MAX_SIZE)
 #define SMALL_ICON_ADDR(num)    ((num) * SMALL_ICON_MAX_SIZE + SMALL_ICON_START_ADDR)
 #define FLASH_USED              (INFOBOX_ADDR + INFOBOX_MAX_SIZE)              // currently small icons are not used
+#define PARA_BACKUP_ADDR(cap)   ((cap) - W25QXX_SECTOR_SIZE)                   // last sector, copy of the user parameters while rewritten in the MCU flash
 
 #ifdef PORTRAIT_MODE
   #define STR_PORTRAIT STRINGIFY(PORTRAIT_MODE)
@@ -113,7 +116,7 @@ typedef union
 
 void scanUpdates(void);
 void dispIconFail(uint8_t * lbl, BMPUPDATE_STAT bmpState);
-BMPUPDATE_STAT bmpDecode(char * bmp, uint32_t addr);
+BMPUPDATE_STAT bmpDecode(char * bmp, uint32_t addr, bool rle);
 
 #ifdef __cplusplus
 }
@@ -40,6 +40,12 @@ uint8_t customcode_index = 0;
 uint8_t customcode_good[CUSTOM_GCODES_COUNT];
 bool scheduleRotate = false;
 
+// hash index of the keywords of the file being parsed, a line starting with a keyword ("key:")
+// is dispatched by one hash lookup instead of searching each keyword in the line
+static const char * const * keywordList = NULL;
+static uint16_t * keywordSlots = NULL;  // keyword index + 1, 0: empty slot
+static uint16_t keywordMask;            // slots - 1, at least twice the keywords as a power of 2
+
 bool getConfigFromFile(char * configPath)
 {
   if (f_file_exists(configPath) == false)
@@ -65,7 +71,7 @@ bool getConfigFromFile(char * configPath)
 
   drawProgressPage((uint8_t*)"Updating Configuration...");
 
-  if (readConfigFile(configPath, parseConfigLine, LINE_MAX_CHAR))
+  if (readConfigFile(configPath, parseConfigLine, LINE_MAX_CHAR, config_keywords, CONFIG_COUNT))
   {
     // store custom codes count
     configCustomGcodes->count = customcode_index;
@@ -117,8 +123,9 @@ bool getLangFromFile(char * rootDir)
   {
     W25Qxx_EraseSector(LANGUAGE_ADDR + (i * W25QXX_SECTOR_SIZE));
   }
+  labelCacheClear();
 
-  success = readConfigFile(langpath, parseLangLine, MAX_LANG_LABEL_LENGTH + 100);
+  success = readConfigFile(langpath, parseLangLine, MAX_LANG_LABEL_LENGTH + 100, lang_key_list, LABEL_NUM);
 
   if (foundkeys != LABEL_NUM)
   {
@@ -142,7 +149,79 @@ bool getLangFromFile(char * rootDir)
   return success;
 }
 
-bool readConfigFile(const char * path, void (* lineParser)(), uint16_t maxLineLen)
+// FNV-1a hash of the first len chars of str
+static uint32_t keywordHash(const char * str, uint8_t len)
+{
+  uint32_t hash = 2166136261u;
+
+  while (len--)
+  {
+    hash = (hash ^ (uint8_t)*str++) * 16777619u;
+  }
+  return hash;
+}
+
+static void keywordIndexFree(void)
+{
+  memFree(keywordSlots);
+  keywordSlots = NULL;
+}
+
+// build the index of keywords, without index (out of memory) the lines are searched for each keyword
+static void keywordIndexInit(const char * const * keywords, uint16_t count)
+{
+  uint16_t size = 1;
+
+  while (size < count * 2)
+  {
+    size <<= 1;
+  }
+
+  keywordList = keywords;
+  keywordMask = size - 1;
+  keywordSlots = memCalloc(MEM_BOOT, size, sizeof(uint16_t));
+  if (keywordSlots == NULL)
+    return;
+
+  for (uint16_t i = 0; i < count; i++)
+  {
+    uint16_t slot = keywordHash(keywords[i], strlen(keywords[i])) & keywordMask;
+
+    while (keywordSlots[slot] != 0)  // linear probing
+    {
+      slot = (slot + 1) & keywordMask;
+    }
+    keywordSlots[slot] = i + 1;
+  }
+}
+
+// index of the keyword the line in buffer starts with, -1 if none (or no index)
+// on a match c_index is set after the keyword, like key_seen() does
+static int16_t keywordIndexFind(void)
+{
+  const char * colon;
+  uint8_t len;
+  uint16_t slot;
+
+  if (keywordSlots == NULL || (colon = strchr(cur_line, ':')) == NULL || colon - cur_line >= UINT8_MAX)
+    return -1;
+
+  len = colon - cur_line + 1;  // the keywords end with ':'
+  for (slot = keywordHash(cur_line, len) & keywordMask; keywordSlots[slot] != 0; slot = (slot + 1) & keywordMask)
+  {
+    const char * keyword = keywordList[keywordSlots[slot] - 1];
+
+    if (strncmp(keyword, cur_line, len) == 0 && keyword[len] == '\0')
+    {
+      c_index = len;
+      return keywordSlots[slot] - 1;
+    }
+  }
+  return -1;
+}
+
+// keywords: the keywords of lineParser, indexed for the time of the read
+bool readConfigFile(const char * path, void (* lineParser)(), uint16_t maxLineLen, const char * const * keywords, uint16_t keywordCount)
 {
   bool comment_mode = false;
   bool comment_space = true;
@@ -172,12 +251,15 @@ bool readConfigFile(const char * path, void (* lineParser)(), uint16_t maxLineLe
       return false;
     }
 
+    keywordIndexInit(keywords, keywordCount);
+
     configFile.cur = 0;
     for (; configFile.cur < configFile.size;)
     {
       if (f_read(&configFile.file, &cur_char, 1, &br) != FR_OK)
       {
         PRINTDEBUG("read error\n");
+        keywordIndexFree();
         return false;
       }
       configFile.cur++;
@@ -227,6 +309,7 @@ bool readConfigFile(const char * path, void (* lineParser)(), uint16_t maxLineLe
         }
       }
     }
+    keywordIndexFree();
     f_close(&configFile.file);
     configFile.cur = 0;
     configFile.size = 0;
@@ -357,16 +440,20 @@ static inline void config_set_color(uint16_t *color_src)
 // check keywords in the config line in buffer
 void parseConfigLine(void)
 {
-  for (uint16_t i = 0; i < CONFIG_COUNT; i++)
+  int16_t i = keywordIndexFind();
+
+  if (i < 0)  // the keyword isn't at the start of the line, search each one
   {
-    if (param_seen(config_keywords[i]))
-    {
-      PRINTDEBUG("\n");
-      PRINTDEBUG((char *)config_keywords[i]);
-      parseConfigKey(i);
-      foundkeys++;
-      return;
-    }
+    for (i = 0; i < CONFIG_COUNT && !param_seen(config_keywords[i]); i++);
+  }
+
+  if (i < CONFIG_COUNT)
+  {
+    PRINTDEBUG("\n");
+    PRINTDEBUG((char *)config_keywords[i]);
+    parseConfigKey(i);
+    foundkeys++;
+    return;
   }
   showError(CSTAT_UNKNOWN_KEYWORD);
 }
@@ -374,31 +461,35 @@ void parseConfigLine(void)
 // parse keywords from line read from language file
 void parseLangLine(void)
 {
-  for (int i = 0; i < LABEL_NUM; i++)
+  int16_t i = keywordIndexFind();
+
+  if (i < 0)  // the keyword isn't at the start of the line, search each one
   {
-    if (key_seen(lang_key_list[i]))
-    {
-      PRINTDEBUG("\n");
-      PRINTDEBUG((char *)lang_key_list[i]);
-      uint32_t key_addr = LANGUAGE_ADDR + (MAX_LANG_LABEL_LENGTH * i);
-      uint8_t * pchr = (uint8_t *)strchr(cur_line, ':') + 1;
-      int bytelen = strlen((char *)pchr);
+    for (i = 0; i < LABEL_NUM && !key_seen(lang_key_list[i]); i++);
+  }
 
-      if (inLimit(bytelen, 1, MAX_LANG_LABEL_LENGTH))
-      {
-        W25Qxx_WritePage(pchr, key_addr, MAX_LANG_LABEL_LENGTH);
-        char check[MAX_LANG_LABEL_LENGTH];
-        W25Qxx_ReadBuffer((uint8_t *)&check, key_addr, MAX_LANG_LABEL_LENGTH);
-        if (strcmp(strchr(cur_line, ':') + 1, check) != 0)
-          showError(CSTAT_SPI_WRITE_FAIL);
-      }
-      else
-      {
-        showError(CSTAT_INVALID_VALUE);
-      }
-      foundkeys++;
-      return;
+  if (i < LABEL_NUM)
+  {
+    PRINTDEBUG("\n");
+    PRINTDEBUG((char *)lang_key_list[i]);
+    uint32_t key_addr = LANGUAGE_ADDR + (MAX_LANG_LABEL_LENGTH * i);
+    uint8_t * pchr = (uint8_t *)strchr(cur_line, ':') + 1;
+    int bytelen = strlen((char *)pchr);
+
+    if (inLimit(bytelen, 1, MAX_LANG_LABEL_LENGTH))
+    {
+      W25Qxx_WritePage(pchr, key_addr, MAX_LANG_LABEL_LENGTH);
+      char check[MAX_LANG_LABEL_LENGTH];
+      W25Qxx_ReadBuffer((uint8_t *)&check, key_addr, MAX_LANG_LABEL_LENGTH);
+      if (strcmp(strchr(cur_line, ':') + 1, check) != 0)
+        showError(CSTAT_SPI_WRITE_FAIL);
     }
+    else
+    {
+      showError(CSTAT_INVALID_VALUE);
+    }
+    foundkeys++;
+    return;
   }
   showError(CSTAT_UNKNOWN_KEYWORD);
 }
@@ -223,7 +223,7 @@ typedef enum
 bool getConfigFromFile(char * configPath);
 bool getLangFromFile(char * rootDir);
 
-bool readConfigFile(const char * path, void (* lineParser)(), uint16_t maxLineLen);
+bool readConfigFile(const char * path, void (* lineParser)(), uint16_t maxLineLen, const char * const * keywords, uint16_t keywordCount);
 
 void parseConfigLine(void);
 void parseLangLine(void);
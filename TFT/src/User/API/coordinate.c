@@ -18,8 +18,6 @@ static bool relative_e = false;
 // false means current position is unknown
 // false after M18/M84 disable stepper or power up, true after G28
 static bool position_known = false;
-static bool coordinateQueryWait = false;
-static uint8_t curQuerySeconds = 0;
 
 bool coorGetRelative(void)
 {
@@ -108,49 +106,6 @@ void coordinateGetAllActual(COORDINATE *tmp)
   memcpy(tmp, &curPosition, sizeof(curPosition));
 }
 
-void coordinateQuerySetWait(bool wait)
-{
-  coordinateQueryWait = wait;
-}
-
-/**
- * @brief query gantry position.
- * @param seconds: Pass 0 to query manually or disable auto report. Pass delay in seconds
- *                 for auto query if available in marlin.
- */
-void coordinateQuery(uint8_t seconds)
-{
-  if (infoHost.connected == true && infoHost.wait == false && !coordinateQueryWait)
-  {
-    if (infoMachineSettings.autoReportPos == 1)  // if auto report is enabled
-    {
-      if (seconds == 0)  // if manual querying is requested (if query interval is 0)
-        coordinateQueryWait = storeCmd("M114\n");
-
-      if (seconds != curQuerySeconds)  // if query interval is changed
-      {
-        if (storeCmd("M154 S%d\n", seconds))  // turn on or off (if query interval is 0) auto report
-          curQuerySeconds = seconds;          // if gcode will be sent, avoid to enable auto report again on next
-      }                                       // function call if already enabled for that query interval
-    }
-    else  // if auto report is disabled
-    {
-      coordinateQueryWait = storeCmd("M114\n");
-    }
-  }
-}
-
-void coordinateQueryTurnOff(void)
-{
-  coordinateQueryWait = false;
-
-  if (infoMachineSettings.autoReportPos == 1)  // if auto report is enabled, turn it off
-  {
-    storeCmd("M154 S0\n");
-    curQuerySeconds = 0;
-  }
-}
-
 float coordinateGetAxis(AXIS axis)
 {
   if (infoFile.source >= FS_ONBOARD_MEDIA)
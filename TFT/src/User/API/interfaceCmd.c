@@ -3,11 +3,14 @@
 #include "RRFSendCmd.h"
 
 #define CMD_QUEUE_SIZE 20
+#define CMD_HASH_SIZE  32  // slots of the fingerprint set, a power of 2 larger than CMD_QUEUE_SIZE
+#define CMD_HASH_MASK  (CMD_HASH_SIZE - 1)
 
 typedef struct
 {
   CMD gcode;
   SERIAL_PORT_INDEX port_index;  // 0: for SERIAL_PORT, 1: for SERIAL_PORT_2 etc...
+  uint16_t fingerprint;          // hash of gcode (see cmdFingerprint()), only for infoCmd queue
 } GCODE_INFO;
 
 typedef struct
@@ -18,6 +21,14 @@ typedef struct
   uint8_t count;    // count of commands in the queue
 } GCODE_QUEUE;
 
+// slot of the fingerprint set of infoCmd queue (open addressing, linear probing)
+typedef struct
+{
+  uint16_t fingerprint;  // 0: free slot
+  uint8_t count;         // count of commands in the queue with this fingerprint
+  uint8_t index;         // queue position of the last of them
+} CMD_HASH_SLOT;
+
 typedef enum
 {
   NO_WRITING = 0,
@@ -36,6 +47,12 @@ uint8_t cmd_index;
 WRITING_MODE writing_mode = NO_WRITING;
 FIL file;
 
+static CMD_HASH_SLOT cmdHash[CMD_HASH_SIZE];  // commands in infoCmd queue, so isEnqueued() doesn't compare them all
+static uint32_t cmdDuplicates = 0;            // status queries not queued, the same query was already in the queue
+
+// status queries of the TFT, a second one in the queue would only bring the same reply
+static const char *const statusQueries[] = {"M105\n", "M114\n", "M27\n", "M220\n", "M221\n"};
+
 bool isFullCmdQueue(void)
 {
   return (infoCmd.count >= CMD_QUEUE_SIZE);
@@ -46,16 +63,126 @@ bool isNotEmptyCmdQueue(void)
   return (infoCmd.count != 0 || infoHost.wait == true);
 }
 
+// FNV-1a hash folded to 16 bits, never 0 (free slot)
+static uint16_t cmdFingerprint(const char * cmd)
+{
+  uint32_t hash = 2166136261UL;
+
+  for (uint8_t i = 0; i < CMD_MAX_SIZE && cmd[i] != '\0'; i++)
+  {
+    hash = (hash ^ (uint8_t)cmd[i]) * 16777619UL;
+  }
+
+  hash = (hash ^ (hash >> 16)) & 0xFFFF;
+
+  return hash != 0 ? hash : 1;
+}
+
+// slot of the fingerprint, or the free slot where it would be added
+static uint8_t cmdHashFind(uint16_t fingerprint)
+{
+  uint8_t i = fingerprint & CMD_HASH_MASK;
+
+  while (cmdHash[i].fingerprint != 0 && cmdHash[i].fingerprint != fingerprint)
+  {
+    i = (i + 1) & CMD_HASH_MASK;
+  }
+
+  return i;
+}
+
+static void cmdHashAdd(uint8_t index)
+{
+  uint16_t fingerprint = infoCmd.queue[index].fingerprint;
+  CMD_HASH_SLOT * slot = &cmdHash[cmdHashFind(fingerprint)];
+
+  slot->fingerprint = fingerprint;
+  slot->count++;
+  slot->index = index;
+}
+
+static void cmdHashRemove(uint16_t fingerprint)
+{
+  uint8_t i = cmdHashFind(fingerprint);
+
+  if (cmdHash[i].count == 0 || --cmdHash[i].count != 0)
+    return;
+
+  // free the slot, moving back the next entries of the run whose probe sequence crossed it
+  for (uint8_t j = (i + 1) & CMD_HASH_MASK; cmdHash[j].fingerprint != 0; j = (j + 1) & CMD_HASH_MASK)
+  {
+    uint8_t home = cmdHash[j].fingerprint & CMD_HASH_MASK;
+
+    if (((j - home) & CMD_HASH_MASK) >= ((j - i) & CMD_HASH_MASK))
+    {
+      cmdHash[i] = cmdHash[j];
+      i = j;
+    }
+  }
+
+  cmdHash[i].fingerprint = cmdHash[i].count = 0;
+}
+
+static bool cmdHashContains(const char * cmd, uint16_t fingerprint)
+{
+  const CMD_HASH_SLOT * slot = &cmdHash[cmdHashFind(fingerprint)];
+
+  if (slot->count == 0)
+    return false;
+
+  if (strcmp(cmd, infoCmd.queue[slot->index].gcode) == 0)
+    return true;
+
+  // another command with the same fingerprint, rare enough to afford comparing them all
+  for (uint8_t i = 0; i < infoCmd.count; i++)
+  {
+    if (strcmp(cmd, infoCmd.queue[(infoCmd.index_r + i) % CMD_QUEUE_SIZE].gcode) == 0)
+      return true;
+  }
+
+  return false;
+}
+
 bool isEnqueued(const CMD cmd)
 {
-  bool found = false;
+  return cmdHashContains(cmd, cmdFingerprint(cmd));
+}
+
+static bool isStatusQuery(const char * cmd)
+{
+  if (cmd[0] != 'M')
+    return false;
+
+  for (uint8_t i = 0; i < COUNT(statusQueries); i++)
+  {
+    if (strcmp(cmd, statusQueries[i]) == 0)
+      return true;
+  }
+
+  return false;
+}
+
+// Add the command written at the write position to the queue.
+// A status query of the TFT already in infoCmd queue is dropped, the queued one brings the same reply.
+static void commitCmd(GCODE_QUEUE * pQueue)
+{
+  GCODE_INFO * pInfo = &pQueue->queue[pQueue->index_w];
 
-  for (int i = 0; i < infoCmd.count && !found; ++i)
+  if (pQueue == &infoCmd)
   {
-    found = strcmp(cmd, infoCmd.queue[(infoCmd.index_r + i) % CMD_QUEUE_SIZE].gcode) == 0;
+    pInfo->fingerprint = cmdFingerprint(pInfo->gcode);
+
+    if (pInfo->port_index == PORT_1 && isStatusQuery(pInfo->gcode) && cmdHashContains(pInfo->gcode, pInfo->fingerprint))
+    {
+      cmdDuplicates++;
+      return;
+    }
+
+    cmdHashAdd(pQueue->index_w);
   }
 
-  return found;
+  pQueue->index_w = (pQueue->index_w + 1) % CMD_QUEUE_SIZE;
+  pQueue->count++;
 }
 
 bool isWritingMode(void)
@@ -69,13 +196,13 @@ void commonStoreCmd(GCODE_QUEUE * pQueue, const char * format, va_list va)
   vsnprintf(pQueue->queue[pQueue->index_w].gcode, CMD_MAX_SIZE, format, va);
 
   pQueue->queue[pQueue->index_w].port_index = PORT_1;  // port index for SERIAL_PORT
-  pQueue->index_w = (pQueue->index_w + 1) % CMD_QUEUE_SIZE;
-  pQueue->count++;
+  commitCmd(pQueue);
 }
 
 // Store gcode cmd to infoCmd queue.
 // This command will be sent to the printer by sendQueueCmd().
 // If the infoCmd queue is full, a reminder message is displayed and the command is discarded.
+// A status query already in the queue is not stored again (see commitCmd()).
 bool storeCmd(const char * format, ...)
 {
   if (format[0] == 0) return false;
@@ -161,8 +288,7 @@ bool storeCmdFromUART(SERIAL_PORT_INDEX portIndex, const CMD cmd)
   strncpy(infoCmd.queue[infoCmd.index_w].gcode, cmd, CMD_MAX_SIZE);
 
   infoCmd.queue[infoCmd.index_w].port_index = portIndex;
-  infoCmd.index_w = (infoCmd.index_w + 1) % CMD_QUEUE_SIZE;
-  infoCmd.count++;
+  commitCmd(&infoCmd);
 
   return true;
 }
@@ -202,8 +328,8 @@ void clearCmdQueue(void)
 {
   infoCmd.count = infoCmd.index_w = infoCmd.index_r = 0;
   infoCacheCmd.count = infoCacheCmd.index_w = infoCacheCmd.index_r = 0;
-  heatSetUpdateWaiting(false);
-  printSetUpdateWaiting(false);
+  memset(cmdHash, 0, sizeof(cmdHash));
+  telemetryClearPending();
 }
 
 static inline bool getCmd(void)
@@ -255,6 +381,7 @@ bool sendCmd(bool purge, bool avoidTerminal)
     terminalCache(cmd_ptr, cmd_len, cmd_port_index, SRC_TERMINAL_GCODE);
   }
 
+  cmdHashRemove(infoCmd.queue[infoCmd.index_r].fingerprint);
   infoCmd.count--;
   infoCmd.index_r = (infoCmd.index_r + 1) % CMD_QUEUE_SIZE;
 
@@ -440,6 +567,167 @@ void writeRemoteTFT()
   Serial_Puts(cmd_port, "ok\n");
 }
 
+// reply of a TFT debug command, to the terminal if the command was sent by the TFT, else to the originating host
+static void debugReply(bool fromTFT, const char * str)
+{
+  if (fromTFT)
+  {
+    if (MENU_IS(menuTerminal))
+      terminalCache(str, strlen(str), PORT_1, SRC_TERMINAL_ACK);
+  }
+  else
+  {
+    Serial_Puts(cmd_port, str);
+  }
+}
+
+// one line of the "M9999 P" table: runs, min/avg/max time and histogram (see OS_PROF_BUCKETS)
+static void debugProfReply(bool fromTFT, const char *name, const OS_PROF *prof)
+{
+  char buf[160];
+  int len;
+
+  len = sprintf(buf, "%-24s %8lu %6lu %6lu %7lu |", name, prof->count, OS_CyclesToUs(prof->min),
+                OS_CyclesToUs(prof->total / MAX(prof->count, 1)), OS_CyclesToUs(prof->max));
+
+  for (uint8_t i = 0; i < OS_PROF_BUCKETS; i++)
+  {
+    len += sprintf(buf + len, " %lu", prof->hist[i]);
+  }
+
+  strcpy(buf + len, "\n");
+  debugReply(fromTFT, buf);
+}
+
+// TFT debug and benchmark commands "M9999 <letter>", handled by the TFT and never sent to the printer
+static void debugCmd(bool fromTFT, char subCmd)
+{
+  char buf[100];
+
+  switch (subCmd)
+  {
+    case 'F':  // "M9999 F": W25Qxx SPI flash read throughput by CPU and by DMA
+    {
+      W25QXX_SPEED_TEST test;
+
+      W25Qxx_SpeedTest(&test, LOGO_ADDR, KB(64));
+      sprintf(buf, "W25Qxx read %lu bytes CPU: %lu us %lu kB/s DMA: %lu us %lu kB/s\n", test.bytes,
+              test.cpuTime, test.bytes * 1000 / MAX(test.cpuTime, 1), test.dmaTime, test.bytes * 1000 / MAX(test.dmaTime, 1));
+      debugReply(fromTFT, buf);
+      break;
+    }
+
+    case 'S':  // "M9999 S": SD card sequential read throughput by single and multiple sector reads, and random reads
+    {
+      SD_SPEED_TEST test;
+
+      if (isPrinting())
+      {
+        debugReply(fromTFT, "SD card busy printing\n");
+        break;
+      }
+
+      if (!testSDCardSpeed(&test))
+      {
+        debugReply(fromTFT, "SD card not mounted\n");
+        break;
+      }
+
+      sprintf(buf, "SD read %lu bytes 1 sector: %lu kB/s %u sectors: %lu kB/s\n", test.bytes,
+              test.bytes * 1000 / MAX(test.singleTime, 1), SD_SPEED_TEST_MULTI, test.bytes * 1000 / MAX(test.multiTime, 1));
+      debugReply(fromTFT, buf);
+      sprintf(buf, "SD random read %u sectors: %lu us/sector, errors: %u\n", SD_SPEED_TEST_RANDOM,
+              test.randomTime / SD_SPEED_TEST_RANDOM, test.errors);
+      debugReply(fromTFT, buf);
+      break;
+    }
+
+    case 'P':  // "M9999 P": time profile of the loop tasks and of the menu handlers since the previous report
+    {
+      const OS_PROF *prof;
+      FP_MENU menu;
+
+      debugReply(fromTFT, "task / menu                  runs  min us avg us  max us | <4 <16 <64 <256 <1k <4k <16k more us\n");
+
+      for (uint8_t i = 0; i < loopTaskCount(); i++)
+      {
+        debugProfReply(fromTFT, loopGetTask(i)->name, &loopGetTask(i)->prof);
+      }
+
+      for (uint8_t i = 0; i < PROF_MENU_COUNT; i++)
+      {
+        if ((prof = loopGetMenuProf(i, &menu)) == NULL)
+          continue;
+
+        sprintf(buf, "menu 0x%08lx", (uint32_t)(uintptr_t)menu);
+        debugProfReply(fromTFT, buf, prof);
+      }
+
+      loopTaskResetStats();
+      break;
+    }
+
+    case 'T':  // "M9999 T": run count, worst case time and budget overruns of the loop tasks since the previous report
+    {
+      for (uint8_t i = 0; i < loopTaskCount(); i++)
+      {
+        const OS_TASK *task = loopGetTask(i);
+
+        sprintf(buf, "%-24s P%u runs: %lu max: %lu us overruns: %lu\n", task->name, task->priority, task->prof.count,
+                OS_CyclesToUs(task->prof.max), task->overruns);
+        debugReply(fromTFT, buf);
+      }
+
+      sprintf(buf, "deferred: %lu CPU load: %u%%\n", loopTaskDeferred(), OS_GetCpuLoad());
+      debugReply(fromTFT, buf);
+      loopTaskResetStats();
+      break;
+    }
+
+    case 'M':  // "M9999 M": heap and stack use, heap blocks of each owner
+    {
+      HEAP_INFO heap;
+      STACK_INFO stack;
+
+      getHeapInfo(&heap);
+      getStackInfo(&stack);
+
+      sprintf(buf, "heap size: %lu used: %lu free: %lu tracked: %lu\n", heap.size, heap.used, heap.free, memTrackedBytes());
+      debugReply(fromTFT, buf);
+      sprintf(buf, "stack used: %lu reserved: %lu gap to heap: %lu\n", stack.used, stack.size, stack.gap);
+      debugReply(fromTFT, buf);
+
+      for (uint8_t i = 0; i < MEM_TAG_COUNT; i++)
+      {
+        const MEM_STATS *stats = memGetStats(i);
+
+        sprintf(buf, "%-8s used: %lu peak: %lu blocks: %u fails: %u overruns: %u\n", memTagName(i), stats->used,
+                stats->peak, stats->blocks, stats->fails, stats->overruns);
+        debugReply(fromTFT, buf);
+      }
+      break;
+    }
+
+    case 'Q':  // "M9999 Q": gcode queue use and status queries not queued as already in the queue
+      sprintf(buf, "queue: %u/%u cache: %u duplicates suppressed: %lu\n", infoCmd.count, CMD_QUEUE_SIZE,
+              infoCacheCmd.count, cmdDuplicates);
+      debugReply(fromTFT, buf);
+      break;
+
+    default:
+      debugReply(fromTFT, "M9999 F: W25Qxx read speed\n");
+      debugReply(fromTFT, "M9999 S: SD card read speed\n");
+      debugReply(fromTFT, "M9999 M: heap and stack use\n");
+      debugReply(fromTFT, "M9999 P: loop task and menu time profile\n");
+      debugReply(fromTFT, "M9999 T: loop task stats\n");
+      debugReply(fromTFT, "M9999 Q: gcode queue stats\n");
+      break;
+  }
+
+  if (!fromTFT)
+    Serial_Puts(cmd_port, "ok\n");
+}
+
 void setWaitHeating(uint8_t index)
 {
   if (cmd_seen('R'))
@@ -671,10 +959,6 @@ void sendQueueCmd(void)
                 return;
               }
             }
-            else
-            {
-              printSetUpdateWaiting(false);
-            }
             break;
 
           case 28:  // M28
@@ -757,12 +1041,7 @@ void sendQueueCmd(void)
               return;
             }
             break;
-
-        #else  // not SERIAL_PORT_2
-          case 27:  // M27
-            printSetUpdateWaiting(false);
-            break;
-        #endif  // not SERIAL_PORT_2
+        #endif  // SERIAL_PORT_2
 
         case 73:
           if (cmd_seen('P'))
@@ -817,15 +1096,13 @@ void sendQueueCmd(void)
 
           if (fromTFT)
           {
-            heatSetUpdateWaiting(false);
-
             if (cmd_value() == 105)  // if M105
             {
               avoid_terminal = !infoSettings.terminal_ack;
             }
             else  // if M155
             {
-              if (cmd_seen('S')) heatSyncUpdateSeconds(cmd_value());
+              if (cmd_seen('S')) telemetrySync(TELEMETRY_TEMP, cmd_value());
             }
           }
           break;
@@ -1211,6 +1488,19 @@ void sendQueueCmd(void)
           }
           break;
         }
+
+        case 9999:  // M9999 TFT debug commands
+        {
+          char * subCmd = &cmd_ptr[cmd_index];  // e.g. "M9999 F\n" -> "9999 F\n"
+
+          while (NUMERIC(*subCmd) || *subCmd == ' ') subCmd++;
+
+          char subCmdLetter = *subCmd;  // cmd_ptr buffer is released by sendCmd()
+
+          sendCmd(true, avoid_terminal);
+          debugCmd(fromTFT, subCmdLetter);
+          return;
+        }
       }
       break;  // end parsing M-codes
 
@@ -854,6 +854,45 @@ void menuDrawTitle(void)
   }
 }
 
+// report the flash images drawn for the current page and the time spent on them
+static inline void menuReportFrames(void)
+{
+  #if defined(SERIAL_DEBUG_ENABLED) && defined(SERIAL_DEBUG_PORT)
+    LCD_FRAME_STATS stats;
+
+    lcd_frame_wait();  // get the time of the whole page
+    lcd_frame_stats_get(&stats);
+    dbg_printf("menu %p: %lu frames, %lu fills in %lu us\n", (void *)infoMenu.menu[infoMenu.cur], stats.count, stats.fills, stats.time);
+  #endif
+}
+
+// load a label in the label cache, false if the cache had to be cleared for it
+static bool menuCacheLabel(const LABEL *label)
+{
+  return ((uintptr_t)label->index >= LABEL_NUM) || labelCacheLoad(label->index);  // the address of a string isn't cached
+}
+
+// load the labels of the page in the label cache, once more if the cache had to be cleared on the way,
+// so they are all kept together for the redraws of the menu. items or listItems is NULL
+static void menuCacheLabels(const LABEL *title, const ITEM *items, const LISTITEM *listItems)
+{
+  if (infoSettings.language != LANG_FLASH)
+    return;
+
+  for (uint8_t pass = 0; pass < 2; pass++)
+  {
+    bool kept = menuCacheLabel(title);
+
+    for (uint8_t i = 0; i < ITEM_PER_PAGE; i++)
+    {
+      kept &= menuCacheLabel((items != NULL) ? &items[i].label : &listItems[i].titlelabel);
+    }
+
+    if (kept)
+      break;
+  }
+}
+
 // Draw the entire interface
 void menuDrawPage(const MENUITEMS *menuItems)
 {
@@ -887,15 +926,25 @@ void menuDrawPage(const MENUITEMS *menuItems)
     curRect = (MENU_IS(menuStatus)) ? rect_of_keySS : rect_of_key;
   #endif
 
+  lcd_frame_stats_reset();
+  menuCacheLabels(&curMenuItems->title, curMenuItems->items, NULL);
   menuClearGaps();  // Use this function instead of GUI_Clear to eliminate the splash screen when clearing the screen.
   menuSetTitle(&curMenuItems->title);
 
+  // queue all the icons first, they are drawn by DMA (if available) while the backend keeps running
+  for (i = 0; i < ITEM_PER_PAGE; i++)
+  {
+    menuDrawIconOnly(&curMenuItems->items[i], i);
+  }
+
   for (i = 0; i < ITEM_PER_PAGE; i++)
   {
-    menuDrawItem(&curMenuItems->items[i], i);
     RAPID_PRINTING_COMM()  // perform backend printing loop between drawing icons to avoid printer idling
+    menuDrawIconText(&curMenuItems->items[i], i);
   }
 
+  menuReportFrames();
+
   #if LCD_ENCODER_SUPPORT
     encoderPosition = 0;
   #endif
@@ -910,6 +959,8 @@ void menuDrawListPage(const LISTITEMS *listItems)
   TSC_ReDrawIcon = itemDrawIconPress;
   curMenuRedrawHandle = NULL;
 
+  lcd_frame_stats_reset();
+  menuCacheLabels(&listItems->title, NULL, listItems->items);
   GUI_SetBkColor(infoSettings.title_bg_color);
   GUI_ClearRect(0, 0, LCD_WIDTH, TITLE_END_Y);
   GUI_SetBkColor(infoSettings.bg_color);
@@ -926,6 +977,8 @@ void menuDrawListPage(const LISTITEMS *listItems)
     RAPID_PRINTING_COMM()  // perform backend printing loop between drawing icons to avoid printer idling
   }
 
+  menuReportFrames();
+
   #if LCD_ENCODER_SUPPORT
     encoderPosition = 0;
   #endif
@@ -1241,114 +1294,339 @@ void loopCheckBackPress(void)
 
 #endif  // SMART_HOME
 
-// Non-UI background loop tasks
-void loopBackEnd(void)
-{
-  // Get gcode command from the file to be printed
-  loopPrintFromTFT();  // handle a print from TFT media, if any
+// Non-UI (loopBackEnd) and UI-related (loopFrontEnd) background loop tasks, run by priority with their period and budget
+#define LOOP_PASS_BUDGET      2000  // us of a pass before its OS_PRIO_LOW and OS_PRIO_UI tasks wait for the next one
+#define LOOP_SERIAL_BUDGET     500  // us
+#define LOOP_TASK_BUDGET      1000  // us
+#define LOOP_UI_BUDGET        3000  // us, front end tasks may draw
+
+#define LOOP_TASK_FUNC(func) static void func##Task(void *para) { (void)para; func(); }
+
+#define LOOP_TASK(func, prio, period, budget) \
+  {.time_ms = period, .task = func##Task, .is_exist = 1, .is_repeat = 1, .name = #func, .priority = prio, .budget_us = budget}
+
+LOOP_TASK_FUNC(loopPrintFromTFT)
+LOOP_TASK_FUNC(sendQueueCmd)
+LOOP_TASK_FUNC(parseACK)
+LOOP_TASK_FUNC(loopTelemetry)
+LOOP_TASK_FUNC(loopCheckHeater)
+LOOP_TASK_FUNC(loopFan)
+LOOP_TASK_FUNC(loopSpeed)
+LOOP_TASK_FUNC(rrfStatusQuery)
+LOOP_TASK_FUNC(loopVolumeSource)
+LOOP_TASK_FUNC(loopToast)
+LOOP_TASK_FUNC(loopReminderClear)
+LOOP_TASK_FUNC(loopVolumeReminderClear)
+LOOP_TASK_FUNC(loopBusySignClear)
+LOOP_TASK_FUNC(loopTemperatureStatus)
+LOOP_TASK_FUNC(loopPopup)
+LOOP_TASK_FUNC(memCheck)
+
+#ifdef HW_SPI_TOUCH
+  LOOP_TASK_FUNC(loopTouchScreen)
+#endif
 
-  // Parse and send gcode commands in the queue
-  sendQueueCmd();
+#ifdef SERIAL_PORT_2
+  LOOP_TASK_FUNC(parseRcvGcode)
+#endif
 
-  // Parse the received slave response information
-  parseACK();
+#ifdef BUZZER_PIN
+  LOOP_TASK_FUNC(loopBuzzer)
+#endif
 
-  if (GET_BIT(infoSettings.general_settings, INDEX_FILE_COMMENT_PARSING) == 1)  // if file comment parsing is enabled
-  {
-    parseComment();  // Parse comment from gcode file
-  }
+#ifdef USB_FLASH_DRIVE_SUPPORT
+  LOOP_TASK_FUNC(USB_LoopProcess)
+#endif
 
-  #ifdef SERIAL_PORT_2
-    // Parse the received gcode from other UART, such as ESP3D etc...
-    parseRcvGcode();
-  #endif
+#ifdef FIL_RUNOUT_PIN
+  LOOP_TASK_FUNC(FIL_BE_CheckRunout)
+  LOOP_TASK_FUNC(FIL_FE_CheckRunout)
+#endif
 
-  // Temperature monitor
-  loopCheckHeater();
-  // Fan speed monitor
-  loopFan();
-  // Speed & flow monitor
-  loopSpeed();
+#ifdef HAS_EMULATOR
+  LOOP_TASK_FUNC(Mode_CheckSwitching)
+#endif
 
-  #ifdef BUZZER_PIN
-    // Buzzer handling
-    loopBuzzer();
-  #endif
+#ifdef SCREEN_SHOT_TO_SD
+  LOOP_TASK_FUNC(loopScreenShot)
+#endif
 
-  if (infoMachineSettings.onboardSD == ENABLED)
-  {
-    loopPrintFromOnboard();  // handle a print from (remote) onboard media, if any
-  }
+#ifdef SMART_HOME
+  LOOP_TASK_FUNC(loopCheckBackPress)
+#endif
 
-  #ifdef USB_FLASH_DRIVE_SUPPORT
-    USB_LoopProcess();
-  #endif
+#ifdef LCD_LED_PWM_CHANNEL
+  LOOP_TASK_FUNC(LCD_CheckDimming)
+#endif
 
-  #ifdef FIL_RUNOUT_PIN
-    FIL_BE_CheckRunout();
-  #endif
+static void parseCommentTask(void *para)
+{
+  if (GET_BIT(infoSettings.general_settings, INDEX_FILE_COMMENT_PARSING) == 1)  // if file comment parsing is enabled
+    parseComment();  // Parse comment from gcode file
+}
 
-  #if LCD_ENCODER_SUPPORT
+#if LCD_ENCODER_SUPPORT
+  static void LCD_Enc_CheckStepsTask(void *para)
+  {
     #ifdef HAS_EMULATOR
       if (MENU_IS_NOT(menuMarlinMode))
     #endif
     {
       LCD_Enc_CheckSteps();  // check change in encoder steps
     }
-  #endif
+  }
+#endif
 
-  #ifdef HAS_EMULATOR
-    Mode_CheckSwitching();
-  #endif
+static void LED_CheckEventTask(void *para)
+{
+  if (GET_BIT(infoSettings.general_settings, INDEX_EVENT_LED) == 1)
+    LED_CheckEvent();
+}
 
-  #ifdef SCREEN_SHOT_TO_SD
-    loopScreenShot();
+static OS_TASK loopTasks[] = {
+  // Parse the responses and the gcode received from the other UARTs (ESP3D etc...), then get the gcode from the
+  // file to be printed and send the queued gcode commands: the command following an "ok" is sent in the same pass
+  LOOP_TASK(parseACK,                OS_PRIO_SERIAL,   0, LOOP_SERIAL_BUDGET),
+  #ifdef SERIAL_PORT_2
+    LOOP_TASK(parseRcvGcode,         OS_PRIO_SERIAL,   0, LOOP_SERIAL_BUDGET),
   #endif
+  LOOP_TASK(loopPrintFromTFT,        OS_PRIO_SERIAL,   0, LOOP_SERIAL_BUDGET),
+  LOOP_TASK(sendQueueCmd,            OS_PRIO_SERIAL,   0, LOOP_SERIAL_BUDGET),
 
+  #ifdef HW_SPI_TOUCH
+    // Touch panel sampling on the boards sharing its SPI with the W25Qxx, sampled in PendSV_Handler() on the others
+    LOOP_TASK(loopTouchScreen,       OS_PRIO_HIGH,     0, LOOP_TASK_BUDGET),
+  #endif
+  LOOP_TASK(parseComment,            OS_PRIO_HIGH,     0, LOOP_TASK_BUDGET),
+  // Printer state queries and auto reports, temperature, fan speed, speed & flow monitors
+  LOOP_TASK(loopTelemetry,           OS_PRIO_HIGH,     0, LOOP_TASK_BUDGET),
+  LOOP_TASK(loopCheckHeater,         OS_PRIO_HIGH,     0, LOOP_TASK_BUDGET),
+  LOOP_TASK(loopFan,                 OS_PRIO_HIGH,     0, LOOP_TASK_BUDGET),
+  LOOP_TASK(loopSpeed,               OS_PRIO_HIGH,     0, LOOP_TASK_BUDGET),
+  #ifdef BUZZER_PIN
+    LOOP_TASK(loopBuzzer,            OS_PRIO_HIGH,     0, LOOP_TASK_BUDGET),
+  #endif
+  #ifdef USB_FLASH_DRIVE_SUPPORT
+    LOOP_TASK(USB_LoopProcess,       OS_PRIO_HIGH,     0, LOOP_TASK_BUDGET),
+  #endif
+  #ifdef FIL_RUNOUT_PIN
+    LOOP_TASK(FIL_BE_CheckRunout,    OS_PRIO_HIGH,     0, LOOP_TASK_BUDGET),
+  #endif
+  #if LCD_ENCODER_SUPPORT
+    LOOP_TASK(LCD_Enc_CheckSteps,    OS_PRIO_HIGH,     0, LOOP_TASK_BUDGET),
+  #endif
+  #ifdef HAS_EMULATOR
+    LOOP_TASK(Mode_CheckSwitching,   OS_PRIO_HIGH,     0, LOOP_TASK_BUDGET),
+  #endif
   #ifdef SMART_HOME
     // check if Back is pressed and held
-    loopCheckBackPress();
+    LOOP_TASK(loopCheckBackPress,    OS_PRIO_HIGH,     0, LOOP_TASK_BUDGET),
   #endif
+  // Query RRF status
+  LOOP_TASK(rrfStatusQuery,          OS_PRIO_HIGH,     0, LOOP_TASK_BUDGET),
 
+  #ifdef SCREEN_SHOT_TO_SD
+    LOOP_TASK(loopScreenShot,        OS_PRIO_LOW,      0, LOOP_TASK_BUDGET),
+  #endif
   #ifdef LCD_LED_PWM_CHANNEL
-    LCD_CheckDimming();
+    LOOP_TASK(LCD_CheckDimming,      OS_PRIO_LOW,      0, LOOP_TASK_BUDGET),
   #endif
+  LOOP_TASK(LED_CheckEvent,          OS_PRIO_LOW,    100, LOOP_TASK_BUDGET),
+  // Heap failures and overruns, stack close to the heap
+  LOOP_TASK(memCheck,                OS_PRIO_LOW,   1000, LOOP_TASK_BUDGET),
 
-  if (GET_BIT(infoSettings.general_settings, INDEX_EVENT_LED) == 1)
-    LED_CheckEvent();
-
-  // Query RRF status
-  rrfStatusQuery();
-}
-
-// UI-related background loop tasks
-void loopFrontEnd(void)
-{
+  // UI-related background loop tasks
   // Check if volume source (SD/USB) insert
-  loopVolumeSource();
+  LOOP_TASK(loopVolumeSource,        OS_PRIO_UI,     100, LOOP_UI_BUDGET),
   // Loop to check and run toast messages
-  loopToast();
+  LOOP_TASK(loopToast,               OS_PRIO_UI,       0, LOOP_UI_BUDGET),
   // If there is a message in the status bar, timed clear
-  loopReminderClear();
-  loopVolumeReminderClear();
+  LOOP_TASK(loopReminderClear,       OS_PRIO_UI,       0, LOOP_UI_BUDGET),
+  LOOP_TASK(loopVolumeReminderClear, OS_PRIO_UI,       0, LOOP_UI_BUDGET),
   // Busy Indicator clear
-  loopBusySignClear();
+  LOOP_TASK(loopBusySignClear,       OS_PRIO_UI,       0, LOOP_UI_BUDGET),
   // Check update temperature status
-  loopTemperatureStatus();
-
+  LOOP_TASK(loopTemperatureStatus,   OS_PRIO_UI,       0, LOOP_UI_BUDGET),
   #ifdef FIL_RUNOUT_PIN
     // Loop for filament runout detection
-    FIL_FE_CheckRunout();
+    LOOP_TASK(FIL_FE_CheckRunout,    OS_PRIO_UI,       0, LOOP_UI_BUDGET),
   #endif
-
   // Loop for popup menu
-  loopPopup();
+  LOOP_TASK(loopPopup,               OS_PRIO_UI,       0, LOOP_UI_BUDGET),
+};
+
+static OS_SCHED loopSched = {loopTasks, COUNT(loopTasks), true, LOOP_PASS_BUDGET, 0};
+
+// profiles of the menu handlers: the time they run between two calls to loopBackEnd(), without the loop tasks.
+// Once PROF_MENU_COUNT menus are profiled, the least run one is replaced by a new one
+static struct
+{
+  FP_MENU menu;
+  OS_PROF prof;
+} profMenus[PROF_MENU_COUNT];
+
+static uint32_t profMenuStart;   // cycles when the loop tasks gave back the CPU to the menu
+static uint32_t profMenuCycles;  // cycles run by the menu since its last loopBackEnd()
+static uint8_t profDepth = 0;    // loop tasks running the loop tasks (e.g. loopProcessToCondition())
+static bool profMenuRunning = false;
+
+static void profMenuPause(bool sample)
+{
+  if (profDepth++ != 0 || !profMenuRunning)
+    return;
+
+  profMenuCycles += OS_GetCycles() - profMenuStart;
+
+  if (sample)
+  {
+    FP_MENU menu = infoMenu.menu[infoMenu.cur];
+    uint8_t slot = 0;
+
+    for (uint8_t i = 0; i < PROF_MENU_COUNT; i++)
+    {
+      if (profMenus[i].menu == menu)
+      {
+        slot = i;
+        break;
+      }
+
+      if (profMenus[i].prof.count < profMenus[slot].prof.count)
+        slot = i;
+    }
+
+    if (profMenus[slot].menu != menu)
+    {
+      profMenus[slot].menu = menu;
+      OS_ProfReset(&profMenus[slot].prof);
+    }
+
+    OS_ProfAdd(&profMenus[slot].prof, profMenuCycles);
+    profMenuCycles = 0;
+  }
+}
+
+static void profMenuResume(void)
+{
+  if (--profDepth != 0)
+    return;
+
+  profMenuStart = OS_GetCycles();
+  profMenuRunning = true;
+}
+
+uint8_t loopTaskCount(void)
+{
+  return loopSched.count;
+}
+
+const OS_TASK *loopGetTask(uint8_t index)
+{
+  return &loopSched.tasks[index];
+}
+
+uint32_t loopTaskDeferred(void)
+{
+  return loopSched.deferred;
+}
+
+// return the profile of the menu in the given slot, NULL if none
+const OS_PROF *loopGetMenuProf(uint8_t index, FP_MENU *menu)
+{
+  if (index >= PROF_MENU_COUNT || profMenus[index].menu == NULL)
+    return NULL;
+
+  *menu = profMenus[index].menu;
+  return &profMenus[index].prof;
+}
+
+void loopTaskResetStats(void)
+{
+  OS_SchedResetStats(&loopSched);
+  memset(profMenus, 0, sizeof(profMenus));
+}
+
+// the host communication doesn't wait for the UI: with interleave set, it is also run after each low priority and UI task
+void loopBackEnd(void)
+{
+  profMenuPause(true);
+  OS_SchedRun(&loopSched, OS_PRIO_SERIAL, OS_PRIO_LOW);
+  profMenuResume();
+}
+
+void loopFrontEnd(void)
+{
+  profMenuPause(false);
+  OS_SchedRun(&loopSched, OS_PRIO_UI, OS_PRIO_UI);
+  profMenuResume();
+}
+
+#if LCD_ENCODER_SUPPORT
+  #define LOOP_IDLE_ENCODER_TIME 1000  // ms, the encoder is polled by the loop tasks, no sleep while it is used
+
+  static uint32_t encoderActiveTime = 0;
+#endif
+
+// nothing to do for the loop tasks until an interrupt, called with the interrupts disabled
+static uint8_t loopIsIdle(void)
+{
+  if (Serial_LineCount(SERIAL_PORT) != 0)  // response to parse
+    return false;
+
+  #ifdef SERIAL_PORT_2
+    for (SERIAL_PORT_INDEX i = PORT_2; i < SERIAL_PORT_COUNT; i++)  // gcode to forward, see parseRcvGcode()
+    {
+      if (infoSettings.serial_port[i] > 0 && Serial_LineCount(serialPort[i].port) != 0
+          #ifdef SERIAL_DEBUG_PORT
+            && serialPort[i].port != SERIAL_DEBUG_PORT
+          #endif
+          )
+        return false;
+    }
+  #endif
+
+  if (isNotEmptyCmdQueue() ? !infoHost.wait : (isTFTPrinting() && !isPaused()))  // gcode to send or to read from the file
+    return false;
+
+  if (TS_IsEventPending())
+    return false;
+
+  #if LCD_ENCODER_SUPPORT
+    if (OS_GetTimeMs() - encoderActiveTime < LOOP_IDLE_ENCODER_TIME)
+      return false;
+  #endif
+
+  return true;
+}
+
+// idle governor: sleep until the next interrupt when the loop tasks have nothing to do.
+// Most loop tasks poll on every pass, so the CPU sleeps up to the next 1 ms tick
+void loopIdle(void)
+{
+  #if LCD_ENCODER_SUPPORT
+    static uint8_t encoderLastPos = 0;
+    uint8_t pos = LCD_Enc_ReadPos();
+
+    if (pos != encoderLastPos)
+    {
+      encoderLastPos = pos;
+      encoderActiveTime = OS_GetTimeMs();
+    }
+  #endif
+
+  profMenuPause(false);
+  OS_Idle(loopIsIdle);
+  profMenuResume();
 }
 
 void loopProcess(void)
 {
   loopBackEnd();
   loopFrontEnd();
+  loopIdle();
+
+  #ifdef NATIVE_HOST
+    NATIVE_LoopProcess();  // headless menu capture of the native build
+  #endif
 }
 
 void menuDummy(void)
@@ -8,6 +8,8 @@ extern "C" {
 #include <stdbool.h>
 #include <stdint.h>
 #include "GUI.h"
+#include "main.h"  // for FP_MENU
+#include "os_timer.h"
 
 #define IDLE_TOUCH 0xFFFF
 
@@ -85,9 +87,11 @@ typedef enum
   MENU_TYPE_OTHER,
 } MENU_TYPE;
 
+// index is as wide as address (on the 64 bit native build too), so setting either one sets the whole label
+// and a string address is never mistaken for a language index
 typedef union
 {
-  int32_t index;  // language index, address = textSelect(index);
+  intptr_t index;  // language index, address = textSelect(index);
   void *address;
 } LABEL;
 
@@ -220,9 +224,17 @@ KEY_VALUES menuKeyGetValue(void);
   void loopCheckBackPress(void);
 #endif
 
+#define PROF_MENU_COUNT 8  // menu handlers profiled at once
+
 void menuDummy(void);
+uint8_t loopTaskCount(void);
+const OS_TASK *loopGetTask(uint8_t index);
+uint32_t loopTaskDeferred(void);
+const OS_PROF *loopGetMenuProf(uint8_t index, FP_MENU *menu);
+void loopTaskResetStats(void);
 void loopBackEnd(void);
 void loopFrontEnd(void);
+void loopIdle(void);
 void loopProcess(void);
 void loopProcessToCondition(CONDITION_CALLBACK condCallback);
 
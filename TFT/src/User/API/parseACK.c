@@ -76,34 +76,37 @@ void setCurrentAckSrc(SERIAL_PORT_INDEX portIndex)
 
 bool syncL2CacheFromL1(uint8_t port)
 {
-  if (infoHost.rx_ok[port] != true)  // if no data to read from L1 cache
+  if (Serial_LineCount(port) == 0)  // if no complete line to read from L1 cache
     return false;
 
   DMA_CIRCULAR_BUFFER * dmaL1Data_ptr = &dmaL1Data[port];  // make access to most used variables/attributes faster and also reducing the code
   uint16_t * rIndex_ptr = &dmaL1Data_ptr->rIndex;          // make access to most used variables/attributes faster and also reducing the code
-  uint16_t * wIndex_ptr = &dmaL1Data_ptr->wIndex;          // make access to most used variables/attributes faster and also reducing the code
+  uint16_t wIndex = dmaL1Data_ptr->wIndex;                 // data received after this point is read on the next call
 
-  while (dmaL1Data_ptr->cache[*rIndex_ptr] == ' ' && *rIndex_ptr != *wIndex_ptr)  // remove leading empty space
+  while (dmaL1Data_ptr->cache[*rIndex_ptr] == ' ' && *rIndex_ptr != wIndex)  // remove leading empty space
   {
     *rIndex_ptr = (*rIndex_ptr + 1) % dmaL1Data_ptr->cacheSize;
   }
 
-  if (*rIndex_ptr == *wIndex_ptr)  // if L1 cache is empty
+  if (*rIndex_ptr == wIndex)  // if L1 cache is empty
   {
-    infoHost.rx_ok[port] = false;  // mark the port as containing no more data
+    dmaL1Data_ptr->lineOut = dmaL1Data_ptr->lineIn;  // the lines lost by an overrun of the L1 cache can't be read
 
     return false;
   }
 
   uint16_t i = 0;
 
-  while (i < (L2_CACHE_SIZE - 1) && *rIndex_ptr != *wIndex_ptr)  // retrieve data at most until L2 cache is full or L1 cache is empty
+  while (i < (L2_CACHE_SIZE - 1) && *rIndex_ptr != wIndex)  // retrieve data at most until L2 cache is full or L1 cache is empty
   {
     dmaL2Cache[i] = dmaL1Data_ptr->cache[*rIndex_ptr];
     *rIndex_ptr = (*rIndex_ptr + 1) % dmaL1Data_ptr->cacheSize;
 
     if (dmaL2Cache[i++] == '\n')  // if data end marker is found, exit from the loop
+    {
+      dmaL1Data_ptr->lineOut++;
       break;
+    }
   }
 
   dmaL2Cache_len = i;  // length of data in the cache
@@ -430,13 +433,12 @@ void parseACK(void)
       if (ack_seen(heaterID[BED])) infoSettings.bed_en = ENABLED;
       if (ack_seen(heaterID[CHAMBER])) infoSettings.chamber_en = ENABLED;
 
-      updateNextHeatCheckTime();
+      telemetryReceived(TELEMETRY_TEMP);
 
       if (!ack_seen("@"))  // it's RepRapFirmware
       {
         storeCmd("M92\n");
         storeCmd("M115\n");  // as last command to identify the FW type!
-        coordinateQuerySetWait(true);
       }
       else if (infoMachineSettings.firmwareType == FW_NOT_DETECTED)  // if never connected to the printer since boot
       {
@@ -591,7 +593,7 @@ void parseACK(void)
       }
 
       avoid_terminal = !infoSettings.terminal_ack;
-      updateNextHeatCheckTime();
+      telemetryReceived(TELEMETRY_TEMP);
     }
     // parse and store M114, current position
     else if (ack_starts_with("X:") || ack_seen("C: X:"))  // Smoothieware axis position starts with "C: X:"
@@ -611,7 +613,7 @@ void parseACK(void)
         }
       }
 
-      coordinateQuerySetWait(false);
+      telemetryReceived(TELEMETRY_POS);
     }
     // parse and store M114 E, extruder position. Required "M114_DETAIL" in Marlin
     else if (ack_seen("Count E:"))
@@ -622,25 +624,25 @@ void parseACK(void)
     else if (ack_seen("FR:"))
     {
       speedSetCurPercent(0, ack_value());
-      speedQuerySetWait(false);
+      telemetryReceived(TELEMETRY_SPEED);
     }
     // parse and store flow rate percentage
     else if (ack_seen("Flow: "))
     {
       speedSetCurPercent(1, ack_value());
-      speedQuerySetWait(false);
+      telemetryReceived(TELEMETRY_SPEED);
     }
     // parse and store feed rate percentage in case of Smoothieware
     else if ((infoMachineSettings.firmwareType == FW_SMOOTHIEWARE) && ack_seen("Speed factor at "))
     {
       speedSetCurPercent(0, ack_value());
-      speedQuerySetWait(false);
+      telemetryReceived(TELEMETRY_SPEED);
     }
     // parse and store flow rate percentage in case of Smoothieware
     else if ((infoMachineSettings.firmwareType == FW_SMOOTHIEWARE) && ack_seen("Flow rate at "))
     {
       speedSetCurPercent(1, ack_value());
-      speedQuerySetWait(false);
+      telemetryReceived(TELEMETRY_SPEED);
     }
     // parse and store M106, fan speed
     else if (ack_starts_with("M106 P"))
@@ -656,7 +658,7 @@ void parseACK(void)
       if (ack_seen("S")) fanSetCurSpeed(MAX_COOLING_FAN_COUNT, ack_value());
       if (ack_seen("I")) fanSetCurSpeed(MAX_COOLING_FAN_COUNT + 1, ack_value());
 
-      ctrlFanQuerySetWait(false);
+      telemetryReceived(TELEMETRY_CTRL_FAN);
     }
     // parse pause message
     else if (!infoMachineSettings.promptSupport && ack_seen("paused for user"))
@@ -705,6 +707,8 @@ void parseACK(void)
       // parse and store M27
       if (ack_seen("SD printing"))  // received "SD printing byte" or "Not SD printing"
       {
+        telemetryReceived(TELEMETRY_PRINT);
+
         if (infoHost.status == HOST_STATUS_RESUMING)
           setPrintResume(HOST_STATUS_PRINTING);
 
@@ -1162,10 +1166,7 @@ void parseACK(void)
       }
       else if (ack_continue_seen("AUTOREPORT_TEMP:"))
       {
-        infoMachineSettings.autoReportTemp = ack_value();
-
-        if (infoMachineSettings.autoReportTemp)
-          storeCmd("M155 S%u\n", heatGetUpdateSeconds());
+        infoMachineSettings.autoReportTemp = ack_value();  // M155 is then sent by loopTelemetry()
       }
       else if (ack_continue_seen("AUTOREPORT_POS:"))
       {
@@ -197,6 +197,10 @@ DRESULT disk_ioctl(
   switch (pdrv)
   {
     case DEV_MMC:
+      #ifdef NATIVE_HOST  // for f_mkfs(), formatting the SD card image
+        if (cmd == GET_SECTOR_COUNT)
+          *(LBA_t *)buff = NATIVE_SDCARD_SECTORS;
+      #endif
       return RES_OK;
 
     case DEV_USB:
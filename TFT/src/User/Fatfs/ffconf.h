@@ -38,7 +38,11 @@
 /* This option switches filtered directory read functions, f_findfirst() and
 /  f_findnext(). (0:Disable, 1:Enable 2:Enable with matching altname[] too) */
 
-#define FF_USE_MKFS     0
+#ifdef NATIVE_HOST
+  #define FF_USE_MKFS   1  // the native build formats its SD card image
+#else
+  #define FF_USE_MKFS   0
+#endif
 /* This option switches f_mkfs() function. (0:Disable or 1:Enable) */
 
 #define FF_USE_FASTSEEK 0
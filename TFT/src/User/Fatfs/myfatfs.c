@@ -60,6 +60,54 @@ bool mountUSBDisk(void)
   return (f_mount(&fatfs[VOLUMES_USB_DISK], USB_ROOT_DIR, 1) == FR_OK);
 }
 
+/**
+ * read the mounted SD card sequentially by single then multiple sector reads
+ * and at random places of its data area, for the throughput of the card and its driver
+ * false: SD card not mounted or out of memory
+ */
+bool testSDCardSpeed(SD_SPEED_TEST *test)
+{
+  FATFS *fs = &fatfs[VOLUMES_SD_CARD];
+  uint32_t dataSize, seed = 1;
+  uint32_t start;
+  uint8_t *buf;
+
+  if (fs->fs_type == 0 || (disk_status(fs->pdrv) & STA_NOINIT))
+    return false;
+
+  dataSize = (fs->n_fatent - 2) * fs->csize;
+  if (dataSize < SD_SPEED_TEST_SECTORS || (buf = memAlloc(MEM_FATFS, SD_SPEED_TEST_MULTI * FF_MIN_SS)) == NULL)
+    return false;
+
+  test->bytes = SD_SPEED_TEST_SECTORS * FF_MIN_SS;
+  test->errors = 0;
+
+  start = OS_GetTimeUs();
+  for (uint32_t i = 0; i < SD_SPEED_TEST_SECTORS; i++)
+  {
+    test->errors += (disk_read(fs->pdrv, buf, fs->database + i, 1) != RES_OK);
+  }
+  test->singleTime = OS_GetTimeUs() - start;
+
+  start = OS_GetTimeUs();
+  for (uint32_t i = 0; i < SD_SPEED_TEST_SECTORS; i += SD_SPEED_TEST_MULTI)
+  {
+    test->errors += (disk_read(fs->pdrv, buf, fs->database + i, SD_SPEED_TEST_MULTI) != RES_OK);
+  }
+  test->multiTime = OS_GetTimeUs() - start;
+
+  start = OS_GetTimeUs();
+  for (uint32_t i = 0; i < SD_SPEED_TEST_RANDOM; i++)
+  {
+    seed = seed * 1103515245 + 12345;  // same sequence each time, the results can be compared
+    test->errors += (disk_read(fs->pdrv, buf, fs->database + (seed >> 8) % dataSize, 1) != RES_OK);
+  }
+  test->randomTime = OS_GetTimeUs() - start;
+
+  memFree(buf);
+  return true;
+}
+
 /**
  * scanf gcode file in current path
  * true: scanf ok
@@ -93,7 +141,7 @@ bool scanPrintFilesFatFs(void)
       if (infoFile.folderCount >= FOLDER_NUM)
         continue;
 
-      infoFile.folder[infoFile.folderCount] = malloc(len);
+      infoFile.folder[infoFile.folderCount] = allocInfoFileName(len);
       if (infoFile.folder[infoFile.folderCount] == NULL)
         break;
 
@@ -112,7 +160,7 @@ bool scanPrintFilesFatFs(void)
       if (isSupportedFile(finfo.fname) == NULL)  // if filename doesn't provide a supported filename extension
         continue;
 
-      infoFile.file[infoFile.fileCount] = malloc(len + 1);  // plus one extra byte for filename extension check
+      infoFile.file[infoFile.fileCount] = allocInfoFileName(len + 1);  // plus one extra byte for filename extension check
       if (infoFile.file[infoFile.fileCount] == NULL)
         break;
 
@@ -200,7 +248,7 @@ bool Get_NewestGcode(const TCHAR* path)
 
     if ((finfo.fattrib & AM_DIR) == AM_DIR)
     {
-      char *nextdirpath = malloc(len + strlen(finfo.fname) + 2);
+      char *nextdirpath = memAlloc(MEM_FILES, len + strlen(finfo.fname) + 2);
       if (nextdirpath == NULL)
         break;
 
@@ -209,7 +257,7 @@ bool Get_NewestGcode(const TCHAR* path)
       strcat(nextdirpath, finfo.fname);
 
       status |= Get_NewestGcode(nextdirpath);
-      free(nextdirpath);
+      memFree(nextdirpath);
       nextdirpath = NULL;
     }
     else
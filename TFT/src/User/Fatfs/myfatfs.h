@@ -6,9 +6,24 @@ extern "C" {
 #endif
 
 #include <stdbool.h>
+#include <stdint.h>
+
+#define SD_SPEED_TEST_SECTORS 1024  // sectors read sequentially with each method (512 KB)
+#define SD_SPEED_TEST_MULTI   8     // sectors per read of the multiple sector reads
+#define SD_SPEED_TEST_RANDOM  256   // single sector reads at random places
+
+typedef struct
+{
+  uint32_t bytes;       // bytes read sequentially with each method
+  uint32_t singleTime;  // time in us of the sequential reads of 1 sector
+  uint32_t multiTime;   // time in us of the sequential reads of SD_SPEED_TEST_MULTI sectors
+  uint32_t randomTime;  // time in us of the SD_SPEED_TEST_RANDOM random reads
+  uint16_t errors;      // failed reads
+} SD_SPEED_TEST;
 
 bool mountSDCard(void);
 bool mountUSBDisk(void);
+bool testSDCardSpeed(SD_SPEED_TEST *test);
 bool scanPrintFilesFatFs(void);
 
 bool f_file_exists(const char* path);
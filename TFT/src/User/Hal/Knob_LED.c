@@ -4,86 +4,335 @@
 
 #ifdef KNOB_LED_COLOR_PIN
 
-uint32_t frameTimeStamp = 0;  // Frame unit need > 280us for WS2812
+// The WS2812 frames are sent by the PWM of a timer channel on the LED pin (PC7: TIM8_CH2).
+// At each timer update a DMA request loads the duty cycle of the next bit from a small circular buffer,
+// refilled by the DMA half and full transfer interrupts, so frames of any length are sent with interrupts enabled.
 
-// total 2.5us, run in 400Khz
-#define NEOPIXEL_T0H_US 0.35  // Neopixel code 0 high level hold time in us
-#define NEOPIXEL_T1H_US 2.15  // Neopixel code 1 high level hold time in us
+#define NEOPIXEL_PERIOD_US 1.25  // bit period, run in 800Khz
+#define NEOPIXEL_T0H_US    0.4   // Neopixel code 0 high level hold time in us
+#define NEOPIXEL_T1H_US    0.8   // Neopixel code 1 high level hold time in us
+#define NEOPIXEL_LATCH_US  300   // low level time between frames, need > 280us for WS2812
+
+#define NEOPIXEL_BUFFER_PIXELS 8  // pixels in the DMA buffer, half of them are encoded by each interrupt
+#define NEOPIXEL_BUFFER_SIZE   (NEOPIXEL_BUFFER_PIXELS * 24)
+#define NEOPIXEL_HALF_SIZE     (NEOPIXEL_BUFFER_SIZE / 2)
+#define NEOPIXEL_TIMEOUT_MS    5  // margin on the time of a frame before it is stopped (e.g. on a DMA fault)
 
 #ifdef GD32F2XX
-  #define NEOPIXEL_TIMER_CLOCK_ENABLE() rcu_periph_clock_enable(RCU_TIMER5)
-  #define NEOPIXEL_TIMER_CNT() TIMER_CNT(TIMER5)
-  #define NEOPIXEL_TIMER_PSC() TIMER_PSC(TIMER5)
-  #define NEOPIXEL_TIMER_ARR() TIMER_CAR(TIMER5)
-  #define NEOPIXEL_TIMER_SR()  TIMER_INTF(TIMER5)
-  #define NEOPIXEL_TIMER_CR1() TIMER_CTL0(TIMER5)
+  // TIMER7_CH1 is the default function of PC7, its DMA request is on DMA1 channel 4
+  #define NEOPIXEL_TIMER              TIMER7
+  #define NEOPIXEL_DMA                DMA1
+  #define NEOPIXEL_DMA_CHANNEL        DMA_CH4
+  #define NEOPIXEL_DMA_IRQn           DMA1_Channel4_IRQn
+  #define NEOPIXEL_DMA_IRQHandler     DMA1_Channel4_IRQHandler
+  #define NEOPIXEL_DMA_FLAGS()        (DMA_INTF(NEOPIXEL_DMA) >> 16)  // channel 4 bits: 16-19
+  #define NEOPIXEL_DMA_CLEAR_FLAG()   DMA_INTC(NEOPIXEL_DMA) = (0x0F << 16)
+  #define NEOPIXEL_DMA_FLAG_HT        (1 << 2)
+  #define NEOPIXEL_DMA_FLAG_TC        (1 << 1)
+#elif !defined(SD_SDIO_SUPPORT)
+  // TIM8_CH2 DMA request is on DMA2 stream 3 channel 7, the SDIO stream (the SD card of these boards is on SPI)
+  #define NEOPIXEL_TIMER              TIM8
+  #define NEOPIXEL_DMA_STREAM         DMA2_Stream3
+  #define NEOPIXEL_DMA_IRQn           DMA2_Stream3_IRQn
+  #define NEOPIXEL_DMA_IRQHandler     DMA2_Stream3_IRQHandler
+  #define NEOPIXEL_DMA_FLAGS()        (DMA2->LISR >> 22)              // DMA2_Stream3 low bits: 22-27
+  #define NEOPIXEL_DMA_CLEAR_FLAG()   DMA2->LIFCR = (0x3F << 22)
+  #define NEOPIXEL_DMA_FLAG_HT        (1 << 4)
+  #define NEOPIXEL_DMA_FLAG_TC        (1 << 5)
+  #define NEOPIXEL_DMA_CHANNEL        7
+  #define NEOPIXEL_DMA_REQUEST        (1 << 10)                       // CC2 DMA request, on update event (CCDS)
 #else
-  #define NEOPIXEL_TIMER_CLOCK_ENABLE() RCC->APB1ENR |= 1 << 4  // TIM6 Clock enable
-  #define NEOPIXEL_TIMER_CNT() TIM6->CNT
-  #define NEOPIXEL_TIMER_PSC() TIM6->PSC
-  #define NEOPIXEL_TIMER_ARR() TIM6->ARR
-  #define NEOPIXEL_TIMER_SR()  TIM6->SR
-  #define NEOPIXEL_TIMER_CR1() TIM6->CR1
+  // with SDIO on DMA2 stream 3, TIM8_UP DMA request on DMA2 stream 1 channel 7 loads CCR2 instead, stream 1 is
+  // the USART6 rx DMA
+  #if SERIAL_PORT == _USART6 || (defined(SERIAL_PORT_2) && SERIAL_PORT_2 == _USART6) || \
+      (defined(SERIAL_PORT_3) && SERIAL_PORT_3 == _USART6) || (defined(SERIAL_PORT_4) && SERIAL_PORT_4 == _USART6)
+    #error "KNOB_LED_COLOR_PIN needs a free DMA2 stream, SDIO and USART6 use the ones of TIM8"
+  #endif
+  #define NEOPIXEL_TIMER              TIM8
+  #define NEOPIXEL_DMA_STREAM         DMA2_Stream1
+  #define NEOPIXEL_DMA_IRQn           DMA2_Stream1_IRQn
+  #define NEOPIXEL_DMA_IRQHandler     DMA2_Stream1_IRQHandler
+  #define NEOPIXEL_DMA_FLAGS()        (DMA2->LISR >> 6)               // DMA2_Stream1 low bits: 6-11
+  #define NEOPIXEL_DMA_CLEAR_FLAG()   DMA2->LIFCR = (0x3F << 6)
+  #define NEOPIXEL_DMA_FLAG_HT        (1 << 4)
+  #define NEOPIXEL_DMA_FLAG_TC        (1 << 5)
+  #define NEOPIXEL_DMA_CHANNEL        7
+  #define NEOPIXEL_DMA_REQUEST        (1 << 8)                        // Update DMA request
 #endif
 
-void knob_LED_Init(void)
+typedef struct
+{
+  const uint32_t *colors;  // GRB color of each pixel, NULL: all the pixels are set to color
+  uint32_t color;
+  uint16_t count;          // pixels of the frame
+  uint16_t next;           // next pixel to encode
+  uint8_t idleHalves;      // halves of the buffer encoded after the last pixel
+  uint32_t startTime;      // time in ms of the start of the frame
+  volatile bool busy;
+  volatile uint32_t endTime;  // time in us of the end of the last frame
+} NEOPIXEL_FRAME;
+
+static uint16_t neopixelBuffer[NEOPIXEL_BUFFER_SIZE];
+static NEOPIXEL_FRAME neopixelFrame;
+static uint16_t cycle, code0, code1;  // timer period and compare values of the bits
+
+// encode the next pixels of the frame in one half of the buffer, a zero duty cycle (low level) follows the last pixel
+static void neopixelEncode(uint16_t *buf)
 {
-  GPIO_InitSet(KNOB_LED_COLOR_PIN, MGPIO_MODE_OUT_PP, 0);
-  GPIO_SetLevel(KNOB_LED_COLOR_PIN, 0);
+  if (neopixelFrame.next >= neopixelFrame.count)
+    neopixelFrame.idleHalves++;
+
+  for (uint8_t i = 0; i < NEOPIXEL_BUFFER_PIXELS / 2; i++, buf += 24)
+  {
+    if (neopixelFrame.next < neopixelFrame.count)
+    {
+      uint32_t color = (neopixelFrame.colors != NULL) ? neopixelFrame.colors[neopixelFrame.next] : neopixelFrame.color;
 
-  NEOPIXEL_TIMER_CLOCK_ENABLE();
-  NEOPIXEL_TIMER_CNT() = 0;
-  NEOPIXEL_TIMER_PSC() = 1 - 1;
-  NEOPIXEL_TIMER_SR() = (uint16_t)~(1 << 0);
+      for (int8_t bit = 23; bit >= 0; bit--)
+      {
+        buf[23 - bit] = (color & (1 << bit)) ? code1 : code0;
+      }
+      neopixelFrame.next++;
+    }
+    else
+    {
+      memset(buf, 0, 24 * sizeof(uint16_t));
+    }
+  }
 }
 
-void knob_LED_DeInit(void)
+#ifdef GD32F2XX
+
+static void neopixelHwInit(void)
 {
-  GPIO_InitSet(KNOB_LED_COLOR_PIN, MGPIO_MODE_IPN, 0);
+  GPIO_InitSet(KNOB_LED_COLOR_PIN, MGPIO_MODE_AF_PP, 0);
+
+  rcu_periph_clock_enable(RCU_TIMER7);
+  rcu_periph_clock_enable(RCU_DMA1);
+
+  TIMER_CTL0(NEOPIXEL_TIMER) = 1 << 7;                      // Auto-reload preload enable
+  TIMER_CTL1(NEOPIXEL_TIMER) = 1 << 3;                      // Channel DMA request on update event
+  TIMER_PSC(NEOPIXEL_TIMER) = 0;
+  TIMER_CAR(NEOPIXEL_TIMER) = cycle - 1;
+  TIMER_CH1CV(NEOPIXEL_TIMER) = 0;
+  TIMER_CHCTL0(NEOPIXEL_TIMER) = (6 << 12) | (1 << 11);     // CH1 PWM0 mode, compare value preload
+  TIMER_CHCTL2(NEOPIXEL_TIMER) = 1 << 4;                    // CH1 output enable
+  TIMER_CCHP(NEOPIXEL_TIMER) = 1 << 15;                     // Main output enable
+
+  DMA_CHCTL(NEOPIXEL_DMA, NEOPIXEL_DMA_CHANNEL) = 0;
+  DMA_CHPADDR(NEOPIXEL_DMA, NEOPIXEL_DMA_CHANNEL) = (uint32_t)&TIMER_CH1CV(NEOPIXEL_TIMER);
+  DMA_CHMADDR(NEOPIXEL_DMA, NEOPIXEL_DMA_CHANNEL) = (uint32_t)neopixelBuffer;
+  DMA_CHCTL(NEOPIXEL_DMA, NEOPIXEL_DMA_CHANNEL) = (1 << 1)    // Full transfer finish interrupt
+                                                | (1 << 2)    // Half transfer finish interrupt
+                                                | (1 << 4)    // Read from memory
+                                                | (1 << 5)    // Circular mode
+                                                | (1 << 7)    // Memory increasing mode
+                                                | (1 << 8)    // Peripheral data width is 16 bits
+                                                | (1 << 10)   // Memory data width 16 bits
+                                                | (2 << 12);  // High priority
+
+  nvic_irq_enable(NEOPIXEL_DMA_IRQn, 0U, 0U);  // higher than everything else, a half of the buffer is sent in 120us
 }
 
-void Knob_LED_SetColor(uint32_t color, uint8_t neopixel_pixels)
+static void neopixelHwDeInit(void)
 {
-  uint16_t led_num;
-  int8_t bit;
-  uint16_t cycle = mcuClocks.PCLK1_Timer_Frequency * (0.000001 * (NEOPIXEL_T0H_US + NEOPIXEL_T1H_US)) / 2 - 1;  // Neopixel frequency
-  uint16_t code_0_tim_h_cnt = cycle * (NEOPIXEL_T0H_US / (NEOPIXEL_T0H_US + NEOPIXEL_T1H_US));  // Code 0, High level hold time,
-  uint16_t code_1_tim_h_cnt = cycle - code_0_tim_h_cnt;
+  nvic_irq_disable(NEOPIXEL_DMA_IRQn);
+  TIMER_CTL0(NEOPIXEL_TIMER) = 0;
+  DMA_CHCTL(NEOPIXEL_DMA, NEOPIXEL_DMA_CHANNEL) = 0;
+  rcu_periph_clock_disable(RCU_TIMER7);
+}
+
+static void neopixelHwStart(void)
+{
+  NEOPIXEL_DMA_CLEAR_FLAG();
+  DMA_CHCNT(NEOPIXEL_DMA, NEOPIXEL_DMA_CHANNEL) = NEOPIXEL_BUFFER_SIZE;
+  DMA_CHCTL(NEOPIXEL_DMA, NEOPIXEL_DMA_CHANNEL) |= 1 << 0;  // enable dma channel
+
+  TIMER_CH1CV(NEOPIXEL_TIMER) = 0;                  // the line stays low until the first bit is loaded
+  TIMER_DMAINTEN(NEOPIXEL_TIMER) = 1 << 10;         // CH1 DMA request enable
+  TIMER_SWEVG(NEOPIXEL_TIMER) = 1 << 0;             // update event, reset the counter
+  TIMER_CTL0(NEOPIXEL_TIMER) |= 1 << 0;             // enable timer
+}
+
+static void neopixelHwStop(void)
+{
+  TIMER_CTL0(NEOPIXEL_TIMER) &= ~(1 << 0);
+  TIMER_DMAINTEN(NEOPIXEL_TIMER) = 0;
+  TIMER_CH1CV(NEOPIXEL_TIMER) = 0;
+  TIMER_SWEVG(NEOPIXEL_TIMER) = 1 << 0;             // load the zero duty cycle, keep the line low
+  DMA_CHCTL(NEOPIXEL_DMA, NEOPIXEL_DMA_CHANNEL) &= ~(1 << 0);
+}
+
+#else
+
+static void neopixelHwInit(void)
+{
+  NVIC_InitTypeDef NVIC_InitStructure;
+
+  GPIO_InitSet(KNOB_LED_COLOR_PIN, MGPIO_MODE_AF_PP, GPIO_AF_TIM8);
+
+  RCC->APB2ENR |= 1 << 1;   // TIM8 clock enable
+  RCC->AHB1ENR |= 1 << 22;  // DMA2 clock enable
 
-  while (frameTimeStamp == OS_GetTimeMs());
+  NEOPIXEL_TIMER->CR1 = 1 << 7;                     // Auto-reload preload enable
+  NEOPIXEL_TIMER->CR2 = 1 << 3;                     // CC DMA request on update event
+  NEOPIXEL_TIMER->PSC = 0;
+  NEOPIXEL_TIMER->ARR = cycle - 1;
+  NEOPIXEL_TIMER->CCR2 = 0;
+  NEOPIXEL_TIMER->CCMR1 = (6 << 12) | (1 << 11);    // CH2 PWM1 mode, compare preload
+  NEOPIXEL_TIMER->CCER = 1 << 4;                    // CH2 output enable
+  NEOPIXEL_TIMER->BDTR = 1 << 15;                   // Main output enable
 
-  __disable_irq();  // Disable interrupt, avoid disturbing the timing of WS2812
-  NEOPIXEL_TIMER_ARR() = cycle;
-  NEOPIXEL_TIMER_CR1() |= 0x01;
+  NEOPIXEL_DMA_STREAM->CR = 0;
+  NEOPIXEL_DMA_STREAM->PAR = (uint32_t)&NEOPIXEL_TIMER->CCR2;
+  NEOPIXEL_DMA_STREAM->M0AR = (uint32_t)neopixelBuffer;
+  NEOPIXEL_DMA_STREAM->FCR = 0;                     // direct mode
+  NEOPIXEL_DMA_STREAM->CR = (NEOPIXEL_DMA_CHANNEL << 25)  // TIM8_CH2 or TIM8_UP
+                          | (2 << 16)   // High priority
+                          | (1 << 13)   // Memory data width 16 bits
+                          | (1 << 11)   // Peripheral data width 16 bits
+                          | (1 << 10)   // Memory increment mode
+                          | (1 << 8)    // Circular mode
+                          | (1 << 6)    // Memory to peripheral
+                          | (1 << 4)    // Transfer complete interrupt
+                          | (1 << 3);   // Half transfer interrupt
 
-  for (led_num = 0; led_num < neopixel_pixels; led_num++)
+  NVIC_InitStructure.NVIC_IRQChannel = NEOPIXEL_DMA_IRQn;
+  NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;  // higher than everything else, a half of the buffer is sent in 120us
+  NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+  NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+  NVIC_Init(&NVIC_InitStructure);
+}
+
+static void neopixelHwDeInit(void)
+{
+  NVIC_DisableIRQ(NEOPIXEL_DMA_IRQn);
+  NEOPIXEL_TIMER->CR1 = 0;
+  NEOPIXEL_DMA_STREAM->CR = 0;
+  RCC->APB2ENR &= ~(1 << 1);
+}
+
+static void neopixelHwStart(void)
+{
+  NEOPIXEL_DMA_CLEAR_FLAG();
+  NEOPIXEL_DMA_STREAM->NDTR = NEOPIXEL_BUFFER_SIZE;
+  NEOPIXEL_DMA_STREAM->CR |= 1 << 0;             // enable dma stream
+
+  NEOPIXEL_TIMER->CCR2 = 0;                      // the line stays low until the first bit is loaded
+  NEOPIXEL_TIMER->DIER = NEOPIXEL_DMA_REQUEST;   // DMA request enable
+  NEOPIXEL_TIMER->EGR = 1 << 0;                  // update event, reset the counter
+  NEOPIXEL_TIMER->CR1 |= 1 << 0;                 // enable timer
+}
+
+static void neopixelHwStop(void)
+{
+  NEOPIXEL_TIMER->CR1 &= ~(1 << 0);
+  NEOPIXEL_TIMER->DIER = 0;
+  NEOPIXEL_TIMER->CCR2 = 0;
+  NEOPIXEL_TIMER->EGR = 1 << 0;                  // load the zero duty cycle, keep the line low
+  NEOPIXEL_DMA_STREAM->CR &= ~(1 << 0);
+}
+
+#endif
+
+void NEOPIXEL_DMA_IRQHandler(void)
+{
+  uint32_t flags = NEOPIXEL_DMA_FLAGS();
+
+  NEOPIXEL_DMA_CLEAR_FLAG();
+
+  if (!neopixelFrame.busy)
+    return;
+
+  // both halves were encoded after the last pixel, the half just sent was low level only
+  if (neopixelFrame.idleHalves >= 2)
   {
-    for (bit = 23; bit >= 0; bit--)
-    {
-      NEOPIXEL_TIMER_CNT() = 0;
-      WS2812_FAST_WRITE_HIGH();  // WS2812 required very high speed, so "GPIO_SetLevel(KNOB_LED_COLOR_PIN, 1)" not applicable
+    neopixelHwStop();
+    neopixelFrame.endTime = OS_GetTimeUs();
+    neopixelFrame.busy = false;
+    return;
+  }
 
-      if (color & (1 << bit))
-      {
-        while (NEOPIXEL_TIMER_CNT() < code_1_tim_h_cnt);
-      }
-      else
-      {
-        while (NEOPIXEL_TIMER_CNT() < code_0_tim_h_cnt);
-      }
+  if (flags & NEOPIXEL_DMA_FLAG_HT)  // first half sent, the DMA is on the second half
+    neopixelEncode(neopixelBuffer);
+  else if (flags & NEOPIXEL_DMA_FLAG_TC)
+    neopixelEncode(neopixelBuffer + NEOPIXEL_HALF_SIZE);
+}
 
-      WS2812_FAST_WRITE_LOW();
+static void neopixelStart(const uint32_t *colors, uint32_t color, uint16_t count)
+{
+  neopixelFrame.colors = colors;
+  neopixelFrame.color = color;
+  neopixelFrame.count = count;
+  neopixelFrame.next = 0;
+  neopixelFrame.idleHalves = 0;
+  neopixelFrame.startTime = OS_GetTimeMs();
+  neopixelFrame.busy = true;
 
-      while (!NEOPIXEL_TIMER_SR());
+  neopixelEncode(neopixelBuffer);
+  neopixelEncode(neopixelBuffer + NEOPIXEL_HALF_SIZE);
+  neopixelHwStart();
+}
 
-      NEOPIXEL_TIMER_SR() = 0;
+// wait for the end of the frame on the way, it is stopped if the DMA doesn't complete it in time
+static void neopixelWait(void)
+{
+  // 24 bits per pixel, plus the buffer of low level after the last one
+  uint32_t timeout = (neopixelFrame.count + NEOPIXEL_BUFFER_PIXELS) * 24 * NEOPIXEL_PERIOD_US / 1000 + NEOPIXEL_TIMEOUT_MS;
+
+  while (neopixelFrame.busy)
+  {
+    if (OS_GetTimeMs() - neopixelFrame.startTime > timeout)
+    {
+      neopixelFrame.busy = false;  // first, so the DMA interrupt doesn't encode anymore
+      neopixelHwStop();
+      neopixelFrame.endTime = OS_GetTimeUs();
     }
   }
+}
+
+void knob_LED_Init(void)
+{
+  cycle = mcuClocks.PCLK2_Timer_Frequency * (0.000001 * NEOPIXEL_PERIOD_US);  // Neopixel frequency
+  code0 = cycle * (NEOPIXEL_T0H_US / NEOPIXEL_PERIOD_US);                     // Code 0, High level hold time
+  code1 = cycle * (NEOPIXEL_T1H_US / NEOPIXEL_PERIOD_US);                     // Code 1, High level hold time
+
+  neopixelFrame.busy = false;
+  neopixelFrame.endTime = OS_GetTimeUs() - NEOPIXEL_LATCH_US;
+  neopixelHwInit();
+}
+
+void knob_LED_DeInit(void)
+{
+  neopixelWait();
+
+  neopixelHwDeInit();
+  GPIO_InitSet(KNOB_LED_COLOR_PIN, MGPIO_MODE_IPN, 0);
+}
+
+// a frame is still on the way, or the latch time after it is not elapsed yet
+bool Knob_LED_IsBusy(void)
+{
+  return neopixelFrame.busy || (OS_GetTimeUs() - neopixelFrame.endTime < NEOPIXEL_LATCH_US);
+}
 
-  NEOPIXEL_TIMER_CR1() &= ~0x01;
-  __enable_irq();  // Enable interrupt
+// start sending a frame with the GRB color of each pixel, return false if the previous frame is still busy
+// colors must stay valid until Knob_LED_IsBusy() returns false, the pixels are encoded while they are sent
+bool Knob_LED_SetPixels(const uint32_t *colors, uint16_t count)
+{
+  if (Knob_LED_IsBusy())
+    return false;
+
+  neopixelStart(colors, 0, count);
+  return true;
+}
+
+void Knob_LED_SetColor(uint32_t color, uint8_t neopixel_pixels)
+{
+  neopixelWait();
+  while (Knob_LED_IsBusy());  // latch time
 
-  frameTimeStamp = OS_GetTimeMs();
+  neopixelStart(NULL, color, neopixel_pixels);
 }
 
 #endif  // KNOB_LED_COLOR_PIN
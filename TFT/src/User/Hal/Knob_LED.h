@@ -5,12 +5,15 @@
 extern "C" {
 #endif
 
+#include <stdbool.h>
 #include <stdint.h>
 #include "variants.h"  // for KNOB_LED_COLOR_PIN etc...
 
 #ifdef KNOB_LED_COLOR_PIN
   void knob_LED_Init(void);
   void knob_LED_DeInit(void);
+  bool Knob_LED_IsBusy(void);
+  bool Knob_LED_SetPixels(const uint32_t *colors, uint16_t count);
   void Knob_LED_SetColor(uint32_t color, uint8_t neopixel_pixels);
 
   #define KNOB_LED_SET_COLOR(color, neopixel_pixels) Knob_LED_SetColor(color, neopixel_pixels)
@@ -73,6 +73,7 @@ uint32_t (*pLCD_ReadPixel_24Bit)(int16_t x, int16_t y);
 
 uint32_t LCD_ReadPixel_24Bit(int16_t x, int16_t y)
 {
+  lcd_frame_wait();
   return pLCD_ReadPixel_24Bit(x, y);
 }
 
@@ -253,6 +254,7 @@ void LCD_Init(void)
   LCD_HardwareConfig();
   LCD_Init_Sequential();
   LCD_RefreshDirection(0);
+  LCD_DMA_Config();  // spi flash to lcd DMA channel configuration, also used by GUI_Clear()
   GUI_Clear(BLACK);
   Delay_ms(120);
 
@@ -260,18 +262,16 @@ void LCD_Init(void)
     LCD_LED_Init();
     LCD_LED_On();
   #endif
-
-  #ifdef STM32_HAS_FSMC
-    LCD_DMA_Config();  // spi flash to fsmc lcd DMA channel configuration
-  #endif
 }
 
 void LCD_RefreshDirection(uint8_t rotate)
 {
+  lcd_frame_wait();
   pLCD_SetDirection(rotate);
 }
 
 void LCD_SetWindow(uint16_t sx, uint16_t sy, uint16_t ex, uint16_t ey)
 {
+  lcd_frame_draw_wait();  // queued frames are drawn first
   pLCD_SetWindow(sx, sy, ex, ey);
 }
@@ -11,7 +11,8 @@ Page 2 0x0800 1000 - 0x0800 17FF 2 Kbyte
 Page 255 0x0807 F800 - 0x0807 FFFF 2 Kbyte  // 512KByte
 */
 
-#define SIGN_ADDRESS (0x08040000 - 0x800)  // reserve the last page (2KB) to save user parameters
+#define PARA_ADDRESS (0x08040000 - PARA_PAGE_COUNT * PARA_PAGE_SIZE)  // reserve the last pages (4KB) to save user parameters
+#define SIGN_ADDRESS (0x08040000 - 0x800)                              // user parameters of the previous releases
 
 void HAL_FlashRead(uint8_t *data, uint32_t len)
 {
@@ -22,18 +23,35 @@ void HAL_FlashRead(uint8_t *data, uint32_t len)
   }
 }
 
-void HAL_FlashWrite(uint8_t *data, uint32_t len)
+void HAL_FlashReadPage(uint8_t page, uint32_t offset, uint8_t *data, uint32_t len)
 {
+  uint32_t addr = PARA_ADDRESS + page * PARA_PAGE_SIZE + offset;
   uint32_t i = 0;
+  for (i = 0; i < len; i++)
+  {
+    data[i] = *(volatile uint8_t*)(addr + i);
+  }
+}
+
+void HAL_FlashErasePage(uint8_t page)
+{
   fmc_unlock();
-  fmc_page_erase(SIGN_ADDRESS);
+  fmc_page_erase(PARA_ADDRESS + page * PARA_PAGE_SIZE);
   fmc_flag_clear(FMC_FLAG_BANK0_END);
   fmc_flag_clear(FMC_FLAG_BANK0_WPERR);
   fmc_flag_clear(FMC_FLAG_BANK0_PGERR);
+  fmc_lock();
+}
+
+void HAL_FlashWritePage(uint8_t page, uint32_t offset, const uint8_t *data, uint32_t len)
+{
+  uint32_t addr = PARA_ADDRESS + page * PARA_PAGE_SIZE + offset;
+  uint32_t i = 0;
+  fmc_unlock();
   for (i = 0; i < len; i += 2)
   {
     uint16_t data16 = data[i] | (data[MIN(i+1, len-1)] << 8);  // gd32f20x needs to write at least 16 bits at a time
-    fmc_halfword_program(SIGN_ADDRESS + i, data16);
+    fmc_halfword_program(addr + i, data16);
     fmc_flag_clear(FMC_FLAG_BANK0_END);
     fmc_flag_clear(FMC_FLAG_BANK0_WPERR);
     fmc_flag_clear(FMC_FLAG_BANK0_PGERR);
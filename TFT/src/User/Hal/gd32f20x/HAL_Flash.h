@@ -3,7 +3,15 @@
 
 #include "variants.h"  // for uint8_t etc...
 
+#define PARA_PAGE_SIZE  0x800  // 2KB
+#define PARA_PAGE_COUNT 2
+
+// user parameters of the previous releases, stored as a single block
 void HAL_FlashRead(uint8_t *data, uint32_t len);
-void HAL_FlashWrite(uint8_t *data, uint32_t len);
+
+// pages keeping the log of the user parameters, written without erase only where still erased (0xFF)
+void HAL_FlashReadPage(uint8_t page, uint32_t offset, uint8_t *data, uint32_t len);
+void HAL_FlashErasePage(uint8_t page);
+void HAL_FlashWritePage(uint8_t page, uint32_t offset, const uint8_t *data, uint32_t len);
 
 #endif
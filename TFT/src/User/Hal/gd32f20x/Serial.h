@@ -8,11 +8,16 @@
 typedef struct
 {
   char *cache;
-  uint16_t wIndex;
+  volatile uint16_t wIndex;   // updated by the IDLE interrupt
   uint16_t rIndex;
   uint16_t cacheSize;
+  volatile uint16_t lineIn;   // lines received, counted by the IDLE interrupt
+  uint16_t lineOut;           // lines read
 } DMA_CIRCULAR_BUFFER;
 
+// complete lines waiting in the rx buffer
+#define Serial_LineCount(port) ((uint16_t)(dmaL1Data[port].lineIn - dmaL1Data[port].lineOut))
+
 extern DMA_CIRCULAR_BUFFER dmaL1Data[_UART_CNT];
 
 void Serial_Config(uint8_t port, uint16_t cacheSize, uint32_t baudrate);
@@ -4,30 +4,75 @@
 #include "spi.h"
 #include "LCD_Init.h"
 #include "w25qxx.h"
+#include "GPIO_Init.h"
 #include "delay.h"
 #include "debug.h"
+#include "os_timer.h"
+#include "my_misc.h"
+#include <stddef.h>
 
 #ifdef STM32_HAS_FSMC
 #if W25Qxx_SPI == _SPI1
-  #define W25QXX_SPI_NUM          SPI0
-  #define W25QXX_SPI_DMA          DMA0
-  #define W25QXX_SPI_DMA_RCU      RCU_DMA0
-  #define W25QXX_SPI_DMA_CHANNEL  DMA_CH1
-  #define W25QXX_SPI_DMA_IFCR_BIT 5
+  #define W25QXX_SPI_NUM            SPI0
+  #define W25QXX_SPI_DMA            DMA0
+  #define W25QXX_SPI_DMA_RCU        RCU_DMA0
+  #define W25QXX_SPI_DMA_CHANNEL    DMA_CH1
+  #define W25QXX_SPI_DMA_IFCR_BIT   5
+  #define W25QXX_SPI_DMA_IRQn       DMA0_Channel1_IRQn
+  #define W25QXX_SPI_DMA_IRQHandler DMA0_Channel1_IRQHandler
 #elif W25Qxx_SPI == _SPI2
-  #define W25QXX_SPI_NUM          SPI1
-  #define W25QXX_SPI_DMA          DMA0
-  #define W25QXX_SPI_DMA_RCU      RCU_DMA0
-  #define W25QXX_SPI_DMA_CHANNEL  DMA_CH3
-  #define W25QXX_SPI_DMA_IFCR_BIT 13
+  #define W25QXX_SPI_NUM            SPI1
+  #define W25QXX_SPI_DMA            DMA0
+  #define W25QXX_SPI_DMA_RCU        RCU_DMA0
+  #define W25QXX_SPI_DMA_CHANNEL    DMA_CH3
+  #define W25QXX_SPI_DMA_IFCR_BIT   13
+  #define W25QXX_SPI_DMA_IRQn       DMA0_Channel3_IRQn
+  #define W25QXX_SPI_DMA_IRQHandler DMA0_Channel3_IRQHandler
 #elif W25Qxx_SPI == _SPI3
-  #define W25QXX_SPI_NUM          SPI2
-  #define W25QXX_SPI_DMA          DMA1
-  #define W25QXX_SPI_DMA_RCU      RCU_DMA1
-  #define W25QXX_SPI_DMA_CHANNEL  DMA_CH0
-  #define W25QXX_SPI_DMA_IFCR_BIT 1
+  #define W25QXX_SPI_NUM            SPI2
+  #define W25QXX_SPI_DMA            DMA1
+  #define W25QXX_SPI_DMA_RCU        RCU_DMA1
+  #define W25QXX_SPI_DMA_CHANNEL    DMA_CH0
+  #define W25QXX_SPI_DMA_IFCR_BIT   1
+  #define W25QXX_SPI_DMA_IRQn       DMA1_Channel0_IRQn
+  #define W25QXX_SPI_DMA_IRQHandler DMA1_Channel0_IRQHandler
 #endif
 
+// the frame engine owns the W25Qxx SPI while busy, so it drives CS directly instead of W25Qxx_SPI_CS_Set()
+#define W25QXX_CS_SET(level) GPIO_SetLevel(W25Qxx_CS_PIN, level)
+
+#define LCD_DMA_MAX_TRANS  65535  // DMA 65535 bytes one frame
+#define LCD_DMA_QUEUE_SIZE 16     // frames queued before lcd_frame_display() has to wait
+#define LCD_DMA_MIN_FILL   256    // smaller fills are faster done by CPU
+
+typedef enum
+{
+  FRAME_IMAGE = 0,
+  FRAME_FILL,
+  FRAME_READ,  // flash data to RAM, doesn't use the LCD
+} FRAME_TYPE;
+
+typedef struct
+{
+  uint16_t sx, sy;
+  uint16_t w, h;     // 0: read from the image header at addr. Bytes of a read in w
+  uint32_t addr;     // flash address, or color of a fill
+  uint8_t *buf;      // destination of a read
+  FRAME_TYPE type;
+} LCD_FRAME;
+
+static LCD_FRAME frameQueue[LCD_DMA_QUEUE_SIZE];
+static volatile uint8_t frameHead = 0;      // next frame to draw, moved by the DMA IRQ
+static volatile uint8_t frameTail = 0;      // next free slot, moved by the main loop
+static volatile bool frameBusy = false;
+static volatile uint8_t frameDraws = 0;     // queued frames drawing on the LCD, reads excluded
+static uint32_t frameCur, frameTotal, frameAddr;  // progress of the frame on the way
+static uint32_t frameStart;
+static FRAME_TYPE frameType;
+static uint8_t *frameBuf;
+static uint16_t fillColor;  // source of fill DMA
+static LCD_FRAME_STATS frameStats;
+
 // SPI --> FSMC DMA (LCD_RAM)
 // 16bits, SPI_RX to LCD_RAM.
 void LCD_DMA_Config(void)
@@ -38,6 +83,7 @@ void LCD_DMA_Config(void)
   DMA_CHMADDR(W25QXX_SPI_DMA, W25QXX_SPI_DMA_CHANNEL) = (uint32_t)&LCD->LCD_RAM;             // The target address is LCD_RAM
   DMA_CHCNT(W25QXX_SPI_DMA, W25QXX_SPI_DMA_CHANNEL) = 0;          // DMA1, the amount of data transferred, temporarily set to 0
   DMA_CHCTL(W25QXX_SPI_DMA, W25QXX_SPI_DMA_CHANNEL) = 0x00000000; // Reset
+  DMA_CHCTL(W25QXX_SPI_DMA, W25QXX_SPI_DMA_CHANNEL) |= 1<<1;      // Full transfer finish interrupt
   DMA_CHCTL(W25QXX_SPI_DMA, W25QXX_SPI_DMA_CHANNEL) |= 0<<4;      // Read from peripheral
   DMA_CHCTL(W25QXX_SPI_DMA, W25QXX_SPI_DMA_CHANNEL) |= 0<<5;      // Normal mode
   DMA_CHCTL(W25QXX_SPI_DMA, W25QXX_SPI_DMA_CHANNEL) |= 0<<6;      // Peripheral address non-incremental mode
@@ -46,17 +92,51 @@ void LCD_DMA_Config(void)
   DMA_CHCTL(W25QXX_SPI_DMA, W25QXX_SPI_DMA_CHANNEL) |= LCD_DATA_16BIT<<10; // Memory data width 16 bits
   DMA_CHCTL(W25QXX_SPI_DMA, W25QXX_SPI_DMA_CHANNEL) |= 1<<12;     // Medium priority
   DMA_CHCTL(W25QXX_SPI_DMA, W25QXX_SPI_DMA_CHANNEL) |= 0<<14;     // Non-memory to memory mode
+
+  nvic_irq_enable(W25QXX_SPI_DMA_IRQn, 1U, 0U);  // higher than the OS timer, so a frame in progress is always completed by lcd_frame_wait()
 }
 
-#define LCD_DMA_MAX_TRANS 65535  // DMA 65535 bytes one frame
+// switch the SPI DMA between SPI->DR to FSMC (LCD_RAM) and SPI->DR to RAM (frameBuf, bytes) for reads
+static void lcd_frame_dma_target(bool toRam)
+{
+  DMA_CHCTL(W25QXX_SPI_DMA, W25QXX_SPI_DMA_CHANNEL) &= ~((3<<10) | (3<<8) | (1<<7));
+
+  if (toRam)
+  {
+    DMA_CHMADDR(W25QXX_SPI_DMA, W25QXX_SPI_DMA_CHANNEL) = (uint32_t)(frameBuf + frameCur);
+    DMA_CHCTL(W25QXX_SPI_DMA, W25QXX_SPI_DMA_CHANNEL) |= 1<<7;                                   // Memory increasing mode, 8bit
+  }
+  else
+  {
+    DMA_CHMADDR(W25QXX_SPI_DMA, W25QXX_SPI_DMA_CHANNEL) = (uint32_t)&LCD->LCD_RAM;
+    DMA_CHCTL(W25QXX_SPI_DMA, W25QXX_SPI_DMA_CHANNEL) |= (LCD_DATA_16BIT<<10) | (LCD_DATA_16BIT<<8);  // Memory and peripheral data width
+  }
+}
 
-// start DMA transfer from SPI->DR to FSMC
-// the max bytes of one frame is LCD_DMA_MAX_TRANS 65535
-void lcd_frame_segment_display(uint16_t size, uint32_t addr)
+// start DMA transfer of the next segment of the current frame from SPI->DR to FSMC, or to RAM for reads
+// a fill uses the same channel in memory to memory mode, with fillColor as constant source
+// the max bytes of one segment is LCD_DMA_MAX_TRANS 65535
+static void lcd_frame_segment_start(void)
 {
+  uint32_t size = MIN(frameTotal - frameCur, LCD_DMA_MAX_TRANS);
+  uint8_t frame16 = (frameType == FRAME_READ) ? 0 : LCD_DATA_16BIT;
+  uint32_t addr = frameAddr + frameCur * (frame16 + 1);
+
+  if (frameType == FRAME_READ)
+    lcd_frame_dma_target(true);
+
+  frameCur += size;
   DMA_CHCNT(W25QXX_SPI_DMA, W25QXX_SPI_DMA_CHANNEL) = size;
 
-  W25Qxx_SPI_CS_Set(0);
+  if (frameType == FRAME_FILL)
+  {
+    DMA_CHPADDR(W25QXX_SPI_DMA, W25QXX_SPI_DMA_CHANNEL) = (uint32_t)&fillColor;
+    DMA_CHCTL(W25QXX_SPI_DMA, W25QXX_SPI_DMA_CHANNEL) |= 1<<14; // memory to memory mode
+    DMA_CHCTL(W25QXX_SPI_DMA, W25QXX_SPI_DMA_CHANNEL) |= 1<<0;  // enable dma channel
+    return;
+  }
+
+  W25QXX_CS_SET(0);
   W25Qxx_SPI_Read_Write_Byte(CMD_FAST_READ_DATA);
   W25Qxx_SPI_Read_Write_Byte((uint8_t)((addr)>>16));
   W25Qxx_SPI_Read_Write_Byte((uint8_t)((addr)>>8));
@@ -66,33 +146,209 @@ void lcd_frame_segment_display(uint16_t size, uint32_t addr)
   //set SPI to 16bit DMA rx only mode
   SPI_CTL0(W25QXX_SPI_NUM) &= ~(1<<6);
   SPI_CTL1(W25QXX_SPI_NUM) |= 1<<0;                // enable SPI rx DMA
-  SPI_CTL0(W25QXX_SPI_NUM) |= LCD_DATA_16BIT<<11;  // 16bit data frame
+  SPI_CTL0(W25QXX_SPI_NUM) |= frame16<<11;         // 16bit data frame
   SPI_CTL0(W25QXX_SPI_NUM) |= 1<<10;               // rx only
 
   DMA_CHCTL(W25QXX_SPI_DMA, W25QXX_SPI_DMA_CHANNEL) |= 1<<0; // enable dma channel
   SPI_CTL0(W25QXX_SPI_NUM) |= 1<<6;                // enable SPI
+}
 
-  while (((DMA_INTF(W25QXX_SPI_DMA) & (1<<W25QXX_SPI_DMA_IFCR_BIT)) == 0)); // wait for rx complete
+static void lcd_frame_segment_stop(void)
+{
   DMA_CHCTL(W25QXX_SPI_DMA, W25QXX_SPI_DMA_CHANNEL) &= (uint32_t)(~(1<<0));
   DMA_INTC(W25QXX_SPI_DMA) |= (uint32_t)(1<<W25QXX_SPI_DMA_IFCR_BIT);       // clear ISR for rx complete
-  W25Qxx_SPI_CS_Set(1);
+
+  if (frameType == FRAME_READ)
+    lcd_frame_dma_target(false);
+
+  if (frameType == FRAME_FILL)
+  {
+    DMA_CHCTL(W25QXX_SPI_DMA, W25QXX_SPI_DMA_CHANNEL) &= (uint32_t)(~(1<<14));
+    DMA_CHPADDR(W25QXX_SPI_DMA, W25QXX_SPI_DMA_CHANNEL) = (uint32_t)&SPI_DATA(W25QXX_SPI_NUM);
+    return;
+  }
+  W25QXX_CS_SET(1);
 
   SPI_Protocol_Init(W25Qxx_SPI, W25Qxx_SPEED);     // Reset SPI clock and config again
 }
 
-void lcd_frame_display(uint16_t sx,uint16_t sy,uint16_t w,uint16_t h, uint32_t addr)
+// start the next queued frame, return false if there is none
+static bool lcd_frame_start(void)
 {
-  uint32_t cur=0;
-  uint32_t segmentSize;
-  uint32_t totalSize = w*h*(2-LCD_DATA_16BIT);
+  while (frameHead != frameTail)
+  {
+    LCD_FRAME frame = frameQueue[frameHead];
+
+    frameHead = (frameHead + 1) % LCD_DMA_QUEUE_SIZE;
+    SPI_Protocol_Init(W25Qxx_SPI, W25Qxx_SPEED);  // the SPI may be left at another speed by a shared device
 
-  LCD_SetWindow(sx,sy,sx+w-1,sy+h-1);
+    if (frame.type == FRAME_IMAGE && frame.w == 0)
+    { // read image size
+      W25QXX_CS_SET(0);
+      W25Qxx_SPI_Read_Write_Byte(CMD_FAST_READ_DATA);
+      W25Qxx_SPI_Read_Write_Byte((uint8_t)((frame.addr)>>16));
+      W25Qxx_SPI_Read_Write_Byte((uint8_t)((frame.addr)>>8));
+      W25Qxx_SPI_Read_Write_Byte((uint8_t)frame.addr);
+      W25Qxx_SPI_Read_Write_Byte(W25QXX_DUMMY_BYTE);
+      frame.w = W25Qxx_SPI_Read_Write_Byte(W25QXX_DUMMY_BYTE);
+      frame.w |= W25Qxx_SPI_Read_Write_Byte(W25QXX_DUMMY_BYTE) << 8;
+      frame.h = W25Qxx_SPI_Read_Write_Byte(W25QXX_DUMMY_BYTE);
+      frame.h |= W25Qxx_SPI_Read_Write_Byte(W25QXX_DUMMY_BYTE) << 8;
+      W25QXX_CS_SET(1);
+      frame.addr += 4;
+    }
 
-  for (cur = 0; cur < totalSize; cur += LCD_DMA_MAX_TRANS)
+    if (frame.w == 0 || frame.h == 0)
+    {
+      if (frame.type != FRAME_READ)
+        frameDraws--;
+      continue;
+    }
+
+    frameCur = 0;
+    frameType = frame.type;
+    frameAddr = frame.addr;
+
+    if (frame.type == FRAME_READ)
+    {
+      frameTotal = frame.w;
+      frameBuf = frame.buf;
+    }
+    else
+    {
+      pLCD_SetWindow(frame.sx, frame.sy, frame.sx + frame.w - 1, frame.sy + frame.h - 1);
+      frameTotal = (frame.type == FRAME_FILL) ? frame.w * frame.h : frame.w * frame.h * (2 - LCD_DATA_16BIT);
+      fillColor = frame.addr;
+    }
+    lcd_frame_segment_start();
+    return true;
+  }
+
+  return false;
+}
+
+void W25QXX_SPI_DMA_IRQHandler(void)
+{
+  if ((DMA_INTF(W25QXX_SPI_DMA) & (1<<W25QXX_SPI_DMA_IFCR_BIT)) == 0)
+    return;
+
+  lcd_frame_segment_stop();
+
+  if (frameCur < frameTotal)
+  {
+    lcd_frame_segment_start();
+    return;
+  }
+
+  if (frameType != FRAME_READ)
+    frameDraws--;
+
+  if (!lcd_frame_start())
   {
-    segmentSize = (cur+LCD_DMA_MAX_TRANS)<=totalSize ? LCD_DMA_MAX_TRANS : totalSize-cur;
-    lcd_frame_segment_display(segmentSize, addr+cur*(LCD_DATA_16BIT + 1));
+    frameStats.time += OS_GetTimeUs() - frameStart;
+    frameBusy = false;
   }
 }
 
+static void lcd_frame_queue(uint16_t sx, uint16_t sy, uint16_t w, uint16_t h, uint32_t addr, uint8_t *buf, FRAME_TYPE type)
+{
+  uint8_t next = (frameTail + 1) % LCD_DMA_QUEUE_SIZE;
+
+  while (next == frameHead);  // queue is full, wait for the DMA IRQ to take a frame
+
+  __disable_irq();
+  frameQueue[frameTail] = (LCD_FRAME){sx, sy, w, h, addr, buf, type};
+  frameTail = next;
+
+  if (type == FRAME_FILL)
+    frameStats.fills++;
+  else if (type == FRAME_IMAGE)
+    frameStats.count++;
+
+  if (type != FRAME_READ)
+    frameDraws++;
+
+  if (!frameBusy)
+  {
+    frameBusy = true;
+    frameStart = OS_GetTimeUs();
+    if (!lcd_frame_start())
+      frameBusy = false;
+  }
+  __enable_irq();
+}
+
+void lcd_frame_display(uint16_t sx, uint16_t sy, uint16_t w, uint16_t h, uint32_t addr)
+{
+  if (w == 0 || h == 0)
+    return;
+
+  lcd_frame_queue(sx, sy, w, h, addr, NULL, FRAME_IMAGE);
+}
+
+void lcd_image_display(uint16_t sx, uint16_t sy, uint32_t addr)
+{
+  lcd_frame_queue(sx, sy, 0, 0, addr, NULL, FRAME_IMAGE);
+}
+
+void lcd_frame_fill(uint16_t sx, uint16_t sy, uint16_t w, uint16_t h, uint16_t color)
+{
+  uint32_t count = w * h;
+
+  if (count == 0)
+    return;
+
+  #if LCD_DATA_16BIT == 1  // 8bit LCDs need 2 different bytes per pixel
+    if (count >= LCD_DMA_MIN_FILL)
+    {
+      lcd_frame_queue(sx, sy, w, h, color, NULL, FRAME_FILL);
+      return;
+    }
+  #endif
+
+  LCD_SetWindow(sx, sy, sx + w - 1, sy + h - 1);
+
+  while (count--)
+  {
+    LCD_WR_16BITS_DATA(color);
+  }
+}
+
+void lcd_frame_read(uint8_t *buf, uint32_t addr, uint16_t size)
+{
+  if (size == 0)
+    return;
+
+  lcd_frame_queue(0, 0, size, 1, addr, buf, FRAME_READ);
+}
+
+bool lcd_frame_busy(void)
+{
+  return frameBusy;
+}
+
+void lcd_frame_wait(void)
+{
+  while (frameBusy);
+}
+
+void lcd_frame_draw_wait(void)
+{
+  while (frameDraws != 0);
+}
+
+void lcd_frame_stats_reset(void)
+{
+  __disable_irq();
+  frameStats.count = 0;
+  frameStats.fills = 0;
+  frameStats.time = 0;
+  frameStart = OS_GetTimeUs();
+  __enable_irq();
+}
+
+void lcd_frame_stats_get(LCD_FRAME_STATS *stats)
+{
+  *stats = frameStats;
+}
 #endif
@@ -1,6 +1,9 @@
 #include "spi.h"
 #include "variants.h"  // for SPI1_SCK_PIN etc...
 #include "GPIO_Init.h"
+#include "uart.h"
+#include <stdbool.h>
+#include <stddef.h>
 
 // SPI1 default pins config
 #ifndef SPI1_SCK_PIN
@@ -51,6 +54,44 @@ static uint32_t spi[_SPI_CNT] = {
   SPI2,  // SCK--PB3   MISO--PB4   MOSI--PB5
 };
 
+// SPI DMA channels of SPI_Transfer(). The rx DMA of a serial port is always running, so the SPIs
+// sharing their tx channel with a serial port in use transfer by CPU instead
+#if SERIAL_PORT == _USART3 || (defined(SERIAL_PORT_2) && SERIAL_PORT_2 == _USART3) || \
+    (defined(SERIAL_PORT_3) && SERIAL_PORT_3 == _USART3) || (defined(SERIAL_PORT_4) && SERIAL_PORT_4 == _USART3)
+  #define SPI1_TX_DMA false  // DMA0 channel 2 is the USART2 (_USART3) rx DMA
+#else
+  #define SPI1_TX_DMA true
+#endif
+#if SERIAL_PORT == _USART1 || (defined(SERIAL_PORT_2) && SERIAL_PORT_2 == _USART1) || \
+    (defined(SERIAL_PORT_3) && SERIAL_PORT_3 == _USART1) || (defined(SERIAL_PORT_4) && SERIAL_PORT_4 == _USART1)
+  #define SPI2_TX_DMA false  // DMA0 channel 4 is the USART0 (_USART1) rx DMA
+#else
+  #define SPI2_TX_DMA true
+#endif
+#if SERIAL_PORT == _UART5 || (defined(SERIAL_PORT_2) && SERIAL_PORT_2 == _UART5) || \
+    (defined(SERIAL_PORT_3) && SERIAL_PORT_3 == _UART5) || (defined(SERIAL_PORT_4) && SERIAL_PORT_4 == _UART5)
+  #define SPI3_TX_DMA false  // DMA1 channel 1 is the UART4 (_UART5) rx DMA
+#else
+  #define SPI3_TX_DMA true
+#endif
+
+#define SPI_DMA_MIN_TRANS 16  // shorter transfers are faster done by CPU
+
+typedef struct
+{
+  uint32_t dma;
+  dma_channel_enum rx;
+  dma_channel_enum tx;
+  bool enabled;  // false: the SPI transfers by CPU
+  rcu_periph_enum rcu;
+} SPI_DMA;
+
+static const SPI_DMA spi_dma[_SPI_CNT] = {
+  {DMA0, DMA_CH1, DMA_CH2, SPI1_TX_DMA, RCU_DMA0},
+  {DMA0, DMA_CH3, DMA_CH4, SPI2_TX_DMA, RCU_DMA0},
+  {DMA1, DMA_CH0, DMA_CH1, SPI3_TX_DMA, RCU_DMA1},
+};
+
 static const uint16_t spi_sck[_SPI_CNT]  = {SPI1_SCK_PIN,  SPI2_SCK_PIN,  SPI3_SCK_PIN};   // SCK
 static const uint16_t spi_miso[_SPI_CNT] = {SPI1_MISO_PIN, SPI2_MISO_PIN, SPI3_MISO_PIN};  // MISO
 static const uint16_t spi_mosi[_SPI_CNT] = {SPI1_MOSI_PIN, SPI2_MOSI_PIN, SPI3_MOSI_PIN};  // MOSI
@@ -123,3 +164,64 @@ uint16_t SPI_Read_Write(uint8_t port, uint16_t d)
   while ((SPI_STAT(spi[port]) & (1 << 0)) == RESET);  // wait for rx no empty
   return SPI_DATA(spi[port]);
 }
+
+// transfer len bytes, tx NULL sends 0xFF and rx NULL drops the received bytes
+// the rx channel may be the one of the lcd_dma.c frame engine (W25Qxx on the same SPI), which must be idle
+void SPI_Transfer(uint8_t port, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+  static const uint8_t txDummy = 0xFF;
+  static uint8_t rxDummy;
+  const SPI_DMA *cfg = &spi_dma[port];
+  uint32_t rxCTL, rxPADDR, rxMADDR, rxCNT;
+
+  if (!cfg->enabled || len < SPI_DMA_MIN_TRANS)
+  {
+    for (uint16_t i = 0; i < len; i++)
+    {
+      while ((SPI_STAT(spi[port]) & (1 << 1)) == RESET);  // wait for tx empty
+      SPI_DATA(spi[port]) = (tx != NULL) ? tx[i] : 0xFF;
+      while ((SPI_STAT(spi[port]) & (1 << 0)) == RESET);  // wait for rx no empty
+      uint8_t data = SPI_DATA(spi[port]);
+      if (rx != NULL)
+        rx[i] = data;
+    }
+    return;
+  }
+
+  rcu_periph_clock_enable(cfg->rcu);
+  // restored at the end for the frame engine, which doesn't set them all for each frame
+  rxCTL = DMA_CHCTL(cfg->dma, cfg->rx) & ~(1<<0);
+  rxPADDR = DMA_CHPADDR(cfg->dma, cfg->rx);
+  rxMADDR = DMA_CHMADDR(cfg->dma, cfg->rx);
+  rxCNT = DMA_CHCNT(cfg->dma, cfg->rx);
+
+  DMA_CHCTL(cfg->dma, cfg->rx) = 0;
+  DMA_CHPADDR(cfg->dma, cfg->rx) = (uint32_t)&SPI_DATA(spi[port]);
+  DMA_CHMADDR(cfg->dma, cfg->rx) = (uint32_t)((rx != NULL) ? rx : &rxDummy);
+  DMA_CHCNT(cfg->dma, cfg->rx) = len;
+  DMA_CHCTL(cfg->dma, cfg->rx) = (2<<12)             // High priority, ahead of tx so rx never overruns
+                               | ((rx != NULL)<<7);  // Memory increment, 8bit
+
+  DMA_CHCTL(cfg->dma, cfg->tx) = 0;
+  DMA_CHPADDR(cfg->dma, cfg->tx) = (uint32_t)&SPI_DATA(spi[port]);
+  DMA_CHMADDR(cfg->dma, cfg->tx) = (uint32_t)((tx != NULL) ? tx : &txDummy);
+  DMA_CHCNT(cfg->dma, cfg->tx) = len;
+  DMA_CHCTL(cfg->dma, cfg->tx) = (1<<12)             // Medium priority
+                               | ((tx != NULL)<<7)   // Memory increment, 8bit
+                               | (1<<4);             // Read from memory
+
+  DMA_CHCTL(cfg->dma, cfg->rx) |= 1<<0;
+  DMA_CHCTL(cfg->dma, cfg->tx) |= 1<<0;
+  SPI_CTL1(spi[port]) |= (1<<1) | (1<<0);            // tx and rx DMA requests, the transfer starts
+
+  while (DMA_CHCNT(cfg->dma, cfg->rx) != 0);         // the last byte received is also the last one sent
+
+  SPI_CTL1(spi[port]) &= ~((1<<1) | (1<<0));
+  DMA_CHCTL(cfg->dma, cfg->tx) = 0;
+  DMA_CHCTL(cfg->dma, cfg->rx) = 0;
+  DMA_INTC(cfg->dma) = (0x0F << (cfg->rx * 4)) | (0x0F << (cfg->tx * 4));
+  DMA_CHPADDR(cfg->dma, cfg->rx) = rxPADDR;
+  DMA_CHMADDR(cfg->dma, cfg->rx) = rxMADDR;
+  DMA_CHCNT(cfg->dma, cfg->rx) = rxCNT;
+  DMA_CHCTL(cfg->dma, cfg->rx) = rxCTL;
+}
@@ -0,0 +1,41 @@
+#include "GPIO_Init.h"
+#include "spi.h"
+
+#define GPIO_PORT_CNT 11  // GPIOA ~ GPIOK
+
+// pins are read high if not driven, like the pulled up inputs of the boards (pen, SD card detect etc...)
+static uint16_t gpioLow[GPIO_PORT_CNT];
+
+void GPIO_InitSet(uint16_t io, GPIO_MODE mode, uint8_t AF)
+{
+  if (mode == MGPIO_MODE_IPD)
+    GPIO_SetLevel(io, 0);
+  else if (mode == MGPIO_MODE_IPU)
+    GPIO_SetLevel(io, 1);
+}
+
+void GPIO_SetLevel(uint16_t io, uint8_t level)
+{
+  uint16_t port = GPIO_GET_PORT(io);
+  uint16_t pin = GPIO_GET_PIN(io);
+
+  if (level)
+    gpioLow[port] &= ~(1 << pin);
+  else
+    gpioLow[port] |= 1 << pin;
+
+  SPI_NativeChipSelect(io, level);  // the SPI devices are selected by GPIO
+}
+
+void GPIO_ToggleLevel(uint16_t io)
+{
+  GPIO_SetLevel(io, !GPIO_GetLevel(io));
+}
+
+uint8_t GPIO_GetLevel(uint16_t io)
+{
+  uint16_t port = GPIO_GET_PORT(io);
+  uint16_t pin = GPIO_GET_PIN(io);
+
+  return (gpioLow[port] & (1 << pin)) == 0;
+}
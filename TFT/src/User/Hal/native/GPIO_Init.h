@@ -0,0 +1,24 @@
+#ifndef _GPIO_INIT_H_
+#define _GPIO_INIT_H_
+
+#include "variants.h"
+#include "STM32Fxx_Pins.h"
+
+typedef enum
+{
+  MGPIO_MODE_AIN,
+  MGPIO_MODE_IPN,
+  MGPIO_MODE_IPU,
+  MGPIO_MODE_IPD,
+  MGPIO_MODE_OUT_PP,
+  MGPIO_MODE_OUT_OD,
+  MGPIO_MODE_AF_PP,
+  MGPIO_MODE_AF_OD,
+} GPIO_MODE;
+
+void GPIO_InitSet(uint16_t io, GPIO_MODE mode, uint8_t AF);
+void GPIO_SetLevel(uint16_t io, uint8_t level);
+void GPIO_ToggleLevel(uint16_t io);
+uint8_t GPIO_GetLevel(uint16_t io);
+
+#endif
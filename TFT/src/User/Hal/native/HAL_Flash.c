@@ -0,0 +1,71 @@
+#include "HAL_Flash.h"
+#include "native_host.h"
+#include <stdio.h>
+#include <string.h>
+
+// user parameters are kept in a file instead of the last pages of the MCU flash.
+// The parameters of the previous releases are at the start of the file, as in the last page on the boards
+
+static void paraFileRead(uint8_t *data, uint32_t offset, uint32_t len)
+{
+  FILE *f = fopen(NATIVE_GetPath(NATIVE_PARA_FILE), "rb");
+  size_t br = 0;
+
+  if (f != NULL)
+  {
+    if (fseek(f, offset, SEEK_SET) == 0)
+      br = fread(data, 1, len, f);
+
+    fclose(f);
+  }
+
+  memset(data + br, 0xFF, len - br);  // erased flash
+}
+
+static void paraFileWrite(const uint8_t *data, uint32_t offset, uint32_t len)
+{
+  uint8_t file[PARA_PAGE_COUNT * PARA_PAGE_SIZE];
+  FILE *f;
+
+  paraFileRead(file, 0, sizeof(file));
+  memcpy(file + offset, data, len);
+
+  if ((f = fopen(NATIVE_GetPath(NATIVE_PARA_FILE), "wb")) == NULL)
+    return;
+
+  fwrite(file, 1, sizeof(file), f);
+  fclose(f);
+}
+
+void HAL_FlashRead(uint8_t *data, uint32_t len)
+{
+  paraFileRead(data, 0, len);
+}
+
+void HAL_FlashReadPage(uint8_t page, uint32_t offset, uint8_t *data, uint32_t len)
+{
+  paraFileRead(data, page * PARA_PAGE_SIZE + offset, len);
+}
+
+void HAL_FlashErasePage(uint8_t page)
+{
+  uint8_t erased[PARA_PAGE_SIZE];
+
+  memset(erased, 0xFF, sizeof(erased));
+  paraFileWrite(erased, page * PARA_PAGE_SIZE, sizeof(erased));
+}
+
+void HAL_FlashWritePage(uint8_t page, uint32_t offset, const uint8_t *data, uint32_t len)
+{
+  uint8_t cur[PARA_PAGE_SIZE];
+
+  // programming only clears bits, like the flash
+  paraFileRead(cur, page * PARA_PAGE_SIZE + offset, len);
+
+  for (uint32_t i = 0; i < len; i++)
+  {
+    cur[i] &= data[i];
+  }
+
+  paraFileWrite(cur, page * PARA_PAGE_SIZE + offset, len);
+}
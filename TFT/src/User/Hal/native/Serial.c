@@ -0,0 +1,63 @@
+#include "Serial.h"
+#include "includes.h"
+
+// rx buffer, filled like the DMA of the boards would do
+DMA_CIRCULAR_BUFFER dmaL1Data[_UART_CNT] = {0};
+
+void Serial_ClearData(uint8_t port)
+{
+  dmaL1Data[port].rIndex = dmaL1Data[port].wIndex = dmaL1Data[port].cacheSize = 0;
+  dmaL1Data[port].lineIn = dmaL1Data[port].lineOut = 0;
+
+  if (dmaL1Data[port].cache != NULL)
+  {
+    memFree(dmaL1Data[port].cache);
+    dmaL1Data[port].cache = NULL;
+  }
+}
+
+void Serial_Config(uint8_t port, uint16_t cacheSize, uint32_t baudrate)
+{
+  Serial_ClearData(port);
+
+  dmaL1Data[port].cacheSize = cacheSize;
+  dmaL1Data[port].cache = memAlloc(MEM_SERIAL, cacheSize);
+  while (!dmaL1Data[port].cache);  // malloc failed
+
+  UART_Config(port, baudrate, 0);
+}
+
+void Serial_DeConfig(uint8_t port)
+{
+  Serial_ClearData(port);
+  UART_DeConfig(port);
+}
+
+// data sent to the TFT by a host: copied to the rx buffer like by the DMA, then counted like by the IDLE interrupt
+void NATIVE_SerialReceive(uint8_t port, const char *data)
+{
+  DMA_CIRCULAR_BUFFER *dmaL1 = &dmaL1Data[port];
+
+  if (dmaL1->cache == NULL)
+    return;
+
+  for (uint16_t wIndex = dmaL1->wIndex; *data != '\0'; data++)
+  {
+    dmaL1->cache[wIndex] = *data;
+    wIndex = (wIndex + 1 == dmaL1->cacheSize) ? 0 : wIndex + 1;
+    dmaL1->wIndex = wIndex;
+
+    if (*data == '\n')
+      dmaL1->lineIn++;
+  }
+}
+
+void Serial_Puts(uint8_t port, const char *s)
+{
+  UART_Puts(port, (uint8_t *)s);
+}
+
+void Serial_Putchar(uint8_t port, const char ch)
+{
+  UART_Write(port, ch);
+}
@@ -0,0 +1,29 @@
+#ifndef _SERIAL_H_
+#define _SERIAL_H_
+
+#include <stdint.h>
+#include "variants.h"  // for uint32_t etc...
+#include "uart.h"
+
+typedef struct
+{
+  char *cache;
+  volatile uint16_t wIndex;   // updated by the IDLE interrupt
+  uint16_t rIndex;
+  uint16_t cacheSize;
+  volatile uint16_t lineIn;   // lines received, counted by the IDLE interrupt
+  uint16_t lineOut;           // lines read
+} DMA_CIRCULAR_BUFFER;
+
+// complete lines waiting in the rx buffer
+#define Serial_LineCount(port) ((uint16_t)(dmaL1Data[port].lineIn - dmaL1Data[port].lineOut))
+
+extern DMA_CIRCULAR_BUFFER dmaL1Data[_UART_CNT];
+
+void Serial_Config(uint8_t port, uint16_t cacheSize, uint32_t baudrate);
+void Serial_DeConfig(uint8_t port);
+void Serial_Puts(uint8_t port, const char *s);
+void Serial_Putchar(uint8_t port, const char ch);
+void NATIVE_SerialReceive(uint8_t port, const char *data);
+
+#endif
@@ -0,0 +1,157 @@
+#include "lcd.h"
+#include "native_host.h"
+#include <stdbool.h>
+#include <stdlib.h>
+
+// MIPI DCS commands
+#define DCS_COLUMN_ADDR  0x2A
+#define DCS_PAGE_ADDR    0x2B
+#define DCS_MEMORY_WRITE 0x2C
+#define DCS_MEMORY_READ  0x2E
+#define DCS_ADDR_MODE    0x36
+#define DCS_READ_ID4     0xD3
+
+static uint16_t *lcdFrame = NULL;
+static uint8_t lcdCmd;
+static uint8_t lcdParam;           // index of the parameter of the current command
+static uint16_t lcdSx, lcdEx, lcdSy, lcdEy;
+static uint16_t lcdX, lcdY;        // current position of memory write / read
+static uint8_t lcdAddrMode, lcdAddrModeDefault;
+static bool lcdAddrModeSet = false;
+static uint8_t lcdRead[6];         // data of a memory or ID read, returned by 16 bits
+static uint8_t lcdReadIndex, lcdReadCount;
+
+void LCD_HardwareConfig(void)
+{
+  if (lcdFrame == NULL)
+    lcdFrame = calloc(LCD_WIDTH * LCD_HEIGHT, sizeof(uint16_t));
+
+  while (!lcdFrame);  // calloc failed
+}
+
+// pixel index on the panel, rotated 180 degrees if the address mode swaps both axes from the initial one
+static uint32_t lcdPixelIndex(uint16_t x, uint16_t y)
+{
+  if (((lcdAddrMode ^ lcdAddrModeDefault) & 0xC0) == 0xC0)
+  {
+    x = LCD_WIDTH - 1 - x;
+    y = LCD_HEIGHT - 1 - y;
+  }
+
+  return (uint32_t)y * LCD_WIDTH + x;
+}
+
+// advance the position inside the window, the same way as the controller
+static void lcdNextPixel(void)
+{
+  if (lcdX++ < lcdEx)
+    return;
+
+  lcdX = lcdSx;
+  if (lcdY++ >= lcdEy)
+    lcdY = lcdSy;
+}
+
+static void lcdReadPixel(void)
+{
+  uint16_t color = 0;
+
+  if (lcdX < LCD_WIDTH && lcdY < LCD_HEIGHT)
+    color = lcdFrame[lcdPixelIndex(lcdX, lcdY)];
+
+  lcdRead[2] = (color >> 8) & 0xF8;  // R
+  lcdRead[3] = (color >> 3) & 0xFC;  // G
+  lcdRead[4] = (color << 3) & 0xF8;  // B
+  lcdRead[5] = 0;
+  lcdReadIndex = 2;
+  lcdReadCount = 6;
+  lcdNextPixel();
+}
+
+void LCD_WR_REG(uint16_t data)
+{
+  lcdCmd = data;
+  lcdParam = 0;
+
+  switch (lcdCmd)
+  {
+    case DCS_MEMORY_WRITE:
+      lcdX = lcdSx;
+      lcdY = lcdSy;
+      nativeStats.windows++;
+      break;
+
+    case DCS_MEMORY_READ:
+      lcdX = lcdSx;
+      lcdY = lcdSy;
+      lcdRead[0] = lcdRead[1] = 0;  // dummy read
+      lcdReadIndex = 0;
+      lcdReadCount = 2;
+      break;
+
+    case DCS_READ_ID4:
+      lcdRead[0] = lcdRead[1] = 0;  // dummy read, then ID1
+      lcdRead[2] = 0x94;
+      lcdRead[3] = 0x88;
+      lcdReadIndex = 0;
+      lcdReadCount = 4;
+      break;
+  }
+}
+
+void LCD_WR_DATA(uint16_t data)
+{
+  switch (lcdCmd)
+  {
+    case DCS_MEMORY_WRITE:
+      if (lcdX < LCD_WIDTH && lcdY < LCD_HEIGHT)
+        lcdFrame[lcdPixelIndex(lcdX, lcdY)] = data;
+
+      nativeStats.pixels++;
+      lcdNextPixel();
+      break;
+
+    case DCS_COLUMN_ADDR:
+    case DCS_PAGE_ADDR:
+    {
+      uint16_t *addr = (lcdCmd == DCS_COLUMN_ADDR) ? (lcdParam < 2 ? &lcdSx : &lcdEx) : (lcdParam < 2 ? &lcdSy : &lcdEy);
+
+      *addr = (lcdParam & 1) ? ((*addr & 0xFF00) | (data & 0xFF)) : ((data & 0xFF) << 8);
+      lcdParam++;
+      break;
+    }
+
+    case DCS_ADDR_MODE:
+      lcdAddrMode = data;
+      if (!lcdAddrModeSet)
+      {
+        lcdAddrModeDefault = data;  // the first one is the 0 degree mode
+        lcdAddrModeSet = true;
+      }
+      break;
+  }
+}
+
+uint16_t LCD_RD_DATA(void)
+{
+  uint16_t data;
+
+  if (lcdCmd == DCS_MEMORY_READ && lcdReadIndex >= lcdReadCount)
+    lcdReadPixel();
+
+  if (lcdReadIndex >= lcdReadCount)
+    return 0;
+
+  if (lcdCmd == DCS_READ_ID4)  // one byte per read
+    return lcdRead[lcdReadIndex++];
+
+  data = lcdRead[lcdReadIndex] << 8 | lcdRead[lcdReadIndex + 1];
+  lcdReadIndex += 2;
+
+  return data;
+}
+
+const uint16_t *LCD_NativeFramebuffer(void)
+{
+  return lcdFrame;
+}
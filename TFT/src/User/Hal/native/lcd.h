@@ -0,0 +1,18 @@
+#ifndef _LCD_H_
+#define _LCD_H_
+
+#include <stdint.h>
+#include "variants.h"
+
+// The LCD of the native build is a RAM framebuffer behind an emulated MIPI DCS controller
+// (the ILI9488 command set), so the real LCD driver code runs unchanged.
+
+void LCD_WR_REG(uint16_t data);
+void LCD_WR_DATA(uint16_t data);
+
+void LCD_HardwareConfig(void);
+uint16_t LCD_RD_DATA(void);
+
+const uint16_t *LCD_NativeFramebuffer(void);  // LCD_WIDTH * LCD_HEIGHT RGB565 pixels, as seen on the panel
+
+#endif
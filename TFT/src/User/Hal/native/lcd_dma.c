@@ -0,0 +1,100 @@
+#include "lcd_dma.h"
+#include "lcd.h"
+#include "LCD_Init.h"
+#include "w25qxx.h"
+#include "os_timer.h"
+#include "my_misc.h"
+
+// no DMA on the native build, frames are read from the emulated SPI flash and written by CPU
+
+#define LCD_DMA_BUFFER_SIZE 256  // pixels read from the flash at once
+
+static LCD_FRAME_STATS frameStats;
+
+void LCD_DMA_Config(void)
+{
+}
+
+void lcd_frame_display(uint16_t sx, uint16_t sy, uint16_t w, uint16_t h, uint32_t addr)
+{
+  uint16_t buf[LCD_DMA_BUFFER_SIZE];
+  uint32_t start = OS_GetTimeUs();
+  uint32_t total = w * h;
+  uint16_t size;
+
+  if (total == 0)
+    return;
+
+  LCD_SetWindow(sx, sy, sx + w - 1, sy + h - 1);
+
+  for (uint32_t i = 0; i < total; i += size)
+  {
+    size = MIN(total - i, LCD_DMA_BUFFER_SIZE);
+    W25Qxx_ReadBuffer((uint8_t *)buf, addr + i * 2, size * 2);
+
+    for (uint16_t j = 0; j < size; j++)
+    {
+      LCD_WR_16BITS_DATA((buf[j] << 8) | (buf[j] >> 8));  // the flash data are big endian, like the SPI 16bit frames
+    }
+  }
+
+  frameStats.count++;
+  frameStats.time += OS_GetTimeUs() - start;
+}
+
+void lcd_image_display(uint16_t sx, uint16_t sy, uint32_t addr)
+{
+  uint16_t size[2];
+
+  W25Qxx_ReadBuffer((uint8_t *)size, addr, sizeof(size));
+  lcd_frame_display(sx, sy, size[0], size[1], addr + sizeof(size));
+}
+
+void lcd_frame_fill(uint16_t sx, uint16_t sy, uint16_t w, uint16_t h, uint16_t color)
+{
+  uint32_t start = OS_GetTimeUs();
+  uint32_t count = w * h;
+
+  if (count == 0)
+    return;
+
+  LCD_SetWindow(sx, sy, sx + w - 1, sy + h - 1);
+
+  while (count--)
+  {
+    LCD_WR_16BITS_DATA(color);
+  }
+
+  frameStats.fills++;
+  frameStats.time += OS_GetTimeUs() - start;
+}
+
+void lcd_frame_read(uint8_t *buf, uint32_t addr, uint16_t size)
+{
+  W25Qxx_ReadBytes(buf, addr, size);
+}
+
+bool lcd_frame_busy(void)
+{
+  return false;
+}
+
+void lcd_frame_wait(void)
+{
+}
+
+void lcd_frame_draw_wait(void)
+{
+}
+
+void lcd_frame_stats_reset(void)
+{
+  frameStats.count = 0;
+  frameStats.fills = 0;
+  frameStats.time = 0;
+}
+
+void lcd_frame_stats_get(LCD_FRAME_STATS *stats)
+{
+  *stats = frameStats;
+}
@@ -0,0 +1,32 @@
+#ifndef _LCD_DMA_H_
+#define _LCD_DMA_H_
+
+#include <stdbool.h>
+#include "variants.h"  // for uint16_t etc...
+
+typedef struct
+{
+  uint32_t count;  // frames drawn
+  uint32_t fills;  // rectangles filled
+  uint32_t time;   // time spent drawing frames and fills (us)
+} LCD_FRAME_STATS;
+
+void LCD_DMA_Config(void);
+
+// frames are queued and drawn by DMA in background on FSMC LCDs.
+// LCD_SetWindow() and the W25Qxx chip select wait for queued frames first
+void lcd_frame_display(uint16_t sx, uint16_t sy, uint16_t w, uint16_t h, uint32_t addr);
+void lcd_image_display(uint16_t sx, uint16_t sy, uint32_t addr);  // width and height read from the image header at addr
+void lcd_frame_fill(uint16_t sx, uint16_t sy, uint16_t w, uint16_t h, uint16_t color);  // by DMA if large enough
+
+// W25Qxx data read to RAM by DMA, queued with the frames. buf is filled once lcd_frame_wait() returns.
+// LCD_SetWindow() only waits for the frames (lcd_frame_draw_wait()), so the LCD can be written by CPU meanwhile
+void lcd_frame_read(uint8_t *buf, uint32_t addr, uint16_t size);
+bool lcd_frame_busy(void);
+void lcd_frame_wait(void);
+void lcd_frame_draw_wait(void);
+
+void lcd_frame_stats_reset(void);
+void lcd_frame_stats_get(LCD_FRAME_STATS *stats);
+
+#endif
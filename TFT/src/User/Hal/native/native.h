@@ -0,0 +1,43 @@
+#ifndef _NATIVE_H_
+#define _NATIVE_H_
+
+// Stand-in of the MCU header for the native (host) build.
+// It only provides the few core names used outside the HAL.
+
+#include <stdint.h>
+
+#define SET   1
+#define RESET 0
+
+typedef struct
+{
+  uint32_t SYSCLK_Frequency;
+  uint32_t HCLK_Frequency;
+  uint32_t PCLK1_Frequency;
+  uint32_t PCLK2_Frequency;
+} RCC_ClocksTypeDef;
+
+typedef struct
+{
+  uint32_t VTOR;
+} SCB_Type;
+
+extern SCB_Type nativeSCB;
+
+#define SCB (&nativeSCB)
+
+#define NVIC_PriorityGroup_2 0
+#define NVIC_PriorityGroupConfig(group)
+
+// there are no interrupts, the OS timer is polled by the main loop (see os_timer.c)
+#define __disable_irq()
+#define __enable_irq()
+#define __WFI() NATIVE_Sleep()  // sleep until the next ms, or a signal
+
+void SystemClockInit(void);
+void RCC_GetClocksFreq(RCC_ClocksTypeDef *clocks);
+
+void NATIVE_Sleep(void);
+char *strlwr(char *str);  // newlib extension missing in glibc
+
+#endif
@@ -0,0 +1,155 @@
+#include "native_host.h"
+#include "includes.h"
+
+#undef printf  // reports go to the host stdout, not through the debug serial port
+
+// Micro-benchmarks of the native build (TFT_NATIVE_RUN=bench): throughput of the printer responses
+// parsing, of the gcode queue round trip (store, send, "ok") and lookup, and of the GUI drawing primitives.
+// Times are host times: compare them between two builds on the same machine, not with the boards.
+
+#define BENCH_LINES 20000  // responses parsed
+#define BENCH_CMDS  5000   // gcodes queued and acknowledged
+#define BENCH_FINDS 100000 // gcodes looked up in the queue
+#define BENCH_DRAWS 200    // screens drawn
+
+static const char *const benchResponses[] = {
+  "ok T:210.00 /210.00 B:60.00 /60.00 @:127 B@:0\n",
+  "T:210.12 /210.00 B:59.87 /60.00 @:120 B@:12\n",
+  "echo:busy: processing\n",
+  "X:10.00 Y:20.00 Z:0.30 E:0.00 Count X:800 Y:1600 Z:120\n",
+  "ok\n",
+  "FR:100%\n",
+  "E0 Flow: 100%\n",
+  "ok\n",
+};
+
+static uint32_t benchStart;
+
+static void benchBegin(void)
+{
+  memset(&nativeStats, 0, sizeof(nativeStats));
+  benchStart = OS_GetTimeUs();
+}
+
+static void benchEnd(const char *name, uint32_t ops)
+{
+  uint32_t time = OS_GetTimeUs() - benchStart;
+
+  printf("%-22s %8lu ops %10lu ns/op %10lu pixels/op %8lu flash bytes/op\n", name, (unsigned long)ops,
+         (unsigned long)((uint64_t)time * 1000 / ops), (unsigned long)(nativeStats.pixels / ops),
+         (unsigned long)(nativeStats.flashBytes / ops));
+}
+
+// printer responses, a few lines at a time as they come between two parseACK() calls
+static void benchParse(void)
+{
+  uint32_t lines = 0;
+
+  benchBegin();
+  while (lines < BENCH_LINES)
+  {
+    for (uint8_t i = 0; i < COUNT(benchResponses); i++, lines++)
+    {
+      NATIVE_SerialReceive(SERIAL_PORT, benchResponses[i]);
+    }
+
+    parseACK();
+  }
+  benchEnd("parseACK", lines);
+
+  clearCmdQueue();  // drop the commands queued by the responses (e.g. temperature auto report setup)
+}
+
+// a gcode stored in the queue, sent to the printer and acknowledged by an "ok"
+static void benchQueue(void)
+{
+  benchBegin();
+  for (uint32_t i = 0; i < BENCH_CMDS; i++)
+  {
+    storeCmd("G1 X%lu Y10 F3000\n", (unsigned long)(i % 200));
+    sendQueueCmd();
+    NATIVE_SerialReceive(SERIAL_PORT, "ok\n");
+    parseACK();
+  }
+  benchEnd("store/send/ok", BENCH_CMDS);
+}
+
+// "already queued?" check of a status query, with the queue full of moves as while printing
+static void benchFind(void)
+{
+  const CMD query = "M105\n";
+  uint32_t found = 0;
+
+  for (uint32_t i = 0; !isFullCmdQueue(); i++)
+  {
+    storeCmd("G1 X%lu Y10 F3000\n", (unsigned long)i);
+  }
+
+  benchBegin();
+  for (uint32_t i = 0; i < BENCH_FINDS; i++)
+  {
+    found += isEnqueued(query);
+  }
+  benchEnd("isEnqueued", BENCH_FINDS + found);
+
+  clearCmdQueue();
+}
+
+static void benchDraw(void)
+{
+  const MENUITEMS items = {
+    LABEL_MAINMENU,
+    {
+      {ICON_HEAT_FAN,                LABEL_UNIFIEDHEAT},
+      {ICON_HOME_MOVE,               LABEL_UNIFIEDMOVE},
+      {ICON_EXTRUDE,                 LABEL_EXTRUDE},
+      {ICON_STOP,                    LABEL_EMERGENCYSTOP},
+      {ICON_GCODE,                   LABEL_TERMINAL},
+      {ICON_CUSTOM,                  LABEL_CUSTOM},
+      {ICON_SETTINGS,                LABEL_SETTINGS},
+      {ICON_BACK,                    LABEL_BACK},
+    }
+  };
+
+  benchBegin();
+  for (uint32_t i = 0; i < BENCH_DRAWS; i++)
+  {
+    GUI_FillRect(0, 0, LCD_WIDTH, LCD_HEIGHT);
+  }
+  benchEnd("GUI_FillRect screen", BENCH_DRAWS);
+
+  benchBegin();
+  for (uint32_t i = 0; i < BENCH_DRAWS * 10; i++)
+  {
+    GUI_DispString(0, 0, (uint8_t *)"T:210.00 /210.00 B:60.00 /60.00");
+  }
+  benchEnd("GUI_DispString line", BENCH_DRAWS * 10);
+
+  benchBegin();
+  for (uint32_t i = 0; i < BENCH_DRAWS; i++)
+  {
+    ICON_ReadDisplay(0, 0, ICON_HEAT_FAN);
+  }
+  benchEnd("ICON_ReadDisplay", BENCH_DRAWS);
+
+  benchBegin();
+  for (uint32_t i = 0; i < BENCH_DRAWS / 10; i++)
+  {
+    menuDrawPage(&items);
+  }
+  benchEnd("menuDrawPage", BENCH_DRAWS / 10);
+}
+
+void NATIVE_Bench(void)
+{
+  // the printer is connected by its first temperature report, with the queries that follow dropped
+  NATIVE_SerialReceive(SERIAL_PORT, benchResponses[1]);
+  parseACK();
+  clearCmdQueue();
+  infoHost.wait = false;
+
+  benchParse();
+  benchQueue();
+  benchFind();
+  benchDraw();
+}
@@ -0,0 +1,339 @@
+#include "native_host.h"
+#include "includes.h"
+#include <ctype.h>
+#include <unistd.h>
+
+#undef printf  // reports go to the host stdout, not through the debug serial port
+
+// Host side of the native build: system stand-ins, PNG snapshots of the LCD framebuffer
+// and a walk through the menus reporting the LCD and SPI flash traffic of each one.
+//
+// TFT_NATIVE_RUN selects what is done after boot:
+// - "walk" (default): the menu walk
+// - "bench": the benchmarks of native_bench.c
+// - "serve": nothing, the program runs until killed (e.g. driven by a host through TFT_NATIVE_PTY)
+// - "print": print the SD card file named by TFT_NATIVE_FILE once the printer is connected, then exit
+
+SCB_Type nativeSCB;
+NATIVE_STATS nativeStats;
+
+extern bool modeFreshBoot;
+
+#define NATIVE_MENU(name) {name, #name}
+
+// menus waiting for a touch outside of loopProcess() (e.g. menuInfo, menuTerminal) can't be part of the walk
+static const struct
+{
+  FP_MENU menu;
+  const char *name;
+} nativeMenus[] = {
+  NATIVE_MENU(menuStatus),
+  NATIVE_MENU(menuMain),
+  NATIVE_MENU(menuHeat),
+  NATIVE_MENU(menuFan),
+  NATIVE_MENU(menuSpeed),
+  NATIVE_MENU(menuMove),
+  NATIVE_MENU(menuExtrude),
+  NATIVE_MENU(menuSettings),
+  NATIVE_MENU(menuScreenSettings),
+  NATIVE_MENU(menuFeatureSettings),
+  NATIVE_MENU(menuMachineSettings),
+  NATIVE_MENU(menuConnectionSettings),
+  NATIVE_MENU(menuNotification),
+  NATIVE_MENU(menuPrint),
+};
+
+static uint32_t crcTable[256];
+
+void SystemClockInit(void)
+{
+  // reports are written by line, also when stdout is piped
+  setvbuf(stdout, NULL, _IOLBF, 0);
+
+  NATIVE_SDCardFromDir();
+}
+
+// fake clocks of an F2 board, only used to compute timer prescalers
+void RCC_GetClocksFreq(RCC_ClocksTypeDef *clocks)
+{
+  clocks->SYSCLK_Frequency = 120000000;
+  clocks->HCLK_Frequency = 120000000;
+  clocks->PCLK1_Frequency = 30000000;
+  clocks->PCLK2_Frequency = 60000000;
+}
+
+void NATIVE_Sleep(void)
+{
+  usleep(1000 - OS_GetTimeUs() % 1000);
+}
+
+char *strlwr(char *str)
+{
+  for (char *p = str; *p != '\0'; p++)
+    *p = tolower((unsigned char)*p);
+
+  return str;
+}
+
+const char *NATIVE_GetPath(const char *name)
+{
+  static char path[256];
+  const char *dir = getenv("TFT_NATIVE_DIR");
+
+  snprintf(path, sizeof(path), "%s/%s", (dir != NULL) ? dir : ".", name);
+  return path;
+}
+
+static uint32_t pngCrc(uint32_t crc, const uint8_t *data, uint32_t len)
+{
+  if (crcTable[1] == 0)
+  {
+    for (uint32_t i = 0; i < 256; i++)
+    {
+      uint32_t c = i;
+
+      for (uint8_t k = 0; k < 8; k++)
+        c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+
+      crcTable[i] = c;
+    }
+  }
+
+  crc = ~crc;
+  while (len--)
+    crc = crcTable[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+
+  return ~crc;
+}
+
+static void pngPut32(uint8_t *buf, uint32_t val)
+{
+  buf[0] = val >> 24;
+  buf[1] = val >> 16;
+  buf[2] = val >> 8;
+  buf[3] = val;
+}
+
+static void pngChunk(FILE *f, const char *type, const uint8_t *data, uint32_t len)
+{
+  uint8_t buf[4];
+  uint32_t crc = pngCrc(0, (const uint8_t *)type, 4);
+
+  crc = pngCrc(crc, data, len);
+
+  pngPut32(buf, len);
+  fwrite(buf, 1, 4, f);
+  fwrite(type, 1, 4, f);
+  fwrite(data, 1, len, f);
+  pngPut32(buf, crc);
+  fwrite(buf, 1, 4, f);
+}
+
+// write the framebuffer as an RGB PNG, the image data is zlib "stored" (not compressed)
+void NATIVE_Snapshot(const char *name)
+{
+  const uint16_t *frame = LCD_NativeFramebuffer();
+  const uint32_t rowSize = 1 + LCD_WIDTH * 3;  // filter byte + RGB pixels
+  const uint32_t rawSize = rowSize * LCD_HEIGHT;
+  const uint32_t blocks = (rawSize + 0xFFFF - 1) / 0xFFFF;
+  uint8_t *raw = malloc(rawSize);
+  uint8_t *idat = malloc(2 + blocks * 5 + rawSize + 4);
+  uint8_t ihdr[13] = {0};
+  uint32_t a = 1, b = 0;
+  uint32_t len = 0;
+  FILE *f;
+
+  if (frame == NULL || raw == NULL || idat == NULL || (f = fopen(NATIVE_GetPath(name), "wb")) == NULL)
+  {
+    free(raw);
+    free(idat);
+    return;
+  }
+
+  for (uint32_t y = 0; y < LCD_HEIGHT; y++)
+  {
+    uint8_t *row = raw + y * rowSize;
+
+    *row++ = 0;  // no filter
+    for (uint32_t x = 0; x < LCD_WIDTH; x++)
+    {
+      uint16_t color = frame[y * LCD_WIDTH + x];
+
+      *row++ = ((color >> 11) & 0x1F) * 255 / 31;
+      *row++ = ((color >> 5) & 0x3F) * 255 / 63;
+      *row++ = (color & 0x1F) * 255 / 31;
+    }
+  }
+
+  idat[len++] = 0x78;  // deflate, 32K window
+  idat[len++] = 0x01;
+  for (uint32_t i = 0; i < rawSize; i += 0xFFFF)
+  {
+    uint16_t size = MIN(rawSize - i, 0xFFFF);
+
+    idat[len++] = (i + size == rawSize);  // BFINAL, BTYPE = stored
+    idat[len++] = size;
+    idat[len++] = size >> 8;
+    idat[len++] = ~size;
+    idat[len++] = (uint16_t)~size >> 8;
+    memcpy(idat + len, raw + i, size);
+    len += size;
+  }
+
+  for (uint32_t i = 0; i < rawSize; i++)
+  {
+    a = (a + raw[i]) % 65521;
+    b = (b + a) % 65521;
+  }
+  pngPut32(idat + len, (b << 16) | a);
+  len += 4;
+
+  pngPut32(ihdr, LCD_WIDTH);
+  pngPut32(ihdr + 4, LCD_HEIGHT);
+  ihdr[8] = 8;  // bit depth
+  ihdr[9] = 2;  // truecolor
+
+  fwrite("\x89PNG\r\n\x1a\n", 1, 8, f);
+  pngChunk(f, "IHDR", ihdr, sizeof(ihdr));
+  pngChunk(f, "IDAT", idat, len);
+  pngChunk(f, "IEND", NULL, 0);
+  fclose(f);
+
+  free(raw);
+  free(idat);
+}
+
+static void nativeReport(const char *name, uint32_t time)
+{
+  printf("%-22s %8lu windows %10lu pixels %10lu flash bytes %6lu ms\n", name, (unsigned long)nativeStats.windows,
+         (unsigned long)nativeStats.pixels, (unsigned long)nativeStats.flashBytes, (unsigned long)time);
+
+  memset(&nativeStats, 0, sizeof(nativeStats));
+}
+
+void NATIVE_Exit(int status, const char *reason)
+{
+  NATIVE_Snapshot("snapshot_exit.png");
+  nativeReport("exit", OS_GetTimeMs());
+  printf("%s\n", reason);
+  exit(status);
+}
+
+// the print of a file from the SD card, started like an M23/M24 from a remote host and timed from its start
+// to the "ok" of the last gcode. Exits with 1 if the print can't be started
+static void nativePrint(void)
+{
+  static uint32_t startTime = 0;
+  const char *file = getenv("TFT_NATIVE_FILE");
+
+  if (startTime == 0)
+  {
+    #ifdef SHOW_BTT_BOOTSCREEN
+      if (modeFreshBoot)  // the boot screen is still displayed
+        return;
+    #endif
+
+    if (!infoHost.connected || isNotEmptyCmdQueue() || infoHost.wait)  // wait for the printer setup queries
+      return;
+
+    infoFile.source = FS_TFT_SD;
+    resetInfoFile();
+
+    if (file == NULL || !mountFS() || !enterFolder(file))
+      NATIVE_Exit(1, "print: no file");
+
+    startPrint();
+
+    if (!isPrinting())
+      NATIVE_Exit(1, "print: can't open the file");
+
+    printf("print: %s started\n", file);
+    startTime = OS_GetTimeMs();
+    return;
+  }
+
+  if (isPrinting() || isNotEmptyCmdQueue() || infoHost.wait)
+    return;
+
+  printf("print: %s done in %lu ms\n", file, (unsigned long)(OS_GetTimeMs() - startTime));
+  NATIVE_Exit(0, "print: done");
+}
+
+// called by loopProcess(): each menu (and the boot screen before them) is given NATIVE_SETTLE_MS
+// to draw, then it is captured with the LCD and flash traffic it generated and the next menu is opened
+void NATIVE_LoopProcess(void)
+{
+  static uint8_t step = 0;  // 0: boot screen, 1..: nativeMenus[step - 1]
+  static uint32_t startTime = 0;
+  static bool reported = false;
+  static NATIVE_STATS total;
+  static const char *run = NULL;
+
+  if (run == NULL)
+    run = (getenv("TFT_NATIVE_RUN") != NULL) ? getenv("TFT_NATIVE_RUN") : "walk";
+
+  if (infoMenu.menu[infoMenu.cur] == NULL)  // still booting (e.g. updating from the SD card), no menu yet
+    return;
+
+  if (strcmp(run, "serve") == 0)
+    return;
+
+  if (strcmp(run, "print") == 0)
+  {
+    nativePrint();
+    return;
+  }
+
+  if (strcmp(run, "bench") == 0)
+  {
+    #ifdef SHOW_BTT_BOOTSCREEN
+      if (modeFreshBoot)  // the boot screen is still displayed
+        return;
+    #endif
+
+    NATIVE_Bench();
+    exit(0);
+  }
+
+  if (reported)
+  {
+    #ifdef SHOW_BTT_BOOTSCREEN
+      if (modeFreshBoot)  // the boot screen is still displayed
+        return;
+    #endif
+
+    if (step > COUNT(nativeMenus))
+    {
+      printf("%-22s %8lu windows %10lu pixels %10lu flash bytes\n", "total", (unsigned long)total.windows,
+             (unsigned long)total.pixels, (unsigned long)total.flashBytes);
+      exit(0);
+    }
+
+    if (MENU_IS_NOT(nativeMenus[step - 1].menu))  // else the menu is already drawn (first menu after boot)
+    {
+      memset(&nativeStats, 0, sizeof(nativeStats));
+      REPLACE_MENU(nativeMenus[step - 1].menu);
+    }
+    startTime = OS_GetTimeMs();
+    reported = false;
+    return;
+  }
+
+  if (OS_GetTimeMs() - startTime < NATIVE_SETTLE_MS)
+    return;
+
+  total.windows += nativeStats.windows;
+  total.pixels += nativeStats.pixels;
+  total.flashBytes += nativeStats.flashBytes;
+
+  {
+    const char *name = (step == 0) ? "boot" : nativeMenus[step - 1].name;
+    char file[64];
+
+    snprintf(file, sizeof(file), "snapshot_%02d_%s.png", step, name);
+    NATIVE_Snapshot(file);
+    nativeReport(name, OS_GetTimeMs() - startTime);
+  }
+  step++;
+  reported = true;
+}
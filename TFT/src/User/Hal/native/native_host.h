@@ -0,0 +1,38 @@
+#ifndef _NATIVE_HOST_H_
+#define _NATIVE_HOST_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// files of the emulated hardware, kept in $TFT_NATIVE_DIR (current directory by default)
+#define NATIVE_FLASH_FILE  "w25qxx.bin"  // content of the W25Qxx SPI flash (icons, fonts, config etc...)
+#define NATIVE_PARA_FILE   "para.bin"    // user parameters, stored in the MCU flash on the boards
+#define NATIVE_SDCARD_FILE "sdcard.img"  // raw FAT image used as SD card, with the update folder
+#define NATIVE_SDCARD_DIR  "sdcard"      // content copied to a new SD card image when there is none
+
+#define NATIVE_SETTLE_MS 200  // time given to a menu to draw its content before it is captured
+
+typedef struct
+{
+  uint32_t windows;     // LCD windows opened (memory write commands)
+  uint32_t pixels;      // pixels written to the LCD
+  uint32_t flashBytes;  // bytes read from the SPI flash
+} NATIVE_STATS;
+
+extern NATIVE_STATS nativeStats;
+
+const char *NATIVE_GetPath(const char *name);
+void NATIVE_Snapshot(const char *name);
+void NATIVE_Exit(int status, const char *reason);
+void NATIVE_LoopProcess(void);
+void NATIVE_Bench(void);
+void NATIVE_SDCardFromDir(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
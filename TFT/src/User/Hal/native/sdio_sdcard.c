@@ -0,0 +1,139 @@
+#define _XOPEN_SOURCE 700  // for nftw()
+
+#include "sdio_sdcard.h"
+#include "native_host.h"
+#include "ff.h"
+#include <ftw.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SD_SECTOR_SIZE 512
+
+static FILE *sdFile = NULL;
+
+uint8_t SD_CD_Inserted(void)
+{
+  FILE *f = fopen(NATIVE_GetPath(NATIVE_SDCARD_FILE), "rb");
+
+  if (f == NULL)
+    return 0;
+
+  fclose(f);
+  return 1;
+}
+
+SD_Error SD_Init(void)
+{
+  SD_DeInit();
+
+  sdFile = fopen(NATIVE_GetPath(NATIVE_SDCARD_FILE), "r+b");
+  return (sdFile != NULL) ? SD_OK : SD_ERROR;
+}
+
+void SD_DeInit(void)
+{
+  if (sdFile == NULL)
+    return;
+
+  fclose(sdFile);
+  sdFile = NULL;
+}
+
+uint8_t SD_ReadDisk(uint8_t*buf,uint32_t sector,uint8_t cnt)
+{
+  if (sdFile == NULL || fseek(sdFile, (long)sector * SD_SECTOR_SIZE, SEEK_SET) != 0)
+    return 1;
+
+  return (fread(buf, SD_SECTOR_SIZE, cnt, sdFile) == cnt) ? 0 : 1;
+}
+
+uint8_t SD_WriteDisk(uint8_t*buf,uint32_t sector,uint8_t cnt)
+{
+  if (sdFile == NULL || fseek(sdFile, (long)sector * SD_SECTOR_SIZE, SEEK_SET) != 0)
+    return 1;
+
+  if (fwrite(buf, SD_SECTOR_SIZE, cnt, sdFile) != cnt)
+    return 1;
+
+  fflush(sdFile);
+  return 0;
+}
+
+static size_t sdDirLen;
+
+// copy a file or a directory of NATIVE_SDCARD_DIR to the same path of the SD card
+static int sdCopyEntry(const char *path, const struct stat *st, int type, struct FTW *ftw)
+{
+  char dst[256];
+  FILE *src;
+  FIL file;
+  UINT bw;
+  char buf[4096];
+  size_t len;
+
+  (void)st;
+  if (ftw->level == 0)  // NATIVE_SDCARD_DIR itself, the root of the SD card
+    return 0;
+
+  snprintf(dst, sizeof(dst), "SD:%s", path + sdDirLen);
+
+  if (type == FTW_D)
+    return (f_mkdir(dst) == FR_OK) ? 0 : -1;
+
+  if (type != FTW_F || (src = fopen(path, "rb")) == NULL)
+    return 0;  // skip links, special files etc...
+
+  if (f_open(&file, dst, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK)
+  {
+    fclose(src);
+    return -1;
+  }
+
+  while ((len = fread(buf, 1, sizeof(buf), src)) > 0 && f_write(&file, buf, len, &bw) == FR_OK && bw == len)
+  {
+  }
+
+  f_close(&file);
+  fclose(src);
+  return 0;
+}
+
+// build the SD card image from a host directory when there is no image yet,
+// the image is kept afterwards: delete it to build it again
+void NATIVE_SDCardFromDir(void)
+{
+  static BYTE work[FF_MAX_SS];
+  const MKFS_PARM opt = {FM_FAT32, 0, 1, 0, 0};
+  char dir[256];
+  struct stat st;
+  FATFS fs;
+  FILE *f;
+  int ok;
+
+  strcpy(dir, NATIVE_GetPath(NATIVE_SDCARD_DIR));
+  if (SD_CD_Inserted() || stat(dir, &st) != 0 || !S_ISDIR(st.st_mode))
+    return;
+
+  if ((f = fopen(NATIVE_GetPath(NATIVE_SDCARD_FILE), "wb")) == NULL)
+    return;
+
+  fseek(f, (long)NATIVE_SDCARD_SECTORS * SD_SECTOR_SIZE - 1, SEEK_SET);  // sparse file of the card size
+  fputc(0, f);
+  fclose(f);
+
+  sdDirLen = strlen(dir);
+  ok = f_mkfs("SD:", &opt, work, sizeof(work)) == FR_OK && f_mount(&fs, "SD:", 1) == FR_OK &&
+       nftw(dir, sdCopyEntry, 16, FTW_PHYS) == 0;
+
+  f_mount(NULL, "SD:", 0);
+  SD_DeInit();
+
+  if (!ok)
+  {
+    remove(NATIVE_GetPath(NATIVE_SDCARD_FILE));
+    printf("failed to build %s from %s\n", NATIVE_SDCARD_FILE, dir);
+    return;
+  }
+
+  printf("%s built from %s\n", NATIVE_SDCARD_FILE, dir);
+}
@@ -0,0 +1,24 @@
+#ifndef __SDIO_SDCARD_H
+#define __SDIO_SDCARD_H
+
+#include <stdint.h>
+
+// The SD card of the native build is a raw FAT image file (NATIVE_SDCARD_FILE),
+// inserted when the file exists. Without one, it is built from the NATIVE_SDCARD_DIR directory.
+
+#define NATIVE_SDCARD_SECTORS 131072  // 64 MB, the image file is sparse
+
+typedef enum
+{
+  SD_OK = 0,
+  SD_ERROR,
+} SD_Error;
+
+uint8_t SD_CD_Inserted(void);
+SD_Error SD_Init(void);
+void SD_DeInit(void);
+
+uint8_t SD_ReadDisk(uint8_t*buf,uint32_t sector,uint8_t cnt);   //Read SD card, fatfs / usb call
+uint8_t SD_WriteDisk(uint8_t*buf,uint32_t sector,uint8_t cnt);  //Write SD card, fatfs / usb call
+
+#endif
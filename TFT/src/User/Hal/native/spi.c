@@ -0,0 +1,224 @@
+#include "spi.h"
+#include "includes.h"  // for W25Qxx_CS_PIN, W25Qxx_SPI etc...
+#include "GPIO_Init.h"
+#include "native_host.h"
+
+// The W25Qxx SPI flash is emulated at command level, with the content kept in a file.
+// Other SPI devices are not connected and read 0xFF.
+
+#define W25QXX_EMU_ID   0xEF4018    // W25Q128
+#define W25QXX_EMU_SIZE MB(16)
+
+typedef enum
+{
+  FLASH_CMD = 0,
+  FLASH_ADDR,
+  FLASH_DUMMY,
+  FLASH_DATA,
+} FLASH_STATE;
+
+static uint8_t *flashMem = NULL;
+static FILE *flashFile = NULL;
+static bool flashSelected = false;
+static bool flashWEL = false;  // write enable latch
+static FLASH_STATE flashState;
+static uint8_t flashCmd;
+static uint8_t flashIndex;
+static uint32_t flashAddr;
+static uint32_t dirtyStart, dirtyEnd;  // area to write back to the file when deselected
+
+static void flashLoad(void)
+{
+  const char *path = NATIVE_GetPath(NATIVE_FLASH_FILE);
+
+  flashMem = malloc(W25QXX_EMU_SIZE);
+  while (!flashMem);  // malloc failed
+
+  memset(flashMem, 0xFF, W25QXX_EMU_SIZE);
+
+  flashFile = fopen(path, "r+b");
+  if (flashFile == NULL)
+    flashFile = fopen(path, "w+b");  // a new erased chip
+  else
+    fread(flashMem, 1, W25QXX_EMU_SIZE, flashFile);
+}
+
+static void flashDirty(uint32_t addr, uint32_t len)
+{
+  if (dirtyStart == dirtyEnd)
+  {
+    dirtyStart = addr;
+    dirtyEnd = addr + len;
+  }
+  else
+  {
+    dirtyStart = MIN(dirtyStart, addr);
+    dirtyEnd = MAX(dirtyEnd, addr + len);
+  }
+}
+
+// write back the modified area of the flash content to the file
+static void flashStore(void)
+{
+  if (flashFile == NULL || dirtyStart == dirtyEnd)
+    return;
+
+  fseek(flashFile, dirtyStart, SEEK_SET);
+  fwrite(flashMem + dirtyStart, 1, dirtyEnd - dirtyStart, flashFile);
+  fflush(flashFile);
+  dirtyStart = dirtyEnd = 0;
+}
+
+static void flashErase(uint32_t addr, uint32_t len)
+{
+  if (!flashWEL)
+    return;
+
+  addr &= ~(len - 1) & (W25QXX_EMU_SIZE - 1);
+  memset(flashMem + addr, 0xFF, len);
+  flashDirty(addr, len);
+}
+
+static uint8_t flashTransfer(uint8_t d)
+{
+  uint8_t ret = W25QXX_DUMMY_BYTE;
+
+  switch (flashState)
+  {
+    case FLASH_CMD:
+      flashCmd = d;
+      flashIndex = 0;
+      flashAddr = 0;
+
+      switch (flashCmd)
+      {
+        case CMD_WRITE_ENABLE:  flashWEL = true;  break;
+        case CMD_WRITE_DISABLE: flashWEL = false; break;
+        case CMD_FLASH__BE:     flashErase(0, W25QXX_EMU_SIZE); break;
+
+        case CMD_READ_ID:
+        case CMD_READ_REGISTER1:
+        case CMD_READ_REGISTER2:
+          flashState = FLASH_DATA;
+          break;
+
+        default:
+          flashState = FLASH_ADDR;
+          break;
+      }
+      break;
+
+    case FLASH_ADDR:
+      flashAddr = (flashAddr << 8) | d;
+      if (++flashIndex < 3)
+        break;
+
+      flashIndex = 0;
+      flashState = (flashCmd == CMD_FAST_READ_DATA) ? FLASH_DUMMY : FLASH_DATA;
+
+      if (flashCmd == CMD_SECTOR_ERASE)
+        flashErase(flashAddr, KB(4));
+      else if (flashCmd == CMD_BLOCK_ERASE)
+        flashErase(flashAddr, KB(64));
+      break;
+
+    case FLASH_DUMMY:
+      flashState = FLASH_DATA;
+      break;
+
+    case FLASH_DATA:
+      switch (flashCmd)
+      {
+        case CMD_READ_ID:
+          ret = (W25QXX_EMU_ID >> (16 - 8 * MIN(flashIndex++, 2))) & 0xFF;
+          break;
+
+        case CMD_READ_REGISTER1:
+          ret = flashWEL << 1;  // never busy
+          break;
+
+        case CMD_READ_REGISTER2:
+          ret = 0;
+          break;
+
+        case CMD_READ_DATA:
+        case CMD_FAST_READ_DATA:
+          ret = flashMem[flashAddr++ & (W25QXX_EMU_SIZE - 1)];
+          nativeStats.flashBytes++;
+          break;
+
+        case CMD_PAGE_PROGRAM:
+          if (flashWEL)
+          {
+            uint32_t addr = flashAddr & (W25QXX_EMU_SIZE - 1);
+
+            flashMem[addr] &= d;  // only 1 -> 0 without erase
+            flashDirty(addr, 1);
+            // the address wraps inside the page
+            flashAddr = (flashAddr & ~(W25QXX_SPI_PAGESIZE - 1)) | ((flashAddr + 1) & (W25QXX_SPI_PAGESIZE - 1));
+          }
+          break;
+      }
+      break;
+  }
+
+  return ret;
+}
+
+void SPI_NativeChipSelect(uint16_t io, uint8_t level)
+{
+  if (io != W25Qxx_CS_PIN)
+    return;
+
+  if (!level && !flashSelected)
+  {
+    flashState = FLASH_CMD;
+  }
+  else if (level && flashSelected)
+  {
+    if (flashCmd == CMD_PAGE_PROGRAM || flashCmd == CMD_SECTOR_ERASE ||
+        flashCmd == CMD_BLOCK_ERASE || flashCmd == CMD_FLASH__BE)
+      flashWEL = false;  // reset after a write or erase
+
+    flashStore();
+  }
+
+  flashSelected = !level;
+}
+
+void SPI_GPIO_Init(uint8_t port)
+{
+}
+
+void SPI_Protocol_Init(uint8_t port, uint8_t baudrate)
+{
+}
+
+void SPI_Config(uint8_t port)
+{
+  if (port == W25Qxx_SPI && flashMem == NULL)
+    flashLoad();
+}
+
+void SPI_DeConfig(uint8_t port)
+{
+}
+
+uint16_t SPI_Read_Write(uint8_t port, uint16_t d)
+{
+  if (port == W25Qxx_SPI && flashSelected && flashMem != NULL)
+    return flashTransfer(d);
+
+  return 0xFF;
+}
+
+void SPI_Transfer(uint8_t port, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+  for (uint16_t i = 0; i < len; i++)
+  {
+    uint8_t data = SPI_Read_Write(port, (tx != NULL) ? tx[i] : 0xFF);
+
+    if (rx != NULL)
+      rx[i] = data;
+  }
+}
@@ -0,0 +1,28 @@
+#include "spi_slave.h"
+#include <stddef.h>
+
+// there is no SPI slave hardware, data can be put into the queue by the native host instead
+
+static CIRCULAR_QUEUE *spi_queue = NULL;
+
+void SPI_Slave(CIRCULAR_QUEUE *queue)
+{
+  spi_queue = queue;
+  spi_queue->index_r = spi_queue->index_w = spi_queue->count = 0;
+}
+
+void SPI_SlaveDeInit(void)
+{
+  spi_queue = NULL;
+}
+
+bool SPI_SlaveGetData(uint8_t *data)
+{
+  if (spi_queue == NULL || spi_queue->index_r == spi_queue->index_w)
+    return false;
+
+  *data = spi_queue->data[spi_queue->index_r];
+  spi_queue->index_r = (spi_queue->index_r + 1) % CIRCULAR_QUEUE_SIZE;
+
+  return true;
+}
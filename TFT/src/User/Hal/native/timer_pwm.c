@@ -0,0 +1,11 @@
+#include "timer_pwm.h"
+
+// no PWM outputs (backlight, buzzer) on the native build
+
+void TIM_PWM_SetDutyCycle(uint16_t tim_ch, uint8_t duty)
+{
+}
+
+void TIM_PWM_Init(uint16_t tim_ch)
+{
+}
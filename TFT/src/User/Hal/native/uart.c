@@ -0,0 +1,84 @@
+#define _GNU_SOURCE  // for the pseudo terminals
+
+#include "uart.h"
+#include "includes.h"  // for SERIAL_DEBUG_PORT etc...
+#include <fcntl.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+#undef printf  // reports go to the host stdout, not through the debug serial port
+
+// the UARTs of the native build have no hardware behind them, only the debug port is printed to stdout.
+// With TFT_NATIVE_PTY set, the printer port is a pseudo terminal instead, a host program (a printer
+// emulator, Pronterface etc...) then talks to the TFT through the device name printed at start
+
+static int ptyFd = -1;
+
+void UART_Config(uint8_t port, uint32_t baud, uint16_t usart_it)
+{
+  struct termios tio;
+
+  if (port != SERIAL_PORT || ptyFd >= 0 || getenv("TFT_NATIVE_PTY") == NULL)
+    return;
+
+  if ((ptyFd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK)) < 0)
+    return;
+
+  if (grantpt(ptyFd) != 0 || unlockpt(ptyFd) != 0 || tcgetattr(ptyFd, &tio) != 0)
+  {
+    close(ptyFd);
+    ptyFd = -1;
+    return;
+  }
+
+  cfmakeraw(&tio);  // no echo and no line editing, like a real serial line
+  tcsetattr(ptyFd, TCSANOW, &tio);
+
+  printf("printer port: %s\n", ptsname(ptyFd));
+}
+
+void UART_DeConfig(uint8_t port)
+{
+}
+
+// bytes received from the pseudo terminal, run from the 1 ms tick like the IDLE interrupt of the boards
+void NATIVE_UartPoll(void)
+{
+  char buf[256];
+  ssize_t len;
+
+  if (ptyFd < 0)
+    return;
+
+  while ((len = read(ptyFd, buf, sizeof(buf) - 1)) > 0)
+  {
+    buf[len] = '\0';
+    NATIVE_SerialReceive(SERIAL_PORT, buf);
+  }
+}
+
+void UART_Write(uint8_t port, uint8_t d)
+{
+  if (port == SERIAL_PORT && ptyFd >= 0)
+    write(ptyFd, &d, 1);
+
+  #ifdef SERIAL_DEBUG_PORT
+    if (port == SERIAL_DEBUG_PORT)
+      putchar(d);
+  #endif
+}
+
+void UART_Puts(uint8_t port, uint8_t *str)
+{
+  if (port == SERIAL_PORT && ptyFd >= 0)
+  {
+    write(ptyFd, str, strlen((char *)str));
+    return;
+  }
+
+  while (*str)
+  {
+    UART_Write(port, *str++);
+  }
+}
@@ -0,0 +1,7 @@
+#ifndef __USB_CONF_H__
+#define __USB_CONF_H__
+
+// stand-in of the USB library header for the native build
+#include "usbh_usr.h"
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef __USBH_CORE_H__
+#define __USBH_CORE_H__
+
+// stand-in of the USB library header for the native build
+#include "usbh_usr.h"
+
+#endif
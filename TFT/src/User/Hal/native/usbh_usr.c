@@ -0,0 +1,34 @@
+#include "usbh_usr.h"
+
+void USB_Init(void)
+{
+}
+
+void USB_LoopProcess(void)
+{
+}
+
+uint8_t USB_IsDeviceConnected(void)
+{
+  return 0;
+}
+
+uint8_t USBH_USR_Inserted(void)
+{
+  return 0;
+}
+
+uint8_t USBH_UDISK_Status(void)
+{
+  return 1;
+}
+
+uint8_t USBH_UDISK_Read(uint8_t* buf, uint32_t sector, uint32_t cnt)
+{
+  return 1;
+}
+
+uint8_t USBH_UDISK_Write(uint8_t* buf, uint32_t sector, uint32_t cnt)
+{
+  return 1;
+}
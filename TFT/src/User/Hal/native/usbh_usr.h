@@ -0,0 +1,16 @@
+#ifndef __USBH_USR_H__
+#define __USBH_USR_H__
+
+#include <stdint.h>
+
+// There is no USB host on the native build, the USB disk is always removed.
+
+void USB_Init(void);
+void USB_LoopProcess(void);
+uint8_t USB_IsDeviceConnected(void);
+uint8_t USBH_USR_Inserted(void);
+uint8_t USBH_UDISK_Status(void);
+uint8_t USBH_UDISK_Read(uint8_t* buf, uint32_t sector, uint32_t cnt);
+uint8_t USBH_UDISK_Write(uint8_t* buf, uint32_t sector, uint32_t cnt);
+
+#endif
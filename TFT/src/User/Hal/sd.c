@@ -4,6 +4,8 @@
 #include "sd.h"
 #include "GPIO_Init.h"
 #include "spi.h"
+#include "lcd_dma.h"
+#include <stddef.h>
 
 uint8_t SD_Type = 0;  //SDCard type
 
@@ -21,6 +23,9 @@ uint8_t SD_SPI_Read_Write_Byte(uint8_t data)
 //Chip Select
 void SD_SPI_CS_Set(uint8_t level)
 {
+  #if SD_SPI == W25Qxx_SPI
+    lcd_frame_wait();  // the SPI is shared with the W25Qxx
+  #endif
   GPIO_SetLevel(SD_CS_PIN, level);
 }
 
@@ -135,11 +140,7 @@ uint8_t SD_Get_Ack(uint8_t Response)
 uint8_t SD_RecvData(uint8_t * buf, uint16_t len)
 {
   if (SD_Get_Ack(0xFE)) return 1;  //Wait for SD card to send back data start token 0xFE
-  while (len--)  //Start receiving data
-  {
-    *buf = SD_SPI_Read_Write_Byte(0xFF);
-    buf++;
-  }
+  SPI_Transfer(SD_SPI, NULL, buf, len);  //Start receiving data, by DMA if the SPI has it
   //Here are 2 pseudo CRCs��dummy CRC��
   SD_SPI_Read_Write_Byte(0xFF);
   SD_SPI_Read_Write_Byte(0xFF);
@@ -160,7 +161,7 @@ uint8_t SD_Send_Data(uint8_t * buf, uint8_t cmd)
   SD_SPI_Read_Write_Byte(cmd);
   if (cmd != 0XFD)  //Not an end instruction
   {
-    for (t = 0; t < 512; t++) SD_SPI_Read_Write_Byte(buf[t]);
+    SPI_Transfer(SD_SPI, buf, NULL, 512);  //by DMA if the SPI has it
 
     SD_SPI_Read_Write_Byte(0xFF);  //Ignore crc
     SD_SPI_Read_Write_Byte(0xFF);
@@ -374,12 +375,15 @@ uint8_t SD_ReadDisk(uint8_t * buf, uint32_t sector, uint8_t cnt)  //Read SD card
   else
   {
     r1 = SD_SendCmd(CMD18, sector, 0X01);  //Continuous read command
-    do
+    if (r1 == 0)  //Instruction sent successfully
     {
-      r1 = SD_RecvData(buf, 512);  //Receive 512 bytes
-      buf += 512;
-    } while (--cnt && r1 == 0);
-    SD_SendCmd(CMD12, 0, 0X01);  //Send stop command
+      do
+      {
+        r1 = SD_RecvData(buf, 512);  //Receive 512 bytes
+        buf += 512;
+      } while (--cnt && r1 == 0);
+      SD_SendCmd(CMD12, 0, 0X01);  //Send stop command
+    }
   }
   SD_Cancel_CS();  //Cancel film selection
   return r1;
@@ -1,7 +1,8 @@
 #include "HAL_Flash.h"
 #include "my_misc.h"
 
-#define SIGN_ADDRESS (0x08040000 - 0x800)  // reserve the last page (2KB) to save user parameters
+#define PARA_ADDRESS (0x08040000 - PARA_PAGE_COUNT * PARA_PAGE_SIZE)  // reserve the last pages (4KB) to save user parameters
+#define SIGN_ADDRESS (0x08040000 - 0x800)                              // user parameters of the previous releases
 
 void HAL_FlashRead(uint8_t *data, uint32_t len)
 {
@@ -12,15 +13,32 @@ void HAL_FlashRead(uint8_t *data, uint32_t len)
   }
 }
 
-void HAL_FlashWrite(uint8_t *data, uint32_t len)
+void HAL_FlashReadPage(uint8_t page, uint32_t offset, uint8_t *data, uint32_t len)
 {
+  uint32_t addr = PARA_ADDRESS + page * PARA_PAGE_SIZE + offset;
+  uint32_t i = 0;
+  for (i = 0; i < len; i++)
+  {
+    data[i] = *(volatile uint8_t*)(addr + i);
+  }
+}
+
+void HAL_FlashErasePage(uint8_t page)
+{
+  FLASH_Unlock();
+  FLASH_ErasePage(PARA_ADDRESS + page * PARA_PAGE_SIZE);
+  FLASH_Lock();
+}
+
+void HAL_FlashWritePage(uint8_t page, uint32_t offset, const uint8_t *data, uint32_t len)
+{
+  uint32_t addr = PARA_ADDRESS + page * PARA_PAGE_SIZE + offset;
   uint32_t i = 0;
   FLASH_Unlock();
-  FLASH_ErasePage(SIGN_ADDRESS);
   for (i = 0; i < len; i += 2)
   {
     uint16_t data16 = data[i] | (data[MIN(i+1, len-1)] << 8);  // stm32f10x needs to write at least 16 bits at a time
-    FLASH_ProgramHalfWord(SIGN_ADDRESS + i, data16);
+    FLASH_ProgramHalfWord(addr + i, data16);
   }
   FLASH_Lock();
 }
@@ -1,5 +1,5 @@
 #include "Serial.h"
-#include "includes.h"  // for infoHost
+#include "includes.h"
 
 // dma rx buffer
 DMA_CIRCULAR_BUFFER dmaL1Data[_UART_CNT] = {0};
@@ -42,14 +42,13 @@ void Serial_DMA_Config(uint8_t port)
 void Serial_ClearData(uint8_t port)
 {
   dmaL1Data[port].rIndex = dmaL1Data[port].wIndex = dmaL1Data[port].cacheSize = 0;
+  dmaL1Data[port].lineIn = dmaL1Data[port].lineOut = 0;
 
   if (dmaL1Data[port].cache != NULL)
   {
-    free(dmaL1Data[port].cache);
+    memFree(dmaL1Data[port].cache);
     dmaL1Data[port].cache = NULL;
   }
-
-  infoHost.rx_ok[port] = false;
 }
 
 void Serial_Config(uint8_t port, uint16_t cacheSize, uint32_t baudrate)
@@ -57,7 +56,7 @@ void Serial_Config(uint8_t port, uint16_t cacheSize, uint32_t baudrate)
   Serial_ClearData(port);
 
   dmaL1Data[port].cacheSize = cacheSize;
-  dmaL1Data[port].cache = malloc(cacheSize);
+  dmaL1Data[port].cache = memAlloc(MEM_SERIAL, cacheSize);
   while (!dmaL1Data[port].cache);              // malloc failed
 
   UART_Config(port, baudrate, USART_IT_IDLE);  // IDLE interrupt
@@ -79,12 +78,17 @@ void USART_IRQHandler(uint8_t port)
     Serial[port].uart->SR;
     Serial[port].uart->DR;
 
-    dmaL1Data[port].wIndex = dmaL1Data[port].cacheSize - Serial[port].dma_chanel->CNDTR;
-    uint16_t wIndex = (dmaL1Data[port].wIndex == 0) ? dmaL1Data[port].cacheSize : dmaL1Data[port].wIndex;
-    if (dmaL1Data[port].cache[wIndex - 1] == '\n')  // Receive completed
+    DMA_CIRCULAR_BUFFER *dmaL1 = &dmaL1Data[port];
+    uint16_t wIndex = dmaL1->cacheSize - Serial[port].dma_chanel->CNDTR;
+
+    // count the lines received since the previous IDLE, the data is read only once a line is complete
+    for (uint16_t i = dmaL1->wIndex; i != wIndex; i = (i + 1 == dmaL1->cacheSize) ? 0 : i + 1)
     {
-      infoHost.rx_ok[port] = true;
+      if (dmaL1->cache[i] == '\n')
+        dmaL1->lineIn++;
     }
+
+    dmaL1->wIndex = wIndex;
   }
 }
 
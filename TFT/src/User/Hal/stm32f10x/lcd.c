@@ -127,6 +127,20 @@ void LCD_WR_DATA(uint16_t data)
   LCD_CS_SET;
 }
 
+// write the same data count times, the bus is set once and only WR is toggled
+void LCD_WR_DATA_Fill(uint16_t data, uint32_t count)
+{
+  LCD_RS_SET;
+  LCD_CS_CLR;
+  DATAOUT(data);
+  while (count--)
+  {
+    LCD_WR_CLR;
+    LCD_WR_SET;
+  }
+  LCD_CS_SET;
+}
+
 uint16_t LCD_RD_DATA(void)
 {
   #if defined(MKS_TFT)
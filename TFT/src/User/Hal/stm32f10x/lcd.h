@@ -61,6 +61,7 @@
   #endif
   void LCD_WR_REG(uint16_t data);
   void LCD_WR_DATA(uint16_t data);
+  void LCD_WR_DATA_Fill(uint16_t data, uint32_t count);
 
 #endif
 
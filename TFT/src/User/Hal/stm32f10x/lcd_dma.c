@@ -4,40 +4,142 @@
 #include "spi.h"
 #include "LCD_Init.h"
 #include "w25qxx.h"
+#include "GPIO_Init.h"
 #include "delay.h"
+#include "os_timer.h"
+#include "my_misc.h"
+#include <stddef.h>
 
-#ifdef STM32_HAS_FSMC
 // Config for SPI Channel
 #if W25Qxx_SPI == _SPI1
-  #define W25QXX_SPI_NUM          SPI1
-  #define W25QXX_SPI_DMA_RCC_AHB  RCC_AHBPeriph_DMA1
-  #define W25QXX_SPI_DMA          DMA1
-  #define W25QXX_SPI_DMA_CHANNEL  DMA1_Channel2
-  #define W25QXX_SPI_DMA_IFCR_BIT 5
+  #define W25QXX_SPI_NUM            SPI1
+  #define W25QXX_SPI_DMA_RCC_AHB    RCC_AHBPeriph_DMA1
+  #define W25QXX_SPI_DMA            DMA1
+  #define W25QXX_SPI_DMA_CHANNEL    DMA1_Channel2
+  #define W25QXX_SPI_DMA_IFCR_BIT   5
+  #define W25QXX_SPI_DMA_IRQn       DMA1_Channel2_IRQn
+  #define W25QXX_SPI_DMA_IRQHandler DMA1_Channel2_IRQHandler
 #elif W25Qxx_SPI == _SPI2
-  #define W25QXX_SPI_NUM          SPI2
-  #define W25QXX_SPI_DMA          DMA1
-  #define W25QXX_SPI_DMA_RCC_AHB  RCC_AHBPeriph_DMA1
-  #define W25QXX_SPI_DMA_CHANNEL  DMA1_Channel4
-  #define W25QXX_SPI_DMA_IFCR_BIT 13
+  #define W25QXX_SPI_NUM            SPI2
+  #define W25QXX_SPI_DMA            DMA1
+  #define W25QXX_SPI_DMA_RCC_AHB    RCC_AHBPeriph_DMA1
+  #define W25QXX_SPI_DMA_CHANNEL    DMA1_Channel4
+  #define W25QXX_SPI_DMA_IFCR_BIT   13
+  #define W25QXX_SPI_DMA_IRQn       DMA1_Channel4_IRQn
+  #define W25QXX_SPI_DMA_IRQHandler DMA1_Channel4_IRQHandler
 #elif W25Qxx_SPI == _SPI3
-  #define W25QXX_SPI_NUM          SPI3
-  #define W25QXX_SPI_DMA          DMA2
-  #define W25QXX_SPI_DMA_RCC_AHB  RCC_AHBPeriph_DMA2
-  #define W25QXX_SPI_DMA_CHANNEL  DMA2_Channel1
-  #define W25QXX_SPI_DMA_IFCR_BIT 1
+  #define W25QXX_SPI_NUM            SPI3
+  #define W25QXX_SPI_DMA            DMA2
+  #define W25QXX_SPI_DMA_RCC_AHB    RCC_AHBPeriph_DMA2
+  #define W25QXX_SPI_DMA_CHANNEL    DMA2_Channel1
+  #define W25QXX_SPI_DMA_IFCR_BIT   1
+  #define W25QXX_SPI_DMA_IRQn       DMA2_Channel1_IRQn
+  #define W25QXX_SPI_DMA_IRQHandler DMA2_Channel1_IRQHandler
 #endif
 
+// the frame engine owns the W25Qxx SPI while busy, so it drives CS directly instead of W25Qxx_SPI_CS_Set()
+#define W25QXX_CS_SET(level) GPIO_SetLevel(W25Qxx_CS_PIN, level)
+
+static LCD_FRAME_STATS frameStats;
+
+// switch the SPI DMA between 16bit frames (to LCD_RAM or frameBuffer) and bytes to RAM for reads
+static void lcd_frame_dma_bytes(uint8_t *buf, bool bytes)
+{
+  W25QXX_SPI_DMA_CHANNEL->CCR &= ~((3<<10) | (3<<8) | (1<<7));
+
+  if (bytes)
+  {
+    W25QXX_SPI_DMA_CHANNEL->CMAR = (uint32_t)buf;
+    W25QXX_SPI_DMA_CHANNEL->CCR |= 1<<7;                             // Memory incremental mode, 8bit
+  }
+  else
+  {
+    #ifdef STM32_HAS_FSMC
+      W25QXX_SPI_DMA_CHANNEL->CMAR = (uint32_t)&LCD->LCD_RAM;
+      W25QXX_SPI_DMA_CHANNEL->CCR |= (LCD_DATA_16BIT<<10) | (LCD_DATA_16BIT<<8);
+    #else
+      W25QXX_SPI_DMA_CHANNEL->CCR |= (1<<10) | (1<<8) | (1<<7);      // frameBuffer, set with each chunk
+    #endif
+  }
+}
+
+// send the fast read command and address, then switch SPI to DMA rx only mode
+static void lcd_frame_spi_start(uint16_t size, uint32_t addr, uint8_t frame16)
+{
+  W25QXX_SPI_DMA_CHANNEL->CNDTR = size;
+
+  W25QXX_CS_SET(0);
+  W25Qxx_SPI_Read_Write_Byte(CMD_FAST_READ_DATA);
+  W25Qxx_SPI_Read_Write_Byte((uint8_t)((addr)>>16));
+  W25Qxx_SPI_Read_Write_Byte((uint8_t)((addr)>>8));
+  W25Qxx_SPI_Read_Write_Byte((uint8_t)addr);
+  W25Qxx_SPI_Read_Write_Byte(0XFF);  // 8 dummy clock
+
+  //set SPI to 16bit DMA rx only mode
+  W25QXX_SPI_NUM->CR1 &= ~(1<<6);
+  W25QXX_SPI_NUM->CR2 |= 1<<0;                // enable SPI rx DMA
+  W25QXX_SPI_NUM->CR1 |= frame16<<11;         // 16bit data frame
+  W25QXX_SPI_NUM->CR1 |= 1<<10;               // rx only
+
+  W25QXX_SPI_DMA_CHANNEL->CCR |= 1<<0;        // enable dma channel
+  W25QXX_SPI_NUM->CR1 |= 1<<6;                // enable SPI
+}
+
+static void lcd_frame_spi_stop(void)
+{
+  W25QXX_SPI_DMA_CHANNEL->CCR &= (uint32_t)(~(1<<0));
+  W25QXX_SPI_DMA->IFCR |= (uint32_t)(1<<W25QXX_SPI_DMA_IFCR_BIT);  // clear ISR for rx complete
+  W25QXX_CS_SET(1);
+
+  SPI_Protocol_Init(W25Qxx_SPI, W25Qxx_SPEED);  // Reset SPI clock and config again
+}
+
+#ifdef STM32_HAS_FSMC
+
+#define LCD_DMA_MAX_TRANS  65535  // DMA 65535 bytes one frame
+#define LCD_DMA_QUEUE_SIZE 16     // frames queued before lcd_frame_display() has to wait
+#define LCD_DMA_MIN_FILL   256    // smaller fills are faster done by CPU
+
+typedef enum
+{
+  FRAME_IMAGE = 0,
+  FRAME_FILL,
+  FRAME_READ,  // flash data to RAM, doesn't use the LCD
+} FRAME_TYPE;
+
+typedef struct
+{
+  uint16_t sx, sy;
+  uint16_t w, h;     // 0: read from the image header at addr. Bytes of a read in w
+  uint32_t addr;     // flash address, or color of a fill
+  uint8_t *buf;      // destination of a read
+  FRAME_TYPE type;
+} LCD_FRAME;
+
+static LCD_FRAME frameQueue[LCD_DMA_QUEUE_SIZE];
+static volatile uint8_t frameHead = 0;      // next frame to draw, moved by the DMA IRQ
+static volatile uint8_t frameTail = 0;      // next free slot, moved by the main loop
+static volatile bool frameBusy = false;
+static volatile uint8_t frameDraws = 0;     // queued frames drawing on the LCD, reads excluded
+static uint32_t frameCur, frameTotal, frameAddr;  // progress of the frame on the way
+static uint32_t frameStart;
+static FRAME_TYPE frameType;
+static uint8_t *frameBuf;
+static uint16_t fillColor;  // source of fill DMA
+
 // SPI --> FSMC DMA (LCD_RAM)
 // 16bits, SPI_RX to LCD_RAM.
 void LCD_DMA_Config(void)
 {
+  NVIC_InitTypeDef NVIC_InitStructure;
+
   RCC->AHBENR |= W25QXX_SPI_DMA_RCC_AHB;                         // Turn on the DMA clock
   Delay_ms(5);                                                   // Wait for the DMA clock to stabilize
   W25QXX_SPI_DMA_CHANNEL->CPAR = (uint32_t)&W25QXX_SPI_NUM->DR;  // The peripheral address is: SPI-> DR
   W25QXX_SPI_DMA_CHANNEL->CMAR = (uint32_t)&LCD->LCD_RAM;        // The target address is LCD_RAM
   W25QXX_SPI_DMA_CHANNEL->CNDTR = 0;                             // DMA1, the amount of data transferred, temporarily set to 0
   W25QXX_SPI_DMA_CHANNEL->CCR = 0X00000000;                      // Reset
+  W25QXX_SPI_DMA_CHANNEL->CCR |= 1<<1;                           // Transfer complete interrupt
   W25QXX_SPI_DMA_CHANNEL->CCR |= 0<<4;                           // Read from peripheral
   W25QXX_SPI_DMA_CHANNEL->CCR |= 0<<5;                           // Normal mode
   W25QXX_SPI_DMA_CHANNEL->CCR |= 0<<6;                           // Peripheral address non-incremental mode
@@ -46,52 +148,365 @@ void LCD_DMA_Config(void)
   W25QXX_SPI_DMA_CHANNEL->CCR |= LCD_DATA_16BIT<<10;             // Memory data width 16 bits
   W25QXX_SPI_DMA_CHANNEL->CCR |= 1<<12;                          // Medium priority
   W25QXX_SPI_DMA_CHANNEL->CCR |= 0<<14;                          // Non-memory to memory mode
+
+  // higher than the OS timer, so a frame in progress is always completed by lcd_frame_wait()
+  NVIC_InitStructure.NVIC_IRQChannel = W25QXX_SPI_DMA_IRQn;
+  NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+  NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+  NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+  NVIC_Init(&NVIC_InitStructure);
 }
 
-#define LCD_DMA_MAX_TRANS 65535  // DMA 65535 bytes one frame
+// start DMA transfer of the next segment of the current frame from SPI->DR to FSMC
+// a fill uses the same channel in memory to memory mode, with fillColor as constant source
+// the max bytes of one segment is LCD_DMA_MAX_TRANS 65535
+static void lcd_frame_segment_start(void)
+{
+  uint32_t size = MIN(frameTotal - frameCur, LCD_DMA_MAX_TRANS);
 
-// start DMA transfer from SPI->DR to FSMC
-// the max bytes of one frame is LCD_DMA_MAX_TRANS 65535
-void lcd_frame_segment_display(uint16_t size, uint32_t addr)
+  if (frameType == FRAME_READ)
+  {
+    lcd_frame_dma_bytes(frameBuf + frameCur, true);
+    lcd_frame_spi_start(size, frameAddr + frameCur, 0);
+  }
+  else if (frameType == FRAME_FILL)
+  {
+    W25QXX_SPI_DMA_CHANNEL->CNDTR = size;
+    W25QXX_SPI_DMA_CHANNEL->CPAR = (uint32_t)&fillColor;
+    W25QXX_SPI_DMA_CHANNEL->CCR |= 1<<14;     // memory to memory mode
+    W25QXX_SPI_DMA_CHANNEL->CCR |= 1<<0;      // enable dma channel
+  }
+  else
+  {
+    lcd_frame_spi_start(size, frameAddr + frameCur * (LCD_DATA_16BIT + 1), LCD_DATA_16BIT);
+  }
+  frameCur += size;
+}
+
+static void lcd_frame_segment_stop(void)
 {
-  W25QXX_SPI_DMA_CHANNEL->CNDTR = size;
+  if (frameType == FRAME_FILL)
+  {
+    W25QXX_SPI_DMA_CHANNEL->CCR &= (uint32_t)(~((1<<14) | (1<<0)));
+    W25QXX_SPI_DMA->IFCR |= (uint32_t)(1<<W25QXX_SPI_DMA_IFCR_BIT);  // clear ISR for transfer complete
+    W25QXX_SPI_DMA_CHANNEL->CPAR = (uint32_t)&W25QXX_SPI_NUM->DR;
+  }
+  else
+  {
+    lcd_frame_spi_stop();
 
-  W25Qxx_SPI_CS_Set(0);
-  W25Qxx_SPI_Read_Write_Byte(CMD_FAST_READ_DATA);
-  W25Qxx_SPI_Read_Write_Byte((uint8_t)((addr)>>16));
-  W25Qxx_SPI_Read_Write_Byte((uint8_t)((addr)>>8));
-  W25Qxx_SPI_Read_Write_Byte((uint8_t)addr);
-  W25Qxx_SPI_Read_Write_Byte(0XFF);  // 8 dummy clock
+    if (frameType == FRAME_READ)
+      lcd_frame_dma_bytes(NULL, false);
+  }
+}
 
-  //set SPI to 16bit DMA rx only mode
-  W25QXX_SPI_NUM->CR1 &= ~(1<<6);
-  W25QXX_SPI_NUM->CR2 |= 1<<0;                // enable SPI rx DMA
-  W25QXX_SPI_NUM->CR1 |= LCD_DATA_16BIT<<11;  // 16bit data frame
-  W25QXX_SPI_NUM->CR1 |= 1<<10;               // rx only
+// start the next queued frame, return false if there is none
+static bool lcd_frame_start(void)
+{
+  while (frameHead != frameTail)
+  {
+    LCD_FRAME frame = frameQueue[frameHead];
 
-  W25QXX_SPI_DMA_CHANNEL->CCR |= 1<<0;        // enable dma channel
-  W25QXX_SPI_NUM->CR1 |= 1<<6;                // enable SPI
+    frameHead = (frameHead + 1) % LCD_DMA_QUEUE_SIZE;
+    SPI_Protocol_Init(W25Qxx_SPI, W25Qxx_SPEED);  // the SPI may be left at another speed by a shared device
 
-  while ((W25QXX_SPI_DMA->ISR & (1<<W25QXX_SPI_DMA_IFCR_BIT)) == 0);  // wait for rx complete
-  W25QXX_SPI_DMA_CHANNEL->CCR &= (uint32_t)(~(1<<0));
-  W25QXX_SPI_DMA->IFCR |= (uint32_t)(1<<W25QXX_SPI_DMA_IFCR_BIT);     // clear ISR for rx complete
-  W25Qxx_SPI_CS_Set(1);
+    if (frame.type == FRAME_IMAGE && frame.w == 0)
+    { // read image size
+      W25QXX_CS_SET(0);
+      W25Qxx_SPI_Read_Write_Byte(CMD_FAST_READ_DATA);
+      W25Qxx_SPI_Read_Write_Byte((uint8_t)((frame.addr)>>16));
+      W25Qxx_SPI_Read_Write_Byte((uint8_t)((frame.addr)>>8));
+      W25Qxx_SPI_Read_Write_Byte((uint8_t)frame.addr);
+      W25Qxx_SPI_Read_Write_Byte(W25QXX_DUMMY_BYTE);
+      frame.w = W25Qxx_SPI_Read_Write_Byte(W25QXX_DUMMY_BYTE);
+      frame.w |= W25Qxx_SPI_Read_Write_Byte(W25QXX_DUMMY_BYTE) << 8;
+      frame.h = W25Qxx_SPI_Read_Write_Byte(W25QXX_DUMMY_BYTE);
+      frame.h |= W25Qxx_SPI_Read_Write_Byte(W25QXX_DUMMY_BYTE) << 8;
+      W25QXX_CS_SET(1);
+      frame.addr += 4;
+    }
 
-  SPI_Protocol_Init(W25Qxx_SPI, W25Qxx_SPEED);  // Reset SPI clock and config again
+    if (frame.w == 0 || frame.h == 0)
+    {
+      if (frame.type != FRAME_READ)
+        frameDraws--;
+      continue;
+    }
+
+    frameCur = 0;
+    frameType = frame.type;
+    frameAddr = frame.addr;
+
+    if (frame.type == FRAME_READ)
+    {
+      frameTotal = frame.w;
+      frameBuf = frame.buf;
+    }
+    else
+    {
+      pLCD_SetWindow(frame.sx, frame.sy, frame.sx + frame.w - 1, frame.sy + frame.h - 1);
+      frameTotal = (frame.type == FRAME_FILL) ? frame.w * frame.h : frame.w * frame.h * (2 - LCD_DATA_16BIT);
+      fillColor = frame.addr;
+    }
+    lcd_frame_segment_start();
+    return true;
+  }
+
+  return false;
+}
+
+void W25QXX_SPI_DMA_IRQHandler(void)
+{
+  if ((W25QXX_SPI_DMA->ISR & (1<<W25QXX_SPI_DMA_IFCR_BIT)) == 0)
+    return;
+
+  lcd_frame_segment_stop();
+
+  if (frameCur < frameTotal)
+  {
+    lcd_frame_segment_start();
+    return;
+  }
+
+  if (frameType != FRAME_READ)
+    frameDraws--;
+
+  if (!lcd_frame_start())
+  {
+    frameStats.time += OS_GetTimeUs() - frameStart;
+    frameBusy = false;
+  }
 }
 
-void lcd_frame_display(uint16_t sx,uint16_t sy,uint16_t w,uint16_t h, uint32_t addr)
+static void lcd_frame_queue(uint16_t sx, uint16_t sy, uint16_t w, uint16_t h, uint32_t addr, uint8_t *buf, FRAME_TYPE type)
 {
-  uint32_t cur=0;
-  uint32_t segmentSize;
-  uint32_t totalSize = w*h*(2-LCD_DATA_16BIT);
+  uint8_t next = (frameTail + 1) % LCD_DMA_QUEUE_SIZE;
 
-  LCD_SetWindow(sx,sy,sx+w-1,sy+h-1);
+  while (next == frameHead);  // queue is full, wait for the DMA IRQ to take a frame
 
-  for (cur = 0; cur < totalSize; cur += LCD_DMA_MAX_TRANS)
+  __disable_irq();
+  frameQueue[frameTail] = (LCD_FRAME){sx, sy, w, h, addr, buf, type};
+  frameTail = next;
+
+  if (type == FRAME_FILL)
+    frameStats.fills++;
+  else if (type == FRAME_IMAGE)
+    frameStats.count++;
+
+  if (type != FRAME_READ)
+    frameDraws++;
+
+  if (!frameBusy)
   {
-    segmentSize = (cur+LCD_DMA_MAX_TRANS)<=totalSize ? LCD_DMA_MAX_TRANS : totalSize-cur;
-    lcd_frame_segment_display(segmentSize, addr+cur*(LCD_DATA_16BIT + 1));
+    frameBusy = true;
+    frameStart = OS_GetTimeUs();
+    if (!lcd_frame_start())
+      frameBusy = false;
   }
+  __enable_irq();
 }
+
+void lcd_frame_display(uint16_t sx, uint16_t sy, uint16_t w, uint16_t h, uint32_t addr)
+{
+  if (w == 0 || h == 0)
+    return;
+
+  lcd_frame_queue(sx, sy, w, h, addr, NULL, FRAME_IMAGE);
+}
+
+void lcd_image_display(uint16_t sx, uint16_t sy, uint32_t addr)
+{
+  lcd_frame_queue(sx, sy, 0, 0, addr, NULL, FRAME_IMAGE);
+}
+
+void lcd_frame_fill(uint16_t sx, uint16_t sy, uint16_t w, uint16_t h, uint16_t color)
+{
+  uint32_t count = w * h;
+
+  if (count == 0)
+    return;
+
+  #if LCD_DATA_16BIT == 1  // 8bit LCDs need 2 different bytes per pixel
+    if (count >= LCD_DMA_MIN_FILL)
+    {
+      lcd_frame_queue(sx, sy, w, h, color, NULL, FRAME_FILL);
+      return;
+    }
+  #endif
+
+  LCD_SetWindow(sx, sy, sx + w - 1, sy + h - 1);
+
+  while (count--)
+  {
+    LCD_WR_16BITS_DATA(color);
+  }
+}
+
+void lcd_frame_read(uint8_t *buf, uint32_t addr, uint16_t size)
+{
+  if (size == 0)
+    return;
+
+  lcd_frame_queue(0, 0, size, 1, addr, buf, FRAME_READ);
+}
+
+bool lcd_frame_busy(void)
+{
+  return frameBusy;
+}
+
+void lcd_frame_wait(void)
+{
+  while (frameBusy);
+}
+
+void lcd_frame_draw_wait(void)
+{
+  while (frameDraws != 0);
+}
+
+void lcd_frame_stats_reset(void)
+{
+  __disable_irq();
+  frameStats.count = 0;
+  frameStats.fills = 0;
+  frameStats.time = 0;
+  frameStart = OS_GetTimeUs();
+  __enable_irq();
+}
+
+#else  // no FSMC, flash data are received by DMA in RAM, and written to LCD by CPU meanwhile
+
+#define LCD_DMA_BUFFER_SIZE 256  // pixels of each ping-pong buffer
+
+static uint16_t frameBuffer[2][LCD_DMA_BUFFER_SIZE];
+
+// SPI --> RAM DMA (frameBuffer)
+// 16bits, SPI_RX to RAM.
+void LCD_DMA_Config(void)
+{
+  RCC->AHBENR |= W25QXX_SPI_DMA_RCC_AHB;                         // Turn on the DMA clock
+  Delay_ms(5);                                                   // Wait for the DMA clock to stabilize
+  W25QXX_SPI_DMA_CHANNEL->CPAR = (uint32_t)&W25QXX_SPI_NUM->DR;  // The peripheral address is: SPI-> DR
+  W25QXX_SPI_DMA_CHANNEL->CNDTR = 0;                             // DMA1, the amount of data transferred, temporarily set to 0
+  W25QXX_SPI_DMA_CHANNEL->CCR = 0X00000000;                      // Reset
+  W25QXX_SPI_DMA_CHANNEL->CCR |= 0<<4;                           // Read from peripheral
+  W25QXX_SPI_DMA_CHANNEL->CCR |= 0<<5;                           // Normal mode
+  W25QXX_SPI_DMA_CHANNEL->CCR |= 0<<6;                           // Peripheral address non-incremental mode
+  W25QXX_SPI_DMA_CHANNEL->CCR |= 1<<7;                           // Memory incremental mode
+  W25QXX_SPI_DMA_CHANNEL->CCR |= 1<<8;                           // Peripheral data width is 16 bits
+  W25QXX_SPI_DMA_CHANNEL->CCR |= 1<<10;                          // Memory data width 16 bits
+  W25QXX_SPI_DMA_CHANNEL->CCR |= 1<<12;                          // Medium priority
+  W25QXX_SPI_DMA_CHANNEL->CCR |= 0<<14;                          // Non-memory to memory mode
+}
+
+static void lcd_frame_chunk_wait(void)
+{
+  while ((W25QXX_SPI_DMA->ISR & (1<<W25QXX_SPI_DMA_IFCR_BIT)) == 0);  // wait for rx complete
+  lcd_frame_spi_stop();
+}
+
+void lcd_frame_display(uint16_t sx, uint16_t sy, uint16_t w, uint16_t h, uint32_t addr)
+{
+  uint32_t start = OS_GetTimeUs();
+  uint32_t total = w * h;
+  uint16_t *prevBuf = frameBuffer[1];
+  uint16_t prevSize = 0;
+  uint16_t size;
+  uint8_t  cur = 0;
+
+  if (total == 0)
+    return;
+
+  LCD_SetWindow(sx, sy, sx + w - 1, sy + h - 1);
+
+  for (uint32_t i = 0; i < total; i += size)
+  {
+    size = MIN(total - i, LCD_DMA_BUFFER_SIZE);
+
+    W25QXX_SPI_DMA_CHANNEL->CMAR = (uint32_t)frameBuffer[cur];
+    lcd_frame_spi_start(size, addr + i * 2, 1);
+
+    // draw the previous chunk while the current one is received
+    for (uint16_t j = 0; j < prevSize; j++)
+    {
+      LCD_WR_16BITS_DATA(prevBuf[j]);
+    }
+
+    lcd_frame_chunk_wait();
+
+    prevBuf = frameBuffer[cur];
+    prevSize = size;
+    cur ^= 1;
+  }
+
+  for (uint16_t j = 0; j < prevSize; j++)
+  {
+    LCD_WR_16BITS_DATA(prevBuf[j]);
+  }
+
+  frameStats.count++;
+  frameStats.time += OS_GetTimeUs() - start;
+}
+
+// no DMA path to the GPIO bus LCD, the color is set on the bus once and burst out by WR strobes
+void lcd_frame_fill(uint16_t sx, uint16_t sy, uint16_t w, uint16_t h, uint16_t color)
+{
+  uint32_t start = OS_GetTimeUs();
+
+  if (w == 0 || h == 0)
+    return;
+
+  LCD_SetWindow(sx, sy, sx + w - 1, sy + h - 1);
+  LCD_WR_DATA_Fill(color, w * h);
+
+  frameStats.fills++;
+  frameStats.time += OS_GetTimeUs() - start;
+}
+
+void lcd_image_display(uint16_t sx, uint16_t sy, uint32_t addr)
+{
+  uint16_t size[2];
+
+  W25Qxx_ReadBuffer((uint8_t *)size, addr, sizeof(size));
+  lcd_frame_display(sx, sy, size[0], size[1], addr + sizeof(size));
+}
+
+// no background job without FSMC, the read is done on return
+void lcd_frame_read(uint8_t *buf, uint32_t addr, uint16_t size)
+{
+  if (size == 0)
+    return;
+
+  lcd_frame_dma_bytes(buf, true);
+  lcd_frame_spi_start(size, addr, 0);
+  lcd_frame_chunk_wait();
+  lcd_frame_dma_bytes(NULL, false);
+}
+
+bool lcd_frame_busy(void)
+{
+  return false;
+}
+
+void lcd_frame_wait(void)
+{
+}
+
+void lcd_frame_draw_wait(void)
+{
+}
+
+void lcd_frame_stats_reset(void)
+{
+  frameStats.count = 0;
+  frameStats.fills = 0;
+  frameStats.time = 0;
+}
+
 #endif
+
+void lcd_frame_stats_get(LCD_FRAME_STATS *stats)
+{
+  *stats = frameStats;
+}
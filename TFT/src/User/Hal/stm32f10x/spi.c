@@ -1,6 +1,8 @@
 #include "spi.h"
 #include "variants.h"  // for SPI1_SCK_PIN etc...
 #include "GPIO_Init.h"
+#include "uart.h"
+#include <stddef.h>
 
 // SPI1 default pins config
 #ifndef SPI1_SCK_PIN
@@ -57,6 +59,39 @@ static SPI_TypeDef* const spi[_SPI_CNT] = {
   SPI3,  // SCK--PB3   MISO--PB4   MOSI--PB5
 };
 
+// SPI DMA channels of SPI_Transfer(). The rx DMA of a serial port is always running, so the SPIs
+// sharing their tx channel with a serial port in use transfer by CPU instead
+#if SERIAL_PORT == _USART3 || (defined(SERIAL_PORT_2) && SERIAL_PORT_2 == _USART3) || \
+    (defined(SERIAL_PORT_3) && SERIAL_PORT_3 == _USART3) || (defined(SERIAL_PORT_4) && SERIAL_PORT_4 == _USART3)
+  #define SPI1_TX_DMA_CHANNEL NULL  // DMA1 channel 3 is the USART3 rx DMA
+#else
+  #define SPI1_TX_DMA_CHANNEL DMA1_Channel3
+#endif
+#if SERIAL_PORT == _USART1 || (defined(SERIAL_PORT_2) && SERIAL_PORT_2 == _USART1) || \
+    (defined(SERIAL_PORT_3) && SERIAL_PORT_3 == _USART1) || (defined(SERIAL_PORT_4) && SERIAL_PORT_4 == _USART1)
+  #define SPI2_TX_DMA_CHANNEL NULL  // DMA1 channel 5 is the USART1 rx DMA
+#else
+  #define SPI2_TX_DMA_CHANNEL DMA1_Channel5
+#endif
+
+#define SPI_DMA_MIN_TRANS 16  // shorter transfers are faster done by CPU
+
+typedef struct
+{
+  DMA_TypeDef *dma;
+  DMA_Channel_TypeDef *rx;
+  DMA_Channel_TypeDef *tx;  // NULL: the SPI transfers by CPU
+  uint8_t rxFlags;          // offset of the channel flags in IFCR
+  uint8_t txFlags;
+  uint32_t rcc;
+} SPI_DMA;
+
+static const SPI_DMA spi_dma[_SPI_CNT] = {
+  {DMA1, DMA1_Channel2, SPI1_TX_DMA_CHANNEL, 4, 8, RCC_AHBPeriph_DMA1},
+  {DMA1, DMA1_Channel4, SPI2_TX_DMA_CHANNEL, 12, 16, RCC_AHBPeriph_DMA1},
+  {DMA2, DMA2_Channel1, DMA2_Channel2, 0, 4, RCC_AHBPeriph_DMA2},
+};
+
 static const uint16_t spi_sck[_SPI_CNT]  = {SPI1_SCK_PIN,  SPI2_SCK_PIN,  SPI3_SCK_PIN};   // SCK
 static const uint16_t spi_miso[_SPI_CNT] = {SPI1_MISO_PIN, SPI2_MISO_PIN, SPI3_MISO_PIN};  // MISO
 static const uint16_t spi_mosi[_SPI_CNT] = {SPI1_MOSI_PIN, SPI2_MOSI_PIN, SPI3_MOSI_PIN};  // MOSI
@@ -122,3 +157,64 @@ uint16_t SPI_Read_Write(uint8_t port, uint16_t d)
   while ((spi[port]->SR & (1 << 0)) == RESET);  // wait for rx no empty
   return spi[port]->DR;
 }
+
+// transfer len bytes, tx NULL sends 0xFF and rx NULL drops the received bytes
+// the rx channel may be the one of the lcd_dma.c frame engine (W25Qxx on the same SPI), which must be idle
+void SPI_Transfer(uint8_t port, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+  static const uint8_t txDummy = 0xFF;
+  static uint8_t rxDummy;
+  const SPI_DMA *cfg = &spi_dma[port];
+  uint32_t rxCCR, rxCPAR, rxCMAR, rxCNDTR;
+
+  if (cfg->tx == NULL || len < SPI_DMA_MIN_TRANS)
+  {
+    for (uint16_t i = 0; i < len; i++)
+    {
+      while ((spi[port]->SR & (1 << 1)) == RESET);  // wait for tx empty
+      spi[port]->DR = (tx != NULL) ? tx[i] : 0xFF;
+      while ((spi[port]->SR & (1 << 0)) == RESET);  // wait for rx no empty
+      uint8_t data = spi[port]->DR;
+      if (rx != NULL)
+        rx[i] = data;
+    }
+    return;
+  }
+
+  RCC->AHBENR |= cfg->rcc;
+  // restored at the end for the frame engine, which doesn't set them all for each frame
+  rxCCR = cfg->rx->CCR & ~(1<<0);
+  rxCPAR = cfg->rx->CPAR;
+  rxCMAR = cfg->rx->CMAR;
+  rxCNDTR = cfg->rx->CNDTR;
+
+  cfg->rx->CCR = 0;
+  cfg->rx->CPAR = (uint32_t)&spi[port]->DR;
+  cfg->rx->CMAR = (uint32_t)((rx != NULL) ? rx : &rxDummy);
+  cfg->rx->CNDTR = len;
+  cfg->rx->CCR = (2<<12)                  // High priority, ahead of tx so rx never overruns
+               | ((rx != NULL)<<7);       // Memory increment, 8bit
+
+  cfg->tx->CCR = 0;
+  cfg->tx->CPAR = (uint32_t)&spi[port]->DR;
+  cfg->tx->CMAR = (uint32_t)((tx != NULL) ? tx : &txDummy);
+  cfg->tx->CNDTR = len;
+  cfg->tx->CCR = (1<<12)                  // Medium priority
+               | ((tx != NULL)<<7)        // Memory increment, 8bit
+               | (1<<4);                  // Read from memory
+
+  cfg->rx->CCR |= 1<<0;
+  cfg->tx->CCR |= 1<<0;
+  spi[port]->CR2 |= (1<<1) | (1<<0);      // tx and rx DMA requests, the transfer starts
+
+  while (cfg->rx->CNDTR != 0);            // the last byte received is also the last one sent
+
+  spi[port]->CR2 &= ~((1<<1) | (1<<0));
+  cfg->tx->CCR = 0;
+  cfg->rx->CCR = 0;
+  cfg->dma->IFCR = (0x0F << cfg->rxFlags) | (0x0F << cfg->txFlags);
+  cfg->rx->CPAR = rxCPAR;
+  cfg->rx->CMAR = rxCMAR;
+  cfg->rx->CNDTR = rxCNDTR;
+  cfg->rx->CCR = rxCCR;
+}
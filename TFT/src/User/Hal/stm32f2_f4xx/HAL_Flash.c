@@ -94,9 +94,19 @@ void HAL_FlashRead(uint8_t *data, uint32_t len)
   }
 }
 
-void HAL_FlashWrite(uint8_t *data, uint32_t len)
+// the log of the user parameters is in the sector of the single block of the previous releases
+void HAL_FlashReadPage(uint8_t page, uint32_t offset, uint8_t *data, uint32_t len)
 {
+  uint32_t addr = SIGN_ADDRESS + page * PARA_PAGE_SIZE + offset;
   uint32_t i = 0;
+  for (i = 0; i < len; i++)
+  {
+    data[i] = *(volatile uint8_t*)(addr + i);
+  }
+}
+
+void HAL_FlashErasePage(uint8_t page)
+{
   FLASH_Unlock();
 
 #ifdef MKS_TFT35_V1_0  // added for MKS_TFT35_V1_0 support
@@ -105,9 +115,17 @@ void HAL_FlashWrite(uint8_t *data, uint32_t len)
   FLASH_EraseSector(FLASH_SECTOR, VoltageRange_1);
 #endif
 
+  FLASH_Lock();
+}
+
+void HAL_FlashWritePage(uint8_t page, uint32_t offset, const uint8_t *data, uint32_t len)
+{
+  uint32_t addr = SIGN_ADDRESS + page * PARA_PAGE_SIZE + offset;
+  uint32_t i = 0;
+  FLASH_Unlock();
   for (i = 0; i < len; i++)
   {
-    FLASH_ProgramByte(SIGN_ADDRESS + i, data[i]);
+    FLASH_ProgramByte(addr + i, data[i]);
   }
   FLASH_Lock();
 }
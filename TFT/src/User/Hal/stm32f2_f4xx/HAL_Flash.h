@@ -3,6 +3,14 @@
 
 #include "variants.h"  // for uint8_t etc...
 
+// a single sector is free for the user parameters, before the firmware (or after it on MKS TFT35 V1.0)
+#ifdef MKS_TFT35_V1_0
+  #define PARA_PAGE_SIZE 0x20000  // 128KB
+#else
+  #define PARA_PAGE_SIZE 0x4000   // 16KB
+#endif
+#define PARA_PAGE_COUNT 1
+
 #ifdef MKS_TFT35_V1_0  // added for MKS TFT 35 V1.0 support
   #define ADDR_FLASH_SECTOR_0  ((uint32_t)0x08000000)  // Base @ of Sector 0, 16 Kbytes
   #define ADDR_FLASH_SECTOR_1  ((uint32_t)0x08004000)  // Base @ of Sector 1, 16 Kbytes
@@ -30,7 +38,12 @@
   #define ADDR_FLASH_SECTOR_23 ((uint32_t)0x081E0000)  // Base @ of Sector 11, 128 Kbytes
 #endif
 
+// user parameters of the previous releases, stored as a single block
 void HAL_FlashRead(uint8_t *data, uint32_t len);
-void HAL_FlashWrite(uint8_t *data, uint32_t len);
+
+// pages keeping the log of the user parameters, written without erase only where still erased (0xFF)
+void HAL_FlashReadPage(uint8_t page, uint32_t offset, uint8_t *data, uint32_t len);
+void HAL_FlashErasePage(uint8_t page);
+void HAL_FlashWritePage(uint8_t page, uint32_t offset, const uint8_t *data, uint32_t len);
 
 #endif
@@ -4,7 +4,11 @@
 #include "spi.h"
 #include "LCD_Init.h"
 #include "w25qxx.h"
+#include "GPIO_Init.h"
 #include "delay.h"
+#include "os_timer.h"
+#include "my_misc.h"
+#include <stddef.h>
 
 #ifdef STM32_HAS_FSMC
 // Config for SPI Channel
@@ -18,6 +22,8 @@
   #define W25QXX_SPI_DMA_CHANNEL      3
   #define W25QXX_SPI_DMA_READING()    (DMA2->LISR & (1<<5)) == 0
   #define W25QXX_SPI_DMA_CLEAR_FLAG() DMA2->LIFCR = 0x3F           // bit:0-5
+  #define W25QXX_SPI_DMA_IRQn         DMA2_Stream0_IRQn
+  #define W25QXX_SPI_DMA_IRQHandler   DMA2_Stream0_IRQHandler
 #elif W25Qxx_SPI == _SPI2
   #define W25QXX_SPI_NUM              SPI2
   #define W25QXX_SPI_DMA_RCC_AHB      RCC_AHB1Periph_DMA1
@@ -25,6 +31,8 @@
   #define W25QXX_SPI_DMA_CHANNEL      0
   #define W25QXX_SPI_DMA_READING()    (DMA1->LISR & (1<<27)) == 0
   #define W25QXX_SPI_DMA_CLEAR_FLAG() DMA1->LIFCR = (0xFC<<20)     // bit:22-27
+  #define W25QXX_SPI_DMA_IRQn         DMA1_Stream3_IRQn
+  #define W25QXX_SPI_DMA_IRQHandler   DMA1_Stream3_IRQHandler
 #elif W25Qxx_SPI == _SPI3
   #define W25QXX_SPI_NUM              SPI3
   #define W25QXX_SPI_DMA_RCC_AHB      RCC_AHB1Periph_DMA1
@@ -32,12 +40,58 @@
   #define W25QXX_SPI_DMA_CHANNEL      0
   #define W25QXX_SPI_DMA_READING()   (DMA1->LISR & (1<<5)) == 0
   #define W25QXX_SPI_DMA_CLEAR_FLAG() DMA1->LIFCR = 0x3F           // bit:0-5
+  #define W25QXX_SPI_DMA_IRQn         DMA1_Stream0_IRQn
+  #define W25QXX_SPI_DMA_IRQHandler   DMA1_Stream0_IRQHandler
 #endif
 
+// Memory to memory is only possible with DMA2, so fills use a free stream of it
+#define LCD_FILL_DMA_STREAM         DMA2_Stream7
+#define LCD_FILL_DMA_READING()      (DMA2->HISR & (1<<27)) == 0
+#define LCD_FILL_DMA_CLEAR_FLAG()   DMA2->HIFCR = (0xFC<<20)       // bit:22-27
+#define LCD_FILL_DMA_IRQn           DMA2_Stream7_IRQn
+#define LCD_FILL_DMA_IRQHandler     DMA2_Stream7_IRQHandler
+
+// the frame engine owns the W25Qxx SPI while busy, so it drives CS directly instead of W25Qxx_SPI_CS_Set()
+#define W25QXX_CS_SET(level) GPIO_SetLevel(W25Qxx_CS_PIN, level)
+
+#define LCD_DMA_MAX_TRANS  65535  // DMA 65535 bytes one frame
+#define LCD_DMA_QUEUE_SIZE 16     // frames queued before lcd_frame_display() has to wait
+#define LCD_DMA_MIN_FILL   256    // smaller fills are faster done by CPU
+
+typedef enum
+{
+  FRAME_IMAGE = 0,
+  FRAME_FILL,
+  FRAME_READ,  // flash data to RAM, doesn't use the LCD
+} FRAME_TYPE;
+
+typedef struct
+{
+  uint16_t sx, sy;
+  uint16_t w, h;     // 0: read from the image header at addr. Bytes of a read in w
+  uint32_t addr;     // flash address, or color of a fill
+  uint8_t *buf;      // destination of a read
+  FRAME_TYPE type;
+} LCD_FRAME;
+
+static LCD_FRAME frameQueue[LCD_DMA_QUEUE_SIZE];
+static volatile uint8_t frameHead = 0;      // next frame to draw, moved by the DMA IRQ
+static volatile uint8_t frameTail = 0;      // next free slot, moved by the main loop
+static volatile bool frameBusy = false;
+static volatile uint8_t frameDraws = 0;     // queued frames drawing on the LCD, reads excluded
+static uint32_t frameCur, frameTotal, frameAddr;  // progress of the frame on the way
+static uint32_t frameStart;
+static FRAME_TYPE frameType;
+static uint8_t *frameBuf;
+static uint16_t fillColor;  // source of fill DMA
+static LCD_FRAME_STATS frameStats;
+
 // SPI --> FSMC DMA (LCD_RAM)
 // 16bits, SPI_RX to LCD_RAM.
 void LCD_DMA_Config(void)
 {
+  NVIC_InitTypeDef NVIC_InitStructure;
+
   RCC->AHB1ENR |= W25QXX_SPI_DMA_RCC_AHB;                      // Turn on the DMA clock
   Delay_ms(5);                                                 // Wait for the DMA clock to stabilize
   W25QXX_SPI_DMA_STREAM->PAR = (uint32_t)&W25QXX_SPI_NUM->DR;  // The peripheral address is: SPI-> DR
@@ -53,17 +107,73 @@ void LCD_DMA_Config(void)
   W25QXX_SPI_DMA_STREAM->CR |= 0<<10;                          // Memory non-incremental mode
   W25QXX_SPI_DMA_STREAM->CR |= 0<<9;                           // Peripheral address non-incremental mode
   W25QXX_SPI_DMA_STREAM->CR |= 0<<6;                           // Non-memory to memory mode
+  W25QXX_SPI_DMA_STREAM->CR |= 1<<4;                           // Transfer complete interrupt
+
+  // fillColor --> FSMC DMA (LCD_RAM)
+  RCC->AHB1ENR |= RCC_AHB1Periph_DMA2;
+  LCD_FILL_DMA_STREAM->PAR = (uint32_t)&fillColor;             // The source address is fillColor
+  LCD_FILL_DMA_STREAM->M0AR = (uint32_t)&LCD->LCD_RAM;         // The target address is LCD_RAM
+  LCD_FILL_DMA_STREAM->NDTR = 0;
+  LCD_FILL_DMA_STREAM->CR = 1<<16;                             // Priority level: Medium
+  LCD_FILL_DMA_STREAM->CR |= 1<<13;                            // Memory data width 16 bits
+  LCD_FILL_DMA_STREAM->CR |= 1<<11;                            // Peripheral data width is 16 bits
+  LCD_FILL_DMA_STREAM->CR |= 0<<10;                            // Memory non-incremental mode
+  LCD_FILL_DMA_STREAM->CR |= 0<<9;                             // Peripheral address non-incremental mode
+  LCD_FILL_DMA_STREAM->CR |= 2<<6;                             // Memory to memory mode
+  LCD_FILL_DMA_STREAM->CR |= 1<<4;                             // Transfer complete interrupt
+  LCD_FILL_DMA_STREAM->FCR = (1<<2) | 3;                       // FIFO mode with full threshold, direct mode is not allowed
+
+  // higher than the OS timer, so a frame in progress is always completed by lcd_frame_wait()
+  NVIC_InitStructure.NVIC_IRQChannel = W25QXX_SPI_DMA_IRQn;
+  NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+  NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+  NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+  NVIC_Init(&NVIC_InitStructure);
+
+  NVIC_InitStructure.NVIC_IRQChannel = LCD_FILL_DMA_IRQn;
+  NVIC_Init(&NVIC_InitStructure);
 }
 
-#define LCD_DMA_MAX_TRANS 65535  // DMA 65535 bytes one frame
+// switch the SPI DMA between SPI->DR to FSMC (LCD_RAM) and SPI->DR to RAM (frameBuf, bytes) for reads
+static void lcd_frame_dma_target(bool toRam)
+{
+  W25QXX_SPI_DMA_STREAM->CR &= ~((3<<13) | (3<<11) | (1<<10));
 
-// start DMA transfer from SPI->DR to FSMC
-// the max bytes of one frame is LCD_DMA_MAX_TRANS 65535
-void lcd_frame_segment_display(uint16_t size, uint32_t addr)
+  if (toRam)
+  {
+    W25QXX_SPI_DMA_STREAM->M0AR = (uint32_t)(frameBuf + frameCur);
+    W25QXX_SPI_DMA_STREAM->CR |= 1<<10;                                    // Memory incremental mode, 8bit
+  }
+  else
+  {
+    W25QXX_SPI_DMA_STREAM->M0AR = (uint32_t)&LCD->LCD_RAM;
+    W25QXX_SPI_DMA_STREAM->CR |= (LCD_DATA_16BIT<<13) | (LCD_DATA_16BIT<<11);  // Memory and peripheral data width
+  }
+}
+
+// start DMA transfer of the next segment of the current frame from SPI->DR (or fillColor) to FSMC, or to RAM for reads
+// the max bytes of one segment is LCD_DMA_MAX_TRANS 65535
+static void lcd_frame_segment_start(void)
 {
+  uint32_t size = MIN(frameTotal - frameCur, LCD_DMA_MAX_TRANS);
+  uint8_t frame16 = (frameType == FRAME_READ) ? 0 : LCD_DATA_16BIT;
+  uint32_t addr = frameAddr + frameCur * (frame16 + 1);
+
+  if (frameType == FRAME_READ)
+    lcd_frame_dma_target(true);
+
+  frameCur += size;
+
+  if (frameType == FRAME_FILL)
+  {
+    LCD_FILL_DMA_STREAM->NDTR = size;
+    LCD_FILL_DMA_STREAM->CR |= 1<<0;                 // enable dma channel
+    return;
+  }
+
   W25QXX_SPI_DMA_STREAM->NDTR = size;
 
-  W25Qxx_SPI_CS_Set(0);
+  W25QXX_CS_SET(0);
   W25Qxx_SPI_Read_Write_Byte(CMD_FAST_READ_DATA);
   W25Qxx_SPI_Read_Write_Byte((uint8_t)((addr)>>16));
   W25Qxx_SPI_Read_Write_Byte((uint8_t)((addr)>>8));
@@ -73,32 +183,223 @@ void lcd_frame_segment_display(uint16_t size, uint32_t addr)
   //set SPI to 16bit DMA rx only mode
   W25QXX_SPI_NUM->CR1 &= ~(1<<6);                    // disable SPI
   W25QXX_SPI_NUM->CR2 |= 1<<0;                       // enable SPI rx DMA
-  W25QXX_SPI_NUM->CR1 |= LCD_DATA_16BIT<<11;         // 16bit data frame
+  W25QXX_SPI_NUM->CR1 |= frame16<<11;                // 16bit data frame
   W25QXX_SPI_NUM->CR1 |= 1<<10;                      // rx only
 
   W25QXX_SPI_DMA_STREAM->CR |= 1<<0;                 // enable dma channel
   W25QXX_SPI_NUM->CR1 |= 1<<6;                       // enable SPI
+}
+
+static void lcd_frame_segment_stop(void)
+{
+  if (frameType == FRAME_FILL)
+  {
+    LCD_FILL_DMA_STREAM->CR &= (uint32_t)(~(1<<0));
+    LCD_FILL_DMA_CLEAR_FLAG();
+    return;
+  }
 
-  while (W25QXX_SPI_DMA_READING());                  // wait for rx complete
   W25QXX_SPI_DMA_STREAM->CR &= (uint32_t)(~(1<<0));
   W25QXX_SPI_DMA_CLEAR_FLAG();                       // clear ISR for rx complete
-  W25Qxx_SPI_CS_Set(1);
+  W25QXX_CS_SET(1);
+
+  if (frameType == FRAME_READ)
+    lcd_frame_dma_target(false);
 
   SPI_Protocol_Init(W25Qxx_SPI, W25Qxx_SPEED);       // Reset SPI clock and config again
 }
 
-void lcd_frame_display(uint16_t sx,uint16_t sy,uint16_t w,uint16_t h, uint32_t addr)
+// start the next queued frame, return false if there is none
+static bool lcd_frame_start(void)
+{
+  while (frameHead != frameTail)
+  {
+    LCD_FRAME frame = frameQueue[frameHead];
+
+    frameHead = (frameHead + 1) % LCD_DMA_QUEUE_SIZE;
+    SPI_Protocol_Init(W25Qxx_SPI, W25Qxx_SPEED);  // the SPI may be left at another speed by a shared device
+
+    if (frame.type == FRAME_IMAGE && frame.w == 0)
+    { // read image size
+      W25QXX_CS_SET(0);
+      W25Qxx_SPI_Read_Write_Byte(CMD_FAST_READ_DATA);
+      W25Qxx_SPI_Read_Write_Byte((uint8_t)((frame.addr)>>16));
+      W25Qxx_SPI_Read_Write_Byte((uint8_t)((frame.addr)>>8));
+      W25Qxx_SPI_Read_Write_Byte((uint8_t)frame.addr);
+      W25Qxx_SPI_Read_Write_Byte(W25QXX_DUMMY_BYTE);
+      frame.w = W25Qxx_SPI_Read_Write_Byte(W25QXX_DUMMY_BYTE);
+      frame.w |= W25Qxx_SPI_Read_Write_Byte(W25QXX_DUMMY_BYTE) << 8;
+      frame.h = W25Qxx_SPI_Read_Write_Byte(W25QXX_DUMMY_BYTE);
+      frame.h |= W25Qxx_SPI_Read_Write_Byte(W25QXX_DUMMY_BYTE) << 8;
+      W25QXX_CS_SET(1);
+      frame.addr += 4;
+    }
+
+    if (frame.w == 0 || frame.h == 0)
+    {
+      if (frame.type != FRAME_READ)
+        frameDraws--;
+      continue;
+    }
+
+    frameCur = 0;
+    frameType = frame.type;
+    frameAddr = frame.addr;
+
+    if (frame.type == FRAME_READ)
+    {
+      frameTotal = frame.w;
+      frameBuf = frame.buf;
+    }
+    else
+    {
+      pLCD_SetWindow(frame.sx, frame.sy, frame.sx + frame.w - 1, frame.sy + frame.h - 1);
+      frameTotal = (frame.type == FRAME_FILL) ? frame.w * frame.h : frame.w * frame.h * (2 - LCD_DATA_16BIT);
+      fillColor = frame.addr;
+    }
+    lcd_frame_segment_start();
+    return true;
+  }
+
+  return false;
+}
+
+// continue with the next segment or frame, called by the DMA IRQ of the segment just done
+static void lcd_frame_next(void)
+{
+  lcd_frame_segment_stop();
+
+  if (frameCur < frameTotal)
+  {
+    lcd_frame_segment_start();
+    return;
+  }
+
+  if (frameType != FRAME_READ)
+    frameDraws--;
+
+  if (!lcd_frame_start())
+  {
+    frameStats.time += OS_GetTimeUs() - frameStart;
+    frameBusy = false;
+  }
+}
+
+void W25QXX_SPI_DMA_IRQHandler(void)
+{
+  if (W25QXX_SPI_DMA_READING())
+    return;
+
+  lcd_frame_next();
+}
+
+void LCD_FILL_DMA_IRQHandler(void)
 {
-  uint32_t cur=0;
-  uint32_t segmentSize;
-  uint32_t totalSize = w*h*(2-LCD_DATA_16BIT);
+  if (LCD_FILL_DMA_READING())
+    return;
+
+  lcd_frame_next();
+}
+
+static void lcd_frame_queue(uint16_t sx, uint16_t sy, uint16_t w, uint16_t h, uint32_t addr, uint8_t *buf, FRAME_TYPE type)
+{
+  uint8_t next = (frameTail + 1) % LCD_DMA_QUEUE_SIZE;
+
+  while (next == frameHead);  // queue is full, wait for the DMA IRQ to take a frame
+
+  __disable_irq();
+  frameQueue[frameTail] = (LCD_FRAME){sx, sy, w, h, addr, buf, type};
+  frameTail = next;
 
-  LCD_SetWindow(sx,sy,sx+w-1,sy+h-1);
+  if (type == FRAME_FILL)
+    frameStats.fills++;
+  else if (type == FRAME_IMAGE)
+    frameStats.count++;
 
-  for (cur = 0; cur < totalSize; cur += LCD_DMA_MAX_TRANS)
+  if (type != FRAME_READ)
+    frameDraws++;
+
+  if (!frameBusy)
   {
-    segmentSize = (cur+LCD_DMA_MAX_TRANS)<=totalSize ? LCD_DMA_MAX_TRANS : totalSize-cur;
-    lcd_frame_segment_display(segmentSize, addr+cur*(LCD_DATA_16BIT + 1));
+    frameBusy = true;
+    frameStart = OS_GetTimeUs();
+    if (!lcd_frame_start())
+      frameBusy = false;
   }
+  __enable_irq();
+}
+
+void lcd_frame_display(uint16_t sx, uint16_t sy, uint16_t w, uint16_t h, uint32_t addr)
+{
+  if (w == 0 || h == 0)
+    return;
+
+  lcd_frame_queue(sx, sy, w, h, addr, NULL, FRAME_IMAGE);
+}
+
+void lcd_image_display(uint16_t sx, uint16_t sy, uint32_t addr)
+{
+  lcd_frame_queue(sx, sy, 0, 0, addr, NULL, FRAME_IMAGE);
+}
+
+void lcd_frame_fill(uint16_t sx, uint16_t sy, uint16_t w, uint16_t h, uint16_t color)
+{
+  uint32_t count = w * h;
+
+  if (count == 0)
+    return;
+
+  #if LCD_DATA_16BIT == 1  // 8bit LCDs need 2 different bytes per pixel
+    if (count >= LCD_DMA_MIN_FILL)
+    {
+      lcd_frame_queue(sx, sy, w, h, color, NULL, FRAME_FILL);
+      return;
+    }
+  #endif
+
+  LCD_SetWindow(sx, sy, sx + w - 1, sy + h - 1);
+
+  while (count--)
+  {
+    LCD_WR_16BITS_DATA(color);
+  }
+}
+
+void lcd_frame_read(uint8_t *buf, uint32_t addr, uint16_t size)
+{
+  if (size == 0)
+    return;
+
+  lcd_frame_queue(0, 0, size, 1, addr, buf, FRAME_READ);
+}
+
+bool lcd_frame_busy(void)
+{
+  return frameBusy;
+}
+
+void lcd_frame_wait(void)
+{
+  while (frameBusy);
+}
+
+void lcd_frame_draw_wait(void)
+{
+  while (frameDraws != 0);
+}
+
+void lcd_frame_stats_reset(void)
+{
+  __disable_irq();
+  frameStats.count = 0;
+  frameStats.fills = 0;
+  frameStats.time = 0;
+  frameStart = OS_GetTimeUs();
+  __enable_irq();
+}
+
+void lcd_frame_stats_get(LCD_FRAME_STATS *stats)
+{
+  *stats = frameStats;
 }
 #endif
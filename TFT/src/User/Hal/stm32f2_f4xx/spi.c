@@ -1,6 +1,8 @@
 #include "spi.h"
 #include "variants.h"  // for SPI1_SCK_PIN etc...
 #include "GPIO_Init.h"
+#include "uart.h"
+#include <stddef.h>
 
 // SPI1 default pins config
 #ifndef SPI1_SCK_PIN
@@ -57,6 +59,36 @@ static SPI_TypeDef* const spi[_SPI_CNT] = {
   SPI3,  // SCK--PB3   MISO--PB4   MOSI--PB5
 };
 
+// SPI DMA streams of SPI_Transfer(). The rx DMA of a serial port is always running, so the SPI sharing a stream
+// with a serial port in use transfers by CPU instead. SPI1 tx is on DMA2 stream 5, streams 3 and 7 are used by
+// the knob LED and the LCD fills
+#if SERIAL_PORT == _UART5 || (defined(SERIAL_PORT_2) && SERIAL_PORT_2 == _UART5) || \
+    (defined(SERIAL_PORT_3) && SERIAL_PORT_3 == _UART5) || (defined(SERIAL_PORT_4) && SERIAL_PORT_4 == _UART5)
+  #define SPI3_TX_DMA_STREAM NULL  // DMA1 stream 0 (SPI3 rx) is the UART5 rx DMA
+#else
+  #define SPI3_TX_DMA_STREAM DMA1_Stream7
+#endif
+
+#define SPI_DMA_MIN_TRANS 16  // shorter transfers are faster done by CPU
+
+typedef struct
+{
+  DMA_Stream_TypeDef *rx;
+  DMA_Stream_TypeDef *tx;      // NULL: the SPI transfers by CPU
+  volatile uint32_t *rxIFCR;   // flag clear register and offset of the stream flags
+  volatile uint32_t *txIFCR;
+  uint8_t rxFlags;
+  uint8_t txFlags;
+  uint8_t channel;
+  uint32_t rcc;
+} SPI_DMA;
+
+static const SPI_DMA spi_dma[_SPI_CNT] = {
+  {DMA2_Stream0, DMA2_Stream5,       &DMA2->LIFCR, &DMA2->HIFCR, 0,  6, 3, RCC_AHB1Periph_DMA2},
+  {DMA1_Stream3, DMA1_Stream4,       &DMA1->LIFCR, &DMA1->HIFCR, 22, 0, 0, RCC_AHB1Periph_DMA1},
+  {DMA1_Stream0, SPI3_TX_DMA_STREAM, &DMA1->LIFCR, &DMA1->HIFCR, 0, 22, 0, RCC_AHB1Periph_DMA1},
+};
+
 static const uint16_t spi_sck[_SPI_CNT]  = {SPI1_SCK_PIN,  SPI2_SCK_PIN,  SPI3_SCK_PIN};   // SCK
 static const uint16_t spi_miso[_SPI_CNT] = {SPI1_MISO_PIN, SPI2_MISO_PIN, SPI3_MISO_PIN};  // MISO
 static const uint16_t spi_mosi[_SPI_CNT] = {SPI1_MOSI_PIN, SPI2_MOSI_PIN, SPI3_MOSI_PIN};  // MOSI
@@ -124,3 +156,78 @@ uint16_t SPI_Read_Write(uint8_t port, uint16_t d)
   while ((spi[port]->SR & (1 << 0)) == RESET);  // wait for rx no empty
   return spi[port]->DR;
 }
+
+// transfer len bytes, tx NULL sends 0xFF and rx NULL drops the received bytes
+// the rx stream may be the one of the lcd_dma.c frame engine (W25Qxx on the same SPI), which must be idle
+void SPI_Transfer(uint8_t port, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+  static const uint8_t txDummy = 0xFF;
+  static uint8_t rxDummy;
+  const SPI_DMA *cfg = &spi_dma[port];
+  uint32_t rxCR, rxPAR, rxM0AR, rxNDTR, rxFCR;
+
+  if (cfg->tx == NULL || len < SPI_DMA_MIN_TRANS)
+  {
+    for (uint16_t i = 0; i < len; i++)
+    {
+      while ((spi[port]->SR & (1 << 1)) == RESET);  // wait for tx empty
+      spi[port]->DR = (tx != NULL) ? tx[i] : 0xFF;
+      while ((spi[port]->SR & (1 << 0)) == RESET);  // wait for rx no empty
+      uint8_t data = spi[port]->DR;
+      if (rx != NULL)
+        rx[i] = data;
+    }
+    return;
+  }
+
+  RCC->AHB1ENR |= cfg->rcc;
+
+  // restored at the end for the frame engine, which doesn't set them all for each frame
+  rxCR = cfg->rx->CR & ~(1<<0);
+  rxPAR = cfg->rx->PAR;
+  rxM0AR = cfg->rx->M0AR;
+  rxNDTR = cfg->rx->NDTR;
+  rxFCR = cfg->rx->FCR;
+
+  cfg->rx->CR = 0;
+  cfg->tx->CR = 0;
+  while ((cfg->rx->CR & (1<<0)) || (cfg->tx->CR & (1<<0)));  // wait for the streams to be disabled
+  *cfg->rxIFCR = 0x3D << cfg->rxFlags;
+  *cfg->txIFCR = 0x3D << cfg->txFlags;
+
+  cfg->rx->PAR = (uint32_t)&spi[port]->DR;
+  cfg->rx->M0AR = (uint32_t)((rx != NULL) ? rx : &rxDummy);
+  cfg->rx->NDTR = len;
+  cfg->rx->FCR = 0;                       // direct mode
+  cfg->rx->CR = (cfg->channel<<25)
+              | (2<<16)                   // High priority, ahead of tx so rx never overruns
+              | ((rx != NULL)<<10);       // Memory increment, 8bit, peripheral to memory
+
+  cfg->tx->PAR = (uint32_t)&spi[port]->DR;
+  cfg->tx->M0AR = (uint32_t)((tx != NULL) ? tx : &txDummy);
+  cfg->tx->NDTR = len;
+  cfg->tx->FCR = 0;
+  cfg->tx->CR = (cfg->channel<<25)
+              | (1<<16)                   // Medium priority
+              | ((tx != NULL)<<10)        // Memory increment, 8bit
+              | (1<<6);                   // Memory to peripheral
+
+  cfg->rx->CR |= 1<<0;
+  cfg->tx->CR |= 1<<0;
+  spi[port]->CR2 |= (1<<1) | (1<<0);      // tx and rx DMA requests, the transfer starts
+
+  while (cfg->rx->NDTR != 0);             // the last byte received is also the last one sent
+
+  spi[port]->CR2 &= ~((1<<1) | (1<<0));
+  cfg->tx->CR = 0;
+  cfg->rx->CR = 0;
+  while ((cfg->rx->CR & (1<<0)) || (cfg->tx->CR & (1<<0)));
+  *cfg->rxIFCR = 0x3D << cfg->rxFlags;
+  *cfg->txIFCR = 0x3D << cfg->txFlags;
+
+  cfg->rx->PAR = rxPAR;
+  cfg->rx->M0AR = rxM0AR;
+  cfg->rx->NDTR = rxNDTR;
+  cfg->rx->FCR = rxFCR;
+  cfg->rx->CR = rxCR;
+}
@@ -13,5 +13,6 @@ void SPI_Config(uint8_t port);
 void SPI_DeConfig(uint8_t port);
 void SPI_Protocol_Init(uint8_t port, uint8_t baudrate);
 uint16_t SPI_Read_Write(uint8_t port, uint16_t d);
+void SPI_Transfer(uint8_t port, const uint8_t *tx, uint8_t *rx, uint16_t len);
 
 #endif
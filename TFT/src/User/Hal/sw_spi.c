@@ -1,6 +1,8 @@
 #include "sw_spi.h"
 #include "GPIO_Init.h"
-#include "delay.h"
+#include "main.h"  // for mcuClocks
+
+#define SW_SPI_HALF_PERIOD_US 2  // The speed of xpt2046 should not be too fast, it is better to be below 200KHz.
 
 void SW_SPI_Config(_SW_SPI *sw_spi, _SPI_MODE mode, uint8_t dataSize,
   uint16_t cs,
@@ -14,6 +16,9 @@ void SW_SPI_Config(_SW_SPI *sw_spi, _SPI_MODE mode, uint8_t dataSize,
   sw_spi->mosi = mosi;
   sw_spi->mode = mode;
   sw_spi->dataSize = dataSize;
+  // a loop takes at least 4 cycles. Delay_us() is not used as it reprograms the SysTick,
+  // so it can't be called from an interrupt (e.g. touch screen sampling) while the main loop is in a delay
+  sw_spi->delayLoops = mcuClocks.rccClocks.HCLK_Frequency / 1000000 * SW_SPI_HALF_PERIOD_US / 4;
 
   GPIO_InitSet(sw_spi->cs, MGPIO_MODE_OUT_PP, 0);    //CS
   GPIO_InitSet(sw_spi->sck, MGPIO_MODE_OUT_PP, 0);   //SCK
@@ -21,8 +26,13 @@ void SW_SPI_Config(_SW_SPI *sw_spi, _SPI_MODE mode, uint8_t dataSize,
   GPIO_InitSet(sw_spi->mosi, MGPIO_MODE_OUT_PP, 0);  //MOSI
 }
 
-#define SCK_HIGH()    GPIO_SetLevel(sw_spi->sck, 1); Delay_us(2)  // The speed of xpt2046 should not be too fast
-#define SCK_LOW()     GPIO_SetLevel(sw_spi->sck, 0); Delay_us(2)  // It is better to be below 200KHz.
+static inline void SW_SPI_Delay(const _SW_SPI *sw_spi)
+{
+  for (volatile uint32_t i = sw_spi->delayLoops; i > 0; i--);
+}
+
+#define SCK_HIGH()    GPIO_SetLevel(sw_spi->sck, 1); SW_SPI_Delay(sw_spi)
+#define SCK_LOW()     GPIO_SetLevel(sw_spi->sck, 0); SW_SPI_Delay(sw_spi)
 #define MOSI_WRITE(n) GPIO_SetLevel(sw_spi->mosi, n)
 #define MISO_READ()   GPIO_GetLevel(sw_spi->miso)
 
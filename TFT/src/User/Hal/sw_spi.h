@@ -24,6 +24,7 @@ typedef struct
   uint16_t  mosi;
   _SPI_MODE mode;
   uint8_t   dataSize;
+  uint32_t  delayLoops;  // busy loops for half a clock period
 } _SW_SPI;
 
 void SW_SPI_Config(_SW_SPI *sw_spi, _SPI_MODE mode, uint8_t dataSize,
@@ -1,6 +1,10 @@
 #include "w25qxx.h"
 #include "GPIO_Init.h"
 #include "spi.h"
+#include "lcd_dma.h"
+#include "os_timer.h"
+#include "my_misc.h"
+#include <string.h>
 
 /*************************** W25Qxx SPI Interface ported by the underlying pattern ***************************/
 //#define W25Qxx_SPI     _SPI3
@@ -10,9 +14,14 @@
 const uint8_t cap_ID[14] = {0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x43, 0x4B, 0x00, 0x01};
 const uint32_t flash_size[14] = {KB(64), KB(128), KB(256), KB(512), MB(1), MB(2), MB(4), MB(8), MB(16), MB(32), MB(8), MB(8), KB(256), KB(512)};
 
+static uint8_t prefetchBuf[W25QXX_PREFETCH_SIZE];
+static uint32_t prefetchAddr;
+static uint16_t prefetchSize = 0;  // 0: nothing prefetched
+
 //Chip Select
 void W25Qxx_SPI_CS_Set(uint8_t level)
 {
+  lcd_frame_wait();  // the W25Qxx is in use while frames are drawn by DMA
   GPIO_SetLevel(W25Qxx_CS_PIN, level);
 }
 
@@ -58,6 +67,7 @@ void W25Qxx_WaitForWriteEnd(void)
 //Write by page
 void W25Qxx_WritePage(uint8_t* pBuffer, uint32_t WriteAddr, uint16_t NumByteToWrite)
 {
+  prefetchSize = 0;
   W25Qxx_WriteEnable();
   W25Qxx_SPI_CS_Set(0);
 
@@ -147,16 +157,23 @@ void W25Qxx_WriteBuffer(uint8_t* pBuffer, uint32_t WriteAddr, uint16_t NumByteTo
   }
 }
 
-//Reading data from flash
-void W25Qxx_ReadBuffer(uint8_t* pBuffer, uint32_t ReadAddr, uint16_t NumByteToRead)
+//Select the flash and send a fast read command, the data follow with W25Qxx_SPI_Read_Write_Byte() until W25Qxx_SPI_CS_Set(1)
+void W25Qxx_ReadStart(uint32_t ReadAddr)
 {
   W25Qxx_SPI_CS_Set(0);
 
-  W25Qxx_SPI_Read_Write_Byte(CMD_READ_DATA);
+  W25Qxx_SPI_Read_Write_Byte(CMD_FAST_READ_DATA);
 
   W25Qxx_SPI_Read_Write_Byte((ReadAddr & 0xFF0000) >> 16);
   W25Qxx_SPI_Read_Write_Byte((ReadAddr& 0xFF00) >> 8);
   W25Qxx_SPI_Read_Write_Byte(ReadAddr & 0xFF);
+  W25Qxx_SPI_Read_Write_Byte(W25QXX_DUMMY_BYTE);  // 8 dummy clock
+}
+
+//Reading data from flash by CPU
+void W25Qxx_ReadBytes(uint8_t* pBuffer, uint32_t ReadAddr, uint16_t NumByteToRead)
+{
+  W25Qxx_ReadStart(ReadAddr);
 
   while (NumByteToRead--)
   {
@@ -167,6 +184,41 @@ void W25Qxx_ReadBuffer(uint8_t* pBuffer, uint32_t ReadAddr, uint16_t NumByteToRe
   W25Qxx_SPI_CS_Set(1);
 }
 
+//Reading data from flash, from the prefetched data if there, else by DMA if large enough
+void W25Qxx_ReadBuffer(uint8_t* pBuffer, uint32_t ReadAddr, uint16_t NumByteToRead)
+{
+  if (prefetchSize != 0 && ReadAddr >= prefetchAddr && ReadAddr + NumByteToRead <= prefetchAddr + prefetchSize)
+  {
+    lcd_frame_wait();  // the prefetch may still be on the way
+    memcpy(pBuffer, prefetchBuf + (ReadAddr - prefetchAddr), NumByteToRead);
+  }
+  else if (NumByteToRead >= W25QXX_DMA_MIN_READ)
+  {
+    lcd_frame_read(pBuffer, ReadAddr, NumByteToRead);
+    lcd_frame_wait();
+  }
+  else
+  {
+    W25Qxx_ReadBytes(pBuffer, ReadAddr, NumByteToRead);
+  }
+}
+
+//Start reading in background data expected to be read soon by W25Qxx_ReadBuffer() (e.g. the next character bitmap),
+//so the read is done while the CPU works on something else (e.g. writing the LCD)
+void W25Qxx_Prefetch(uint32_t ReadAddr, uint16_t NumByteToRead)
+{
+  if (NumByteToRead == 0 || NumByteToRead > W25QXX_PREFETCH_SIZE)
+    return;
+
+  if (prefetchSize != 0 && ReadAddr >= prefetchAddr && ReadAddr + NumByteToRead <= prefetchAddr + prefetchSize)
+    return;  // already there
+
+  // a previous prefetch still on the way is done first, reads are queued in order
+  prefetchAddr = ReadAddr;
+  prefetchSize = NumByteToRead;
+  lcd_frame_read(prefetchBuf, ReadAddr, NumByteToRead);
+}
+
 //Read ID
 uint32_t W25Qxx_ReadID(void)
 {
@@ -186,6 +238,7 @@ uint32_t W25Qxx_ReadID(void)
 //Sector erase
 void W25Qxx_EraseSector(uint32_t SectorAddr)
 {
+  prefetchSize = 0;
   W25Qxx_WriteEnable();
 
   W25Qxx_SPI_CS_Set(0);
@@ -201,6 +254,7 @@ void W25Qxx_EraseSector(uint32_t SectorAddr)
 //Block erase
 void W25Qxx_EraseBlock(uint32_t BlockAddr)
 {
+  prefetchSize = 0;
   W25Qxx_WriteEnable();
 
   W25Qxx_SPI_CS_Set(0);
@@ -216,6 +270,7 @@ void W25Qxx_EraseBlock(uint32_t BlockAddr)
 //Full-chip erase
 void W25Qxx_EraseBulk(void)
 {
+  prefetchSize = 0;
   W25Qxx_WriteEnable();
 
   W25Qxx_SPI_CS_Set(0);
@@ -246,3 +301,27 @@ uint32_t W25Qxx_ReadCapacity(void)
   }
   return 0;
 }
+
+//Read size bytes from addr by CPU then by DMA, for the throughput of each method
+void W25Qxx_SpeedTest(W25QXX_SPEED_TEST *test, uint32_t addr, uint32_t size)
+{
+  uint8_t buf[512];
+  uint32_t start;
+
+  test->bytes = size;
+
+  start = OS_GetTimeUs();
+  for (uint32_t i = 0; i < size; i += sizeof(buf))
+  {
+    W25Qxx_ReadBytes(buf, addr + i, MIN(size - i, sizeof(buf)));
+  }
+  test->cpuTime = OS_GetTimeUs() - start;
+
+  start = OS_GetTimeUs();
+  for (uint32_t i = 0; i < size; i += sizeof(buf))
+  {
+    lcd_frame_read(buf, addr + i, MIN(size - i, sizeof(buf)));
+    lcd_frame_wait();
+  }
+  test->dmaTime = OS_GetTimeUs() - start;
+}
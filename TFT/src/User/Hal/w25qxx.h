@@ -26,6 +26,16 @@ extern "C" {
 #define KB(x) (x * 1024l)
 #define MB(x) (x * 1024l * 1024l)
 
+#define W25QXX_DMA_MIN_READ  32   // shorter reads are faster done by CPU than set up for DMA
+#define W25QXX_PREFETCH_SIZE 256  // max bytes of a prefetch
+
+typedef struct
+{
+  uint32_t bytes;    // bytes read with each method
+  uint32_t cpuTime;  // time in us of the reads by CPU
+  uint32_t dmaTime;  // time in us of the reads by DMA
+} W25QXX_SPEED_TEST;
+
 uint8_t W25Qxx_SPI_Read_Write_Byte(uint8_t data);
 void W25Qxx_SPI_CS_Set(uint8_t level);
 void W25Qxx_Init(void);
@@ -34,12 +44,16 @@ void W25Qxx_WriteEnable(void);
 void W25Qxx_WaitForWriteEnd(void);
 void W25Qxx_WritePage(uint8_t* pBuffer, uint32_t WriteAddr, uint16_t NumByteToWrite);
 void W25Qxx_WriteBuffer(uint8_t* pBuffer, uint32_t WriteAddr, uint16_t NumByteToWrite);
+void W25Qxx_ReadStart(uint32_t ReadAddr);
+void W25Qxx_ReadBytes(uint8_t* pBuffer, uint32_t ReadAddr, uint16_t NumByteToRead);
 void W25Qxx_ReadBuffer(uint8_t* pBuffer, uint32_t ReadAddr, uint16_t NumByteToRead);
+void W25Qxx_Prefetch(uint32_t ReadAddr, uint16_t NumByteToRead);
 void W25Qxx_EraseSector(uint32_t SectorAddr);
 void W25Qxx_EraseBlock(uint32_t BlockAddr);
 void W25Qxx_EraseBulk(void);
 uint32_t W25Qxx_ReadID(void);
 uint32_t W25Qxx_ReadCapacity(void);
+void W25Qxx_SpeedTest(W25QXX_SPEED_TEST *test, uint32_t addr, uint32_t size);
 
 #ifdef __cplusplus
 }
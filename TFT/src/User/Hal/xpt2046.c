@@ -12,6 +12,7 @@ _SW_SPI xpt2046;
 void XPT2046_CS_Set(uint8_t level)
 {
 #ifdef HW_SPI_TOUCH  // added for MKS_TFT35_V1_0 support
+  lcd_frame_wait();  // the SPI is shared with the W25Qxx
   GPIO_SetLevel(XPT2046_CS, level);
   W25Qxx_SPI_CS_Set(1);
 #else
@@ -82,47 +83,3 @@ uint16_t XPT2046_Read_AD(uint8_t CMD)
   XPT2046_CS_Set(1);
   return ADNum;
 }
-
-#define READ_TIMES 5  //Read times  //Read times
-#define LOST_VAL   1  //Drop value  //Drop value
-
-uint16_t XPT2046_Average_AD(uint8_t CMD)
-{
-  uint16_t i, j;
-  uint16_t buf[READ_TIMES];
-  uint16_t sum = 0;
-  uint16_t temp;
-  for (i = 0; i < READ_TIMES; i++) buf[i] = XPT2046_Read_AD(CMD);
-  for (i = 0; i < READ_TIMES - 1; i++)  //Sort  // Sort
-  {
-    for (j = i + 1; j < READ_TIMES; j++)
-    {
-      if (buf[i] > buf[j])  //Ascending
-      {
-        temp = buf[i];
-        buf[i] = buf[j];
-        buf[j] = temp;
-      }
-    }
-  }
-
-  for (i = LOST_VAL; i < READ_TIMES - LOST_VAL; i++) sum += buf[i];
-  temp = sum / (READ_TIMES - 2 * LOST_VAL);
-  return temp;
-}
-
-#define ERR_RANGE 50  //Tolerance scope
-
-uint16_t XPT2046_Repeated_Compare_AD(uint8_t CMD)
-{
-  uint16_t ad1, ad2;
-  ad1 = XPT2046_Average_AD(CMD);
-  ad2 = XPT2046_Average_AD(CMD);
-
-  if ((ad2 <= ad1 && ad1 < ad2 + ERR_RANGE)
-   || (ad1 <= ad2 && ad2 < ad1 + ERR_RANGE))  //The error before and after is less than ERR_RANGE  //Two errors before and after ERR_RANGE
-  {
-    return (ad1 + ad2) / 2;
-  }
-  else return 0;
-}
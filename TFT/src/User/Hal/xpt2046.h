@@ -10,7 +10,7 @@ extern "C" {
 
 void XPT2046_Init(void);
 uint8_t XPT2046_Read_Pen(void);
-uint16_t XPT2046_Repeated_Compare_AD(uint8_t CMD);
+uint16_t XPT2046_Read_AD(uint8_t CMD);
 
 #ifdef __cplusplus
 }
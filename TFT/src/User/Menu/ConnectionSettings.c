@@ -36,6 +36,7 @@ void menuDisconnect(void)
       LCD_CheckDimming();
     #endif
   }
+  TS_FlushEvents();  // the touch to exit is not for the menu below
   Serial_Init(ALL_PORTS);
 
   CLOSE_MENU();
@@ -9,6 +9,7 @@ typedef void (* CB_INIT)(CIRCULAR_QUEUE *);
 typedef void (* CB_DEINIT)(void);
 typedef bool (* CB_DATA)(uint8_t *);
 typedef void (* CB_PARSE)(uint8_t);
+typedef void (* CB_FLUSH)(void);
 
 void menuMarlinMode(void)
 {
@@ -16,6 +17,7 @@ void menuMarlinMode(void)
   CB_DEINIT marlinDeInit = NULL;
   CB_DATA   marlinGetData = NULL;
   CB_PARSE  marlinParse = NULL;
+  CB_FLUSH  marlinFlush = NULL;
 
   GUI_Clear(infoSettings.marlin_bg_color);
   GUI_SetColor(infoSettings.marlin_font_color);
@@ -37,6 +39,7 @@ void menuMarlinMode(void)
       marlinDeInit = SPI_SlaveDeInit;
       marlinGetData = SPI_SlaveGetData;
       marlinParse = ST7920_ParseRecv;
+      marlinFlush = ST7920_Flush;
 
       ST7920_Init(&st7920);
     }
@@ -49,6 +52,9 @@ void menuMarlinMode(void)
       marlinDeInit = HD44780_DeConfig;
       marlinGetData = HD44780_getData;
       marlinParse = HD44780_ParseRecv;
+      marlinFlush = HD44780_Flush;
+
+      HD44780_Init();
     }
   #endif
 
@@ -64,6 +70,9 @@ void menuMarlinMode(void)
       marlinParse(data);
     }
 
+    if (marlinFlush != NULL)  // draw what changed with the received data
+      marlinFlush();
+
     #if LCD_ENCODER_SUPPORT
       if (Touch_Enc_ReadBtn(LCD_ENC_BUTTON_INTERVAL))
         LCD_Enc_SendPulse(1);
@@ -90,6 +99,11 @@ void menuMarlinMode(void)
   }
 
   marlinDeInit();
+
+  #if defined(LCD2004_EMULATOR)
+    if (infoSettings.marlin_type == LCD2004)
+      HD44780_DeInit();
+  #endif
 }
 
 #endif
@@ -289,7 +289,7 @@ static inline void meshAllocData(void)
   if (meshData != NULL)                                    // if data already exist (e.g. when the menu is reloaded), continue to use the existing data
     return;
 
-  meshData = (MESH_DATA *) malloc(sizeof(MESH_DATA));
+  meshData = (MESH_DATA *) memAlloc(MEM_MESH, sizeof(MESH_DATA));
   meshInitData();
 
   probeHeightEnable();                                     // temporary disable software endstops and save ABL state
@@ -300,7 +300,7 @@ void meshDeallocData(void)
   if (meshData == NULL)
     return;
 
-  free(meshData);
+  memFree(meshData);
   meshData = NULL;
 
   probeHeightDisable();                                    // restore original software endstops state and ABL state
@@ -51,7 +51,7 @@ void updateGantry(void)
 {
   if (nextScreenUpdate(GANTRY_UPDATE_DELAY))
   {
-    coordinateQuery(0);  // query position manually for delay less than 1 second
+    telemetryQuery(TELEMETRY_POS);  // query position manually for delay less than 1 second
     drawXYZ();
   }
 }
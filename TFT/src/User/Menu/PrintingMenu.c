@@ -358,11 +358,6 @@ static inline void toggleInfo(void)
     TOGGLE_BIT(currentSpeedID, 0);
     reDrawPrintingValue(ICON_POS_SPD, LIVE_INFO_ICON | LIVE_INFO_TOP_ROW | LIVE_INFO_BOTTOM_ROW);
 
-    speedQuery();
-
-    if (infoFile.source >= FS_ONBOARD_MEDIA)
-      coordinateQuery(MS_TO_SEC(TOGGLE_TIME));
-
     if (!infoPrintSummary.hasFilamentData && isPrinting())
       updatePrintUsedFilament();
   }
@@ -539,6 +534,12 @@ void menuPrinting(void)
       drawPrintInfo();
   #endif
 
+  // values displayed, updated at the rate of the display toggle. The position of a print from TFT media is known
+  telemetrySetSeconds(TELEMETRY_SPEED, MS_TO_SEC(TOGGLE_TIME));
+
+  if (infoFile.source >= FS_ONBOARD_MEDIA)
+    telemetrySetSeconds(TELEMETRY_POS, MS_TO_SEC(TOGGLE_TIME));
+
   while (MENU_IS(menuPrinting))
   {
     //Scroll_DispString(&titleScroll, LEFT);  // scroll display file name will take too many CPU cycles
@@ -748,4 +749,7 @@ void menuPrinting(void)
 
     loopProcess();
   }
+
+  telemetrySetSeconds(TELEMETRY_SPEED, 0);
+  telemetrySetSeconds(TELEMETRY_POS, 0);
 }
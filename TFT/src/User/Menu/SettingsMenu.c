@@ -111,7 +111,7 @@ void menuInfo(void)
 
   const uint16_t top_y = 0; //(LCD_HEIGHT - (7 * BYTE_HEIGHT)) / 2;  // 8 firmware info lines + 1 SPI flash info line
   const uint16_t start_x = strlen("Firmware:") * BYTE_WIDTH;
-  const GUI_RECT version[7] = {
+  const GUI_RECT version[9] = {
     {start_x, top_y + 0*BYTE_HEIGHT, LCD_WIDTH, top_y + 2*BYTE_HEIGHT},
     {start_x, top_y + 2*BYTE_HEIGHT, LCD_WIDTH, top_y + 4*BYTE_HEIGHT},
     {start_x, top_y + 4*BYTE_HEIGHT, LCD_WIDTH, top_y + 5*BYTE_HEIGHT},
@@ -119,6 +119,8 @@ void menuInfo(void)
     {start_x, top_y + 6*BYTE_HEIGHT, LCD_WIDTH, top_y + 7*BYTE_HEIGHT},
     {start_x, top_y + 7*BYTE_HEIGHT, LCD_WIDTH, top_y + 8*BYTE_HEIGHT},
     {start_x, top_y + 8*BYTE_HEIGHT, LCD_WIDTH, top_y + 9*BYTE_HEIGHT},
+    {start_x, top_y + 9*BYTE_HEIGHT, LCD_WIDTH, top_y + 10*BYTE_HEIGHT},
+    {start_x, top_y + 10*BYTE_HEIGHT, LCD_WIDTH, top_y + 11*BYTE_HEIGHT},
   };
 
   // draw titles
@@ -132,6 +134,11 @@ void menuInfo(void)
     GUI_DispString(0, version[5].y0, (uint8_t *)"WIFI    :");
     GUI_DispString(0, version[6].y0, (uint8_t *)"IP      :");
   }
+  // CPU load and heap are below the WIFI info on RRF, else in its place
+  const GUI_RECT *load = &version[(infoMachineSettings.firmwareType == FW_REPRAPFW) ? 7 : 5];
+
+  GUI_DispString(0, load->y0, (uint8_t *)"CPU load:");
+  GUI_DispString(0, load[1].y0, (uint8_t *)"Heap    :");
 
   // draw info
   GUI_SetColor(0xDB40);
@@ -156,9 +163,118 @@ void menuInfo(void)
 
   GUI_DispStringInRect(20, LCD_HEIGHT - (BYTE_HEIGHT*2), LCD_WIDTH-20, LCD_HEIGHT, textSelect(LABEL_TOUCH_TO_EXIT));
 
-  while (!isPress()) loopBackEnd();
+  // touching the heap row opens the memory details, anywhere else exits
+  const GUI_RECT keyRect[2] = {
+    {0, load[1].y0, LCD_WIDTH, load[1].y1},
+    {0, 0,          LCD_WIDTH, LCD_HEIGHT},
+  };
+  uint16_t key_num;
+  uint32_t nextTime = 0;
+
+  while ((key_num = KEY_GetValue(COUNT(keyRect), keyRect)) == IDLE_TOUCH)
+  {
+    loopBackEnd();
+    loopIdle();
+
+    if (OS_GetTimeMs() >= nextTime)  // refresh the CPU load and heap once a second
+    {
+      HEAP_INFO heap;
+      const ARENA *names = getInfoFileNames();
+
+      nextTime = OS_GetTimeMs() + 1000;
+      getHeapInfo(&heap);
+
+      GUI_SetColor(0xDB40);
+      sprintf(buf, "%u%%", OS_GetCpuLoad());
+      GUI_DispStringInPrectEOL(load, (uint8_t *)buf);
+      // free bytes within the heap are holes between the allocated blocks, i.e. its fragmentation
+      sprintf(buf, "%luKB, %lu%% free, names %luB/%u", (unsigned long)heap.size / 1024,
+              (unsigned long)(heap.size ? heap.free * 100 / heap.size : 0), (unsigned long)names->used, names->blocks);
+      GUI_DispStringInPrectEOL(&load[1], (uint8_t *)buf);
+      GUI_SetColor(GRAY);
+    }
+  }
+
+  GUI_RestoreColorDefault();
+
+  if (key_num == 0)
+    REPLACE_MENU(menuMemoryInfo);
+  else
+    CLOSE_MENU();
+}
+
+// Heap and stack use, with the heap blocks of each owner
+void menuMemoryInfo(void)
+{
+  char buf[64];
+  const uint16_t start_x = strlen("Errors: ") * BYTE_WIDTH;
+  const GUI_RECT rows[3] = {
+    {start_x, 0*BYTE_HEIGHT, LCD_WIDTH, 1*BYTE_HEIGHT},
+    {start_x, 1*BYTE_HEIGHT, LCD_WIDTH, 2*BYTE_HEIGHT},
+    {start_x, 2*BYTE_HEIGHT, LCD_WIDTH, 3*BYTE_HEIGHT},
+  };
+  uint32_t nextTime = 0;
+
+  GUI_Clear(infoSettings.bg_color);
+  GUI_SetColor(GRAY);
+
+  GUI_DispString(0, rows[0].y0, (uint8_t *)"Heap  : ");
+  GUI_DispString(0, rows[1].y0, (uint8_t *)"Stack : ");
+  GUI_DispString(0, rows[2].y0, (uint8_t *)"Errors: ");
+  for (uint8_t col = 0; col < 2; col++)
+  {
+    GUI_DispString(col * LCD_WIDTH / 2, 3 * BYTE_HEIGHT + BYTE_HEIGHT / 2, (uint8_t *)"Owner    now  peak");
+  }
+
+  GUI_HLine(0, LCD_HEIGHT - (BYTE_HEIGHT*2), LCD_WIDTH);
+  GUI_DispStringInRect(20, LCD_HEIGHT - (BYTE_HEIGHT*2), LCD_WIDTH-20, LCD_HEIGHT, textSelect(LABEL_TOUCH_TO_EXIT));
+
+  while (!isPress())
+  {
+    loopBackEnd();
+    loopIdle();
+
+    if (OS_GetTimeMs() >= nextTime)  // refresh once a second
+    {
+      HEAP_INFO heap;
+      STACK_INFO stack;
+      uint16_t fails = 0;
+      uint16_t overruns = 0;
+
+      nextTime = OS_GetTimeMs() + 1000;
+      getHeapInfo(&heap);
+      getStackInfo(&stack);
+
+      GUI_SetColor(0xDB40);
+      // "other": blocks allocated by the libraries (e.g. PNG decoder) and the bookkeeping of malloc()
+      sprintf(buf, "%luKB, %lu free, %lu other", (unsigned long)heap.size / 1024, (unsigned long)heap.free,
+              (unsigned long)(heap.used - MIN(heap.used, memTrackedBytes())));
+      GUI_DispStringInPrectEOL(&rows[0], (uint8_t *)buf);
+      sprintf(buf, "%lu/%lu B, %lu to heap", (unsigned long)stack.used, (unsigned long)stack.size,
+              (unsigned long)stack.gap);
+      GUI_DispStringInPrectEOL(&rows[1], (uint8_t *)buf);
+
+      for (uint8_t i = 0; i < MEM_TAG_COUNT; i++)
+      {
+        const MEM_STATS *stats = memGetStats(i);
+        const GUI_RECT cell = {(i % 2) * LCD_WIDTH / 2, (5 + i / 2) * BYTE_HEIGHT,
+                               (i % 2 + 1) * LCD_WIDTH / 2, (6 + i / 2) * BYTE_HEIGHT};
+
+        sprintf(buf, "%-6s%6lu%6lu", memTagName(i), (unsigned long)stats->used, (unsigned long)stats->peak);
+        GUI_DispStringInPrectEOL(&cell, (uint8_t *)buf);
+
+        fails += stats->fails;
+        overruns += stats->overruns;
+      }
+
+      sprintf(buf, "%u failed, %u overrun", fails, overruns);
+      GUI_DispStringInPrectEOL(&rows[2], (uint8_t *)buf);
+      GUI_SetColor(GRAY);
+    }
+  }
   BUZZER_PLAY(SOUND_KEYPRESS);
   while (isPress()) loopBackEnd();
+  TS_FlushEvents();  // the touch to exit is not for the menu below
 
   GUI_RestoreColorDefault();
   CLOSE_MENU();
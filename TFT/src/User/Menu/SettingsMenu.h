@@ -14,6 +14,7 @@ void infoSetMachineType(uint8_t *machine, uint8_t type_len);
 void infoSetAccessPoint(uint8_t *ssid, uint8_t ssid_len);
 void infoSetIPAddress(uint8_t *ip, uint8_t ip_len);
 void menuInfo(void);
+void menuMemoryInfo(void);
 void menuSettings(void);
 
 #ifdef __cplusplus
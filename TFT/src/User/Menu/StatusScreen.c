@@ -279,11 +279,6 @@ static inline void toggleTool(void)
     // switch speed/flow
     TOGGLE_BIT(currentSpeedID, 0);
     drawStatus();
-
-    // gcode queries must be call after drawStatus
-    coordinateQuery(MS_TO_SEC(UPDATE_TOOL_TIME));
-    speedQuery();
-    ctrlFanQuery();
   }
 }
 
@@ -298,6 +293,11 @@ void menuStatus(void)
   drawStatus();
   drawStatusScreenMsg();
 
+  // values displayed, updated at the rate of the display toggle
+  telemetrySetSeconds(TELEMETRY_POS, MS_TO_SEC(UPDATE_TOOL_TIME));
+  telemetrySetSeconds(TELEMETRY_SPEED, MS_TO_SEC(UPDATE_TOOL_TIME));
+  telemetrySetSeconds(TELEMETRY_CTRL_FAN, MS_TO_SEC(UPDATE_TOOL_TIME));
+
   while (MENU_IS(menuStatus))
   {
     if (infoHost.connected != lastConnectionStatus)
@@ -358,5 +358,7 @@ void menuStatus(void)
     loopProcess();
   }
 
-  coordinateQueryTurnOff();  // disable position auto report, if any
+  telemetrySetSeconds(TELEMETRY_POS, 0);  // also disables the position auto report, if any
+  telemetrySetSeconds(TELEMETRY_SPEED, 0);
+  telemetrySetSeconds(TELEMETRY_CTRL_FAN, 0);
 }
@@ -312,7 +312,7 @@ void backupCurrentSettings(void)
 {
   if (nowInfoSettings == NULL)
   {
-    nowInfoSettings = (SETTINGS *) malloc(sizeof(SETTINGS));
+    nowInfoSettings = (SETTINGS *) memAlloc(MEM_UI, sizeof(SETTINGS));
     *nowInfoSettings = infoSettings;
   }
 }
@@ -325,7 +325,7 @@ void storeCurrentSettings(void)
     if (memcmp(nowInfoSettings, &infoSettings, sizeof(SETTINGS)))  // if settings have been modified, save to FLASH
       storePara();
 
-    free(nowInfoSettings);
+    memFree(nowInfoSettings);
     nowInfoSettings = NULL;
   }
 }
@@ -6,6 +6,7 @@ void sizecheck(void)
   // if error shows 'the size of an array must be greater than zero' or 'size of unnamed array is negative'
   // then the size of the array is larger than allocated size in flash.
   SIZE_CHECK((sizeof(SETTINGS) + 12 + sizeof(TSC_Para)) > PARA_SIZE); // Size of infoSettings is larger than allocated size in flash.
+  SIZE_CHECK(PARA_SIZE % PARA_CHUNK_SIZE != 0);                       // Settings buffer must be made of whole log records.
   SIZE_CHECK(sizeof(STRINGS_STORE) > STRINGS_STORE_MAX_SIZE);         // Size of strings_store is larger than allocated size in flash.
   SIZE_CHECK(sizeof(PREHEAT_STORE) > PREHEAT_STORE_MAX_SIZE);         // Size of preheat_store is larger than allocated size in flash.
   SIZE_CHECK(sizeof(CUSTOM_GCODES) > CUSTOM_GCODE_MAX_SIZE);          // Size of custom_gcodes is larger than allocated size in flash.
@@ -0,0 +1,85 @@
+#ifndef _PIN_NATIVE_HOST_H_  // modify to actual filename !!!
+#define _PIN_NATIVE_HOST_H_  // modify to actual filename !!!
+
+// Native (host) build: the firmware runs as a Linux program on emulated hardware (see Hal/native),
+// to render the menus headless and measure the LCD and SPI flash traffic they generate.
+
+// MCU type (STM32F10x, STM32F2xx, STM32F4xx)
+#ifndef MCU_TYPE
+  #define MCU_TYPE
+  #include "native.h"
+#endif
+
+// LCD resolution, font and icon size
+#ifndef TFT_RESOLUTION
+  #define TFT_RESOLUTION
+  #ifdef PORTRAIT_MODE
+    #include "./Resolution/TFT_320X480.h"
+  #else
+    #include "./Resolution/TFT_480X320.h"
+  #endif
+#endif
+
+// Update folder for fonts and icons
+#ifndef UPDATE_DIR
+  #define UPDATE_DIR "TFT35"
+#endif
+
+// Hardware manufacturer
+#ifndef HARDWARE_MANUFACTURER
+  #define HARDWARE_MANUFACTURER "NATIVE_"
+#endif
+
+// Hardware version config
+#ifndef HARDWARE_VERSION
+  #define HARDWARE_VERSION "HOST"
+#endif
+
+// Software manufacturer
+#ifndef SOFTWARE_MANUFACTURER
+  #define SOFTWARE_MANUFACTURER HARDWARE_VERSION"."
+#endif
+
+// XPT2046 Software SPI pins for touch screen (the pen is never down)
+#define XPT2046_CS   PE6
+#define XPT2046_SCK  PE5
+#define XPT2046_MISO PE4
+#define XPT2046_MOSI PE3
+#define XPT2046_TPEN PC13
+
+// W25Qxx SPI Flash Memory pins (emulated, content in NATIVE_FLASH_FILE)
+#define W25Qxx_SPEED  0
+#define W25Qxx_SPI    _SPI3
+#define W25Qxx_CS_PIN PB6
+
+// LCD interface (RAM framebuffer behind an emulated ILI9488)
+#ifndef TFTLCD_DRIVER
+  #define TFTLCD_DRIVER       ILI9488
+  #define TFTLCD_DRIVER_SPEED 0x03
+#endif
+
+// LCD data 16bit or 8bit
+#ifndef LCD_DATA_16BIT
+  #define LCD_DATA_16BIT 1
+#endif
+
+// SERIAL_PORT:   communicating with host (Marlin, RRF etc...)
+// SERIAL_PORT_X: communicating with other controllers (OctoPrint, ESP3D, other UART Touch Screen etc...)
+#ifndef SERIAL_PORT
+  #define SERIAL_PORT   _USART2  // default USART port
+  #define SERIAL_PORT_2 _USART1
+  #define SERIAL_PORT_3 _USART3
+  #define SERIAL_PORT_4 _UART4
+#endif
+
+// Serial port for debugging (written to stdout)
+#ifdef SERIAL_DEBUG_ENABLED
+  #define SERIAL_DEBUG_PORT SERIAL_PORT_3
+#endif
+
+// SD Card CD Detect pin (the card is inserted when NATIVE_SDCARD_FILE exists)
+#ifndef SD_CD_PIN
+  #define SD_CD_PIN PC4
+#endif
+
+#endif
@@ -69,6 +69,8 @@
   #include "pin_MKS_TFT32_V1_4.h"
 #elif defined(MKS_TFT35_V1_0)
   #include "pin_MKS_TFT35_V1_0.h"
+#elif defined(NATIVE_HOST)
+  #include "pin_NATIVE_HOST.h"
 #endif
 
 #define LCD_ENCODER_SUPPORT (defined(LCD_ENCA_PIN) && defined(LCD_ENCB_PIN) && defined(LCD_BTN_PIN))
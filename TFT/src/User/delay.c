@@ -1,6 +1,20 @@
 #include "delay.h"
 #include "includes.h"
 
+#ifdef NATIVE_HOST
+#include <time.h>
+
+void Delay_init(void)
+{
+}
+
+void Delay_us(uint32_t us)
+{
+  struct timespec ts = {us / 1000000, (us % 1000000) * 1000};
+
+  nanosleep(&ts, NULL);
+}
+#else
 static uint8_t fac_us = 0;
 
 void Delay_init(void)
@@ -25,6 +39,7 @@ void Delay_us(uint32_t us)  // Delay is less than 1800 * 1000us
   SysTick->CTRL = 0x00;         // Close counter
   SysTick->VAL = 0x00;          // Clear counter
 }
+#endif
 
 void Delay_ms(uint16_t ms)
 {
@@ -27,6 +27,10 @@
 #include "timer_pwm.h"
 #include "uart.h"
 
+#ifdef NATIVE_HOST  // User/HAL/native
+  #include "native_host.h"
+#endif
+
 // User/HAL/USB
 #include "usbh_msc_core.h"  // HAL/STM32_USB_HOST_Library/Class/MSC/inc
 #include "usbh_core.h"      // HAL/STM32_USB_HOST_Library/Core/inc
@@ -69,6 +73,8 @@
 
 // User/API
 #include "AddonHardware.h"
+#include "MemStats.h"
+#include "Arena.h"
 #include "BabystepControl.h"
 #include "boot.h"
 #include "BuzzerControl.h"
@@ -101,6 +107,7 @@
 #include "SerialConnection.h"
 #include "Settings.h"
 #include "SpeedControl.h"
+#include "Telemetry.h"
 #include "Temperature.h"
 #include "Touch_Encoder.h"
 
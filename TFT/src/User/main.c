@@ -7,6 +7,8 @@ CLOCKS mcuClocks;  // System clocks: SYSCLK, AHB, APB1, APB2, APB1_Timer, APB2_T
 
 int main(void)
 {
+  memStackPaint();  // before anything else uses the stack
+
   SystemClockInit();
 
   SCB->VTOR = VECT_TAB_FLASH;
@@ -31,7 +31,6 @@ typedef enum
 typedef struct
 {
   bool wait;              // Whether wait for Marlin's response
-  bool rx_ok[_UART_CNT];  // Whether receive Marlin's response or get gcode by other UART (ESP3D/OctoPrint)
   bool connected;         // Whether have connected to Marlin
   HOST_STATUS status;     // Whether the host is busy in printing execution. (USB serial printing and gcode print from onboard)
 } HOST;
@@ -226,3 +226,24 @@ bool validateChecksum(char *str)
 
   return (checksum == value ? true : false);
 }
+
+// CRC-32 (IEEE 802.3, as zlib), computed by nibble to keep the table small.
+// Start with crc = 0 and pass the previous result to continue with more data
+uint32_t getCRC32(uint32_t crc, const uint8_t *data, uint32_t len)
+{
+  static const uint32_t crcTable[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+  };
+
+  crc = ~crc;
+
+  while (len--)
+  {
+    crc ^= *data++;
+    crc = (crc >> 4) ^ crcTable[crc & 0x0F];
+    crc = (crc >> 4) ^ crcTable[crc & 0x0F];
+  }
+
+  return ~crc;
+}
@@ -75,6 +75,7 @@ const char *stripHead(const char *str);  // strip out any leading " ", "/" or ":
 void stripChecksum(char *str);           // strip out any trailing checksum that might be in the string
 uint8_t getChecksum(char *str);
 bool validateChecksum(char *str);
+uint32_t getCRC32(uint32_t crc, const uint8_t *data, uint32_t len);
 
 #ifdef __cplusplus
 }
@@ -2,10 +2,48 @@
 #include "includes.h"
 
 volatile uint32_t os_counter = 0;
+static uint32_t os_cyclesPerUs = 1;  // 1: no cycle counter, OS_GetCycles() counts us
+static uint32_t os_idleUs = 0;       // time asleep in OS_Idle() since os_loadStart
+static uint32_t os_loadStart = 0;
+static uint8_t os_cpuLoad = 100;
+
+#ifdef NATIVE_HOST
+#include <time.h>
+
+static uint64_t os_startUs;
+
+static uint64_t OS_HostTimeUs(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void OS_TimerTick(void);
+
+// there is no timer interrupt on the host, the ticks elapsed since the last call are run here
+static void OS_TimerPoll(void)
+{
+  static bool polling = false;
+
+  if (polling)  // a tick handler reads the time
+    return;
+
+  polling = true;
+  while (os_counter < (OS_HostTimeUs() - os_startUs) / 1000)
+  {
+    OS_TimerTick();
+  }
+  polling = false;
+}
+#endif
 
 void OS_TimerInitMs(void)
 {
-#ifdef GD32F2XX
+#if defined(NATIVE_HOST)
+  os_startUs = OS_HostTimeUs();
+#elif defined(GD32F2XX)
   nvic_irq_enable(TIMER6_IRQn, 2U, 0U);
 
   rcu_periph_clock_enable(RCU_TIMER6);
@@ -30,9 +68,35 @@ void OS_TimerInitMs(void)
   TIM7->DIER |= 1<<0;
   TIM7->CR1 |= 0x01;
 #endif
+
+#if !defined(NATIVE_HOST) && !defined(HW_SPI_TOUCH)
+  // touch panel sampler, pended by the tick. Lowest priority: every other interrupt preempts its conversions
+  NVIC_SetPriority(PendSV_IRQn, (1 << __NVIC_PRIO_BITS) - 1);
+#endif
+
+#ifndef NATIVE_HOST
+  // cycle counter of the profiler, the 1 us timer is used instead if the core has none
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  if ((DWT->CTRL & DWT_CTRL_NOCYCCNT_Msk) == 0 && DWT->CYCCNT != 0)
+    os_cyclesPerUs = mcuClocks.rccClocks.HCLK_Frequency / 1000000;
+#endif
 }
 
-#ifdef GD32F2XX
+#if defined(NATIVE_HOST)
+static void OS_TimerTick(void)
+{
+  os_counter++;
+
+  updatePrintTime(os_counter);
+
+  loopTouchScreen();
+
+  NATIVE_UartPoll();
+}
+#elif defined(GD32F2XX)
 void TIMER6_IRQHandler(void)
 {
   if ((TIMER_INTF(TIMER6) & 0x01) != 0)
@@ -43,7 +107,9 @@ void TIMER6_IRQHandler(void)
 
     updatePrintTime(os_counter);
 
-    loopTouchScreen();
+    #ifndef HW_SPI_TOUCH
+      SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;  // sample the touch panel in PendSV_Handler()
+    #endif
 
     if (os_counter == (uint32_t)(~0))
     {
@@ -62,7 +128,9 @@ void TIM7_IRQHandler(void)
 
     updatePrintTime(os_counter);
 
-    loopTouchScreen();
+    #ifndef HW_SPI_TOUCH
+      SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;  // sample the touch panel in PendSV_Handler()
+    #endif
 
     if (os_counter == (uint32_t)(~0))
     {
@@ -72,12 +140,132 @@ void TIM7_IRQHandler(void)
 }
 #endif
 
+#if !defined(NATIVE_HOST) && !defined(HW_SPI_TOUCH)
+void PendSV_Handler(void)
+{
+  loopTouchScreen();
+}
+#endif
+
 // 1ms
 uint32_t OS_GetTimeMs(void)
 {
+  #ifdef NATIVE_HOST
+    OS_TimerPoll();
+  #endif
+
   return os_counter;
 }
 
+// 1us, the timer counts us within the current ms
+uint32_t OS_GetTimeUs(void)
+{
+#ifdef NATIVE_HOST
+  OS_TimerPoll();
+  return OS_HostTimeUs() - os_startUs;
+#else
+  uint32_t ms;
+  uint32_t us;
+
+  do
+  {
+    ms = os_counter;
+
+    // when the counter wrapped but the tick is not handled yet (e.g. read from a higher priority interrupt),
+    // the counter is read again as the wrap may have come after the first read
+    #ifdef GD32F2XX
+      us = TIMER_CNT(TIMER6);
+
+      if ((TIMER_INTF(TIMER6) & 0x01) != 0)
+      {
+        us = TIMER_CNT(TIMER6) + 1000;
+      }
+    #else
+      us = TIM7->CNT;
+
+      if ((TIM7->SR & 0x01) != 0)
+      {
+        us = TIM7->CNT + 1000;
+      }
+    #endif
+  } while (ms != os_counter);  // the ms tick hit while reading
+
+  return ms * 1000 + us;
+#endif
+}
+
+// sleep until the next interrupt (the 1 ms tick at the latest) if isIdle() confirms that nothing is pending.
+// isIdle() is called with the interrupts disabled, an interrupt raised since then still wakes up the CPU
+void OS_Idle(uint8_t (*isIdle)(void))
+{
+  uint32_t start = OS_GetTimeUs();
+  uint8_t sleep;
+
+  __disable_irq();
+
+  if ((sleep = isIdle()))
+    __WFI();
+
+  __enable_irq();  // the interrupt waking up the CPU is handled here
+
+  if (sleep)
+    os_idleUs += OS_GetTimeUs() - start;
+}
+
+// CPU load in %, the time not spent in OS_Idle() since the previous update (at most once per second)
+uint8_t OS_GetCpuLoad(void)
+{
+  uint32_t elapsed = OS_GetTimeUs() - os_loadStart;
+
+  if (elapsed >= 1000000)
+  {
+    os_cpuLoad = 100 - MIN(os_idleUs / (elapsed / 100), 100);
+    os_loadStart += elapsed;
+    os_idleUs = 0;
+  }
+
+  return os_cpuLoad;
+}
+
+uint32_t OS_GetCycles(void)
+{
+#ifndef NATIVE_HOST
+  if (os_cyclesPerUs != 1)
+    return DWT->CYCCNT;
+#endif
+
+  return OS_GetTimeUs();
+}
+
+uint32_t OS_CyclesToUs(uint32_t cycles)
+{
+  return cycles / os_cyclesPerUs;
+}
+
+// add a run of "cycles" to the profile, return its time in us
+uint32_t OS_ProfAdd(OS_PROF *prof, uint32_t cycles)
+{
+  uint32_t us = cycles / os_cyclesPerUs;
+  uint8_t bucket = (31 - __builtin_clz(us | 1)) / 2;
+
+  prof->hist[bucket < OS_PROF_BUCKETS ? bucket : OS_PROF_BUCKETS - 1]++;
+
+  if (prof->count++ == 0 || cycles < prof->min)
+    prof->min = cycles;
+
+  if (cycles > prof->max)
+    prof->max = cycles;
+
+  prof->total += cycles;
+
+  return us;
+}
+
+void OS_ProfReset(OS_PROF *prof)
+{
+  memset(prof, 0, sizeof(OS_PROF));
+}
+
 /*
  * task: task structure to be filled
  * time_ms:
@@ -123,3 +311,74 @@ void OS_TaskDisable(OS_TASK *task_t)
 {
   task_t->is_exist = 0;
 }
+
+static inline uint8_t OS_SchedDue(OS_TASK *task)
+{
+  return task->is_exist && (int32_t)(OS_GetTimeMs() - task->next_time) >= 0;
+}
+
+static void OS_SchedTask(OS_TASK *task)
+{
+  uint32_t start;
+
+  if (task->is_repeat == 0)
+    task->is_exist = 0;
+  else if (task->time_ms != 0)
+    task->next_time = OS_GetTimeMs() + task->time_ms;
+
+  start = OS_GetCycles();
+  (*task->task)(task->para);
+
+  if (OS_ProfAdd(&task->prof, OS_GetCycles() - start) > task->budget_us)
+    task->overruns++;
+}
+
+/*
+ * run the due tasks with a priority from firstPrio to lastPrio, by priority and then in table order.
+ * time_ms is the period of a task (0: every pass)
+ */
+void OS_SchedRun(OS_SCHED *sched, uint8_t firstPrio, uint8_t lastPrio)
+{
+  uint32_t start = OS_GetTimeUs();
+
+  for (uint8_t prio = firstPrio; prio <= lastPrio; prio++)
+  {
+    for (uint8_t i = 0; i < sched->count; i++)
+    {
+      OS_TASK *task = &sched->tasks[i];
+
+      if (task->priority != prio || !OS_SchedDue(task))
+        continue;
+
+      if (prio >= OS_PRIO_LOW && !task->is_deferred && OS_GetTimeUs() - start > sched->budget_us)
+      {
+        task->is_deferred = 1;
+        sched->deferred++;
+        continue;
+      }
+
+      task->is_deferred = 0;
+      OS_SchedTask(task);
+
+      if (sched->interleave && prio >= OS_PRIO_LOW)
+      {
+        for (uint8_t j = 0; j < sched->count; j++)
+        {
+          if (sched->tasks[j].priority == OS_PRIO_SERIAL && OS_SchedDue(&sched->tasks[j]))
+            OS_SchedTask(&sched->tasks[j]);
+        }
+      }
+    }
+  }
+}
+
+void OS_SchedResetStats(OS_SCHED *sched)
+{
+  for (uint8_t i = 0; i < sched->count; i++)
+  {
+    sched->tasks[i].overruns = 0;
+    OS_ProfReset(&sched->tasks[i].prof);
+  }
+
+  sched->deferred = 0;
+}
@@ -9,6 +9,27 @@ extern "C" {
 
 typedef void (*FP_TASK)(void *);
 
+#define OS_PROF_BUCKETS 8  // run time histogram: < 4 us, < 16 us, < 64 us, ... < 16 ms, longer
+
+typedef struct
+{
+  uint32_t count;
+  uint32_t min;    // cycles
+  uint32_t max;    // cycles
+  uint64_t total;  // cycles
+  uint32_t hist[OS_PROF_BUCKETS];
+} OS_PROF;
+
+// priorities of the tasks run by OS_SchedRun(), from the highest
+enum
+{
+  OS_PRIO_SERIAL = 0,  // host communication, also run after each OS_PRIO_LOW and OS_PRIO_UI task if interleave is set
+  OS_PRIO_HIGH,        // back end monitors, run on every pass
+  OS_PRIO_LOW,         // back end tasks waiting for the next pass once the pass budget is spent
+  OS_PRIO_UI,          // front end tasks, same as OS_PRIO_LOW
+  OS_PRIO_COUNT
+};
+
 typedef struct
 {
   uint32_t time_ms;
@@ -17,16 +38,44 @@ typedef struct
   void     *para;
   uint8_t  is_exist;
   uint8_t  is_repeat;
+  // scheduler
+  const char *name;
+  uint8_t  priority;
+  uint8_t  is_deferred;  // skipped by a pass out of budget, run on the next pass whatever the time spent
+  uint16_t budget_us;    // longer runs are counted as overruns
+  uint32_t overruns;
+  OS_PROF  prof;
 } OS_TASK;
 
+typedef struct
+{
+  OS_TASK  *tasks;
+  uint8_t  count;
+  uint8_t  interleave;  // run the OS_PRIO_SERIAL tasks again after each OS_PRIO_LOW and OS_PRIO_UI task
+  uint16_t budget_us;   // time of a pass after which its OS_PRIO_LOW and OS_PRIO_UI tasks are deferred
+  uint32_t deferred;    // tasks deferred to the next pass
+} OS_SCHED;
+
 void OS_TimerInitMs(void);
 uint32_t OS_GetTimeMs(void);
+uint32_t OS_GetTimeUs(void);
+uint32_t OS_GetCycles(void);
+uint32_t OS_CyclesToUs(uint32_t cycles);
+
+void OS_Idle(uint8_t (*isIdle)(void));
+uint8_t OS_GetCpuLoad(void);
+
+uint32_t OS_ProfAdd(OS_PROF *prof, uint32_t cycles);
+void OS_ProfReset(OS_PROF *prof);
 
 void OS_TaskInit(OS_TASK *task, uint32_t time_ms, FP_TASK function, void *para);
 void OS_TaskCheck(OS_TASK *task);
 void OS_TaskEnable(OS_TASK *task, uint8_t is_exec, uint8_t is_repeat);
 void OS_TaskDisable(OS_TASK *task);
 
+void OS_SchedRun(OS_SCHED *sched, uint8_t firstPrio, uint8_t lastPrio);
+void OS_SchedResetStats(OS_SCHED *sched);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,125 @@
+#
+# Run targets of the NATIVE_HOST env, e.g. "pio run -e NATIVE_HOST -t bench":
+#   walk  - capture each menu to a PNG, with its LCD and SPI flash traffic
+#   bench - parsing, gcode queue and drawing benchmarks
+#   serve - run until stopped, the printer port is a pseudo terminal (its name is printed at start)
+#   print - print the gcode file named by $TFT_PRINT_FILE to printer_emulator.py and report the streaming,
+#           the emulator options (planner size, error rate etc...) can be given in $TFT_PRINTER_ARGS
+# The program runs in .pio/native, with an SD card built from the TFT35 folder of the default theme and config.ini.
+# The print runs in .pio/native_print, with an SD card rebuilt around the gcode file at each run
+#
+Import("env")
+import os
+import shutil
+import sys
+
+sd_source = os.path.join(env.subst("$PROJECT_DIR"), "Copy to SD Card root directory to update")
+theme_dir = os.path.join(sd_source, "THEME_Unified Menu Material theme")
+
+FONT_HEIGHT = 24        # BYTE_HEIGHT of the TFT35 (480x320) resolution, the glyphs of word_unicode.fon are square
+FONT_GLYPHS = 0x10000   # word_unicode.fon holds the code points 0x0000 to 0xFFFF
+
+# a glyph is stored by columns, from left to right, of (height + 7) / 8 bytes each, the MSB is the top pixel
+def glyph_bytes(height):
+    return height * ((height + 7) // 8)
+
+# scale a word_unicode.fon to FONT_HEIGHT pixels glyphs (nearest pixel), return False if its glyph size is unknown
+def scale_unicode_font(source, target):
+    with open(source, "rb") as f:
+        data = f.read()
+
+    src_height = next((h for h in range(8, 65) if glyph_bytes(h) * FONT_GLYPHS == len(data)), None)
+    if src_height is None:
+        return False
+
+    src_col_bytes = (src_height + 7) // 8
+    col_bytes = (FONT_HEIGHT + 7) // 8
+    src_cols = [x * src_height // FONT_HEIGHT for x in range(FONT_HEIGHT)]
+    src_rows = [src_col_bytes * 8 - 1 - y * src_height // FONT_HEIGHT for y in range(FONT_HEIGHT)]
+    scaled_cols = {}
+    out = bytearray()
+
+    for glyph in range(FONT_GLYPHS):
+        start = glyph * glyph_bytes(src_height)
+        for x in src_cols:
+            col = data[start + x * src_col_bytes:start + (x + 1) * src_col_bytes]
+            if col not in scaled_cols:
+                bits = int.from_bytes(col, "big")
+                value = 0
+                for y, row in enumerate(src_rows):
+                    if bits >> row & 1:
+                        value |= 1 << (col_bytes * 8 - 1 - y)
+                scaled_cols[col] = value.to_bytes(col_bytes, "big")
+            out += scaled_cols[col]
+
+    with open(target, "wb") as f:
+        f.write(out)
+    return True
+
+def prepare_sd_dir(sd_dir):
+    shutil.copytree(os.path.join(theme_dir, "TFT35"), os.path.join(sd_dir, "TFT35"))
+    shutil.copyfile(os.path.join(sd_source, "config.ini"), os.path.join(sd_dir, "config.ini"))
+
+    # the TFT35 theme folder has no unicode font and the update needs one to complete,
+    # it is generated from the 16 pixels font of the TFT28 folder
+    font = os.path.join(sd_dir, "TFT35", "font", "word_unicode.fon")
+    source = os.path.join(theme_dir, "TFT28", "font", "word_unicode.fon")
+    if os.path.isfile(font):
+        return
+    if not os.path.isfile(source) or not scale_unicode_font(source, font):
+        shutil.rmtree(sd_dir, ignore_errors=True)  # prepared again by the next run
+        sys.exit("No word_unicode.fon for the TFT35 folder: add a %d pixels one to %s or a square one of another size to %s"
+                 % (FONT_HEIGHT, os.path.join(theme_dir, "TFT35", "font"), source))
+
+def prepare_run_dir(run_dir):
+    sd_dir = os.path.join(run_dir, "sdcard")
+    if not os.path.isdir(sd_dir):
+        prepare_sd_dir(sd_dir)
+
+def prepare_print_dir(print_dir, gcode):
+    sd_dir = os.path.join(print_dir, "sdcard")
+    image = os.path.join(print_dir, "sdcard.img")
+
+    shutil.rmtree(sd_dir, ignore_errors=True)
+    if os.path.isfile(image):
+        os.remove(image)
+
+    if os.path.isfile(os.path.join(print_dir, "w25qxx.bin")):  # icons and fonts already loaded by the first run
+        os.makedirs(sd_dir)
+    else:
+        prepare_sd_dir(sd_dir)
+
+    shutil.copyfile(gcode, os.path.join(sd_dir, os.path.basename(gcode)))
+
+def add_run_target(name, description, pty):
+    run_dir = os.path.join(env.subst("$PROJECT_DIR"), ".pio", "native")
+
+    def run(target, source, env):
+        prepare_run_dir(run_dir)
+        command = 'cd "%s" && TFT_NATIVE_DIR="%s" TFT_NATIVE_RUN=%s %s"%s"' % (
+            run_dir, run_dir, name, "TFT_NATIVE_PTY=1 " if pty else "", env.subst("$BUILD_DIR/${PROGNAME}"))
+        return env.Execute(command)
+
+    env.AddCustomTarget(name=name, dependencies="$BUILD_DIR/${PROGNAME}", actions=[run], title=name,
+                        description=description)
+
+add_run_target("walk", "Capture the menus of the native build", False)
+add_run_target("bench", "Run the benchmarks of the native build", False)
+add_run_target("serve", "Run the native build with its printer port on a pseudo terminal", True)
+
+def print_run(target, source, env):
+    print_dir = os.path.join(env.subst("$PROJECT_DIR"), ".pio", "native_print")
+    gcode = os.environ.get("TFT_PRINT_FILE")
+
+    if gcode is None or not os.path.isfile(gcode):
+        print("Set TFT_PRINT_FILE to the gcode file to print")
+        return 1
+
+    prepare_print_dir(print_dir, gcode)
+    command = 'cd "%s" && TFT_NATIVE_DIR="%s" "$PYTHONEXE" "%s" --run "%s" --print "%s" %s' % (
+        print_dir, print_dir, os.path.join(env.subst("$PROJECT_DIR"), "buildroot", "scripts", "printer_emulator.py"),
+        env.subst("$BUILD_DIR/${PROGNAME}"), os.path.basename(gcode), os.environ.get("TFT_PRINTER_ARGS", ""))
+    return env.Execute(command)
+
+env.AddCustomTarget(name="print", dependencies="$BUILD_DIR/${PROGNAME}", actions=[print_run], title="print",
+                    description="Print a gcode file of the native build to the printer emulator")
@@ -0,0 +1,528 @@
+#!/usr/bin/env python3
+#
+# Printer emulator for the native build: a Marlin (or RepRapFirmware) printer answering on the pseudo terminal
+# of the TFT printer port, to measure the gcode streaming of the TFT against a reproducible printer.
+#
+# - planner buffer of --planner moves: the "ok" of a move is held while the buffer is full, moves take
+#   their distance / feedrate (divided by --speed) to run
+# - ADVANCED_OK ("ok N.. P.. B..") with --advanced-ok
+# - line number and checksum check, answered by "Resend:" (the TFT of RRF printers adds them to each gcode)
+# - M105, M114 and M27 queries and their M155, M154 and M27 S<seconds> auto reports
+# - --error-rate: probability of a line received corrupted (one byte changed), --seed makes it reproducible
+#
+# Usage:
+#   printer_emulator.py --port /dev/pts/N    attach to "pio run -e NATIVE_HOST -t serve", stop with Ctrl-C
+#   printer_emulator.py --run PROGRAM --print FILE
+#                                           run the native build (TFT_NATIVE_RUN=print), it prints FILE from
+#                                           its SD card and exits when done (used by the "print" target)
+#
+# On exit the streaming of the print is reported: commands per second, planner starvations (the planner
+# ran empty while waiting for the next gcode of the TFT) and the "ok" turnaround (time from an "ok" to the
+# next gcode received).
+#
+import argparse
+import collections
+import math
+import os
+import random
+import re
+import select
+import subprocess
+import sys
+import time
+import tty
+
+MARLIN_CAPS = ["EEPROM:1", "AUTOREPORT_TEMP:1", "AUTOREPORT_POS:1", "AUTOREPORT_SD_STATUS:1", "SDCARD:0",
+               "EMERGENCY_PARSER:0", "PROMPT_SUPPORT:0", "TOGGLE_LIGHTS:0", "Z_PROBE:0", "AUTOLEVEL:0"]
+
+BUSY_INTERVAL = 2.0  # seconds between "busy: processing" of Marlin HOST_KEEPALIVE_FEATURE
+TEMP_INTERVAL = 1.0  # seconds between temperature reports while heating (M109, M190)
+
+class Stats:
+    def __init__(self):
+        self.active = False
+        self.start = self.end = 0.0
+        self.commands = 0
+        self.moves = 0
+        self.starvations = 0
+        self.starved = 0.0
+        self.turnarounds = []
+        self.resends = 0
+        self.corrupted = 0
+
+    def begin(self, now):
+        if not self.active:
+            self.__init__()
+            self.active = True
+            self.start = now
+
+    def finish(self, now):
+        if self.active:
+            self.active = False
+            self.end = now
+
+    def report(self, now):
+        self.finish(now)
+        if self.start == 0:
+            print("no print streamed")
+            return
+
+        elapsed = max(self.end - self.start, 1e-9)
+        print("commands           %8d" % self.commands)
+        print("moves              %8d" % self.moves)
+        print("time               %8.2f s" % elapsed)
+        print("commands/s         %8.1f" % (self.commands / elapsed))
+        print("planner starvations%8d   %.2f s starved" % (self.starvations, self.starved))
+
+        if self.turnarounds:
+            ms = sorted(t * 1000 for t in self.turnarounds)
+            pick = lambda p: ms[min(len(ms) - 1, int(len(ms) * p))]
+            print("ok turnaround      %8.2f ms mean %.2f p50 %.2f p99 %.2f max" %
+                  (sum(ms) / len(ms), pick(0.5), pick(0.99), ms[-1]))
+
+        print("lines corrupted    %8d" % self.corrupted)
+        print("resend requests    %8d" % self.resends)
+
+class Printer:
+    def __init__(self, args, stats):
+        self.args = args
+        self.stats = stats
+        self.rrf = args.firmware == "reprap"
+        self.rand = random.Random(args.seed)
+        self.fd = -1
+        self.closed = False                # the TFT closed the serial line (e.g. it exited)
+        self.rx = b""
+        self.lines = collections.deque()  # lines received, not processed yet (Marlin BUFSIZE)
+        self.planner = collections.deque()  # durations of the moves in the planner
+        self.head_end = 0.0                # end time of the move running (planner head)
+        self.empty_since = None            # start of a planner starvation
+        self.waiting = None                # end condition of the long command at the head of self.lines
+        self.ok_time = None                # time of the last "ok" sent with no line pending
+        self.last_line = 0
+        self.pos = {"X": 0.0, "Y": 0.0, "Z": 0.0, "E": 0.0}
+        self.feedrate = 3000.0
+        self.relative = False
+        self.relative_e = False
+        self.temp = {"T": 25.0, "B": 25.0}
+        self.target = {"T": 0.0, "B": 0.0}
+        self.feed_percent = 100
+        self.flow_percent = 100
+        self.reports = {"M155": [0, 0.0], "M154": [0, 0.0], "M27": [0, 0.0]}  # interval (s) and next time
+        self.next_busy = 0.0
+        self.next_temp = 0.0
+        self.last_tick = time.monotonic()
+
+    # serial line
+
+    def attach(self, port):
+        self.fd = os.open(port, os.O_RDWR | os.O_NOCTTY | os.O_NONBLOCK)
+        tty.setraw(self.fd)
+
+    def send(self, text):
+        if self.closed:
+            return
+
+        if self.args.verbose:
+            print("< " + text)
+
+        data = (text + "\n").encode()
+        while data:
+            try:
+                data = data[os.write(self.fd, data):]
+            except BlockingIOError:  # the TFT is not reading, e.g. busy drawing
+                select.select([], [self.fd], [], 0.1)
+            except OSError:  # the other end was closed (EIO)
+                self.closed = True
+                return
+
+    def ok(self, now, text=""):
+        if self.args.advanced_ok and not self.rrf:
+            self.send("ok N%d P%d B%d%s" % (self.last_line, self.args.planner - len(self.planner),
+                                            self.args.bufsize - len(self.lines), text))
+        else:
+            self.send("ok" + text)
+
+        if len(self.lines) <= 1:  # the next gcode is up to the TFT
+            self.ok_time = now
+
+    def receive(self, now):
+        try:
+            data = os.read(self.fd, 4096)
+        except BlockingIOError:
+            return True
+        except OSError:  # the other end was closed
+            self.closed = True
+            return False
+
+        if not data:  # end of file, the other end was closed
+            self.closed = True
+            return False
+
+        self.rx += data
+        while b"\n" in self.rx:
+            line, self.rx = self.rx.split(b"\n", 1)
+            line = line.decode(errors="replace").strip()
+
+            if not line:
+                continue
+
+            if self.args.verbose:
+                print("> " + line)
+
+            if self.ok_time is not None and self.stats.active:
+                self.stats.turnarounds.append(now - self.ok_time)
+            self.ok_time = None
+
+            if self.args.error_rate > 0 and self.rand.random() < self.args.error_rate:
+                i = self.rand.randrange(len(line))
+                line = line[:i] + chr((ord(line[i]) ^ 0x04) or 0x20) + line[i + 1:]
+                self.stats.corrupted += 1
+
+            self.lines.append(line)
+
+        return True
+
+    # motion and heaters
+
+    def tick(self, now):
+        while self.planner and self.head_end <= now:
+            self.planner.popleft()
+            if self.planner:
+                self.head_end += self.planner[0]
+            elif self.waiting is None:  # not drained on purpose by a long command
+                self.empty_since = self.head_end
+
+        rate = self.args.heat_rate * self.args.speed * (now - self.last_tick)
+        self.last_tick = now
+        for h in self.temp:
+            goal = self.target[h] if self.target[h] > 0 else 25.0
+            if self.temp[h] < goal:
+                self.temp[h] = min(goal, self.temp[h] + rate)
+            else:
+                self.temp[h] = max(goal, self.temp[h] - rate)
+
+        for code, (interval, due) in self.reports.items():
+            if interval and now >= due:
+                self.reports[code][1] = now + interval
+                self.send(self.report(code))
+
+    def next_event(self, now):
+        events = [now + 0.05]
+        if self.planner:
+            events.append(self.head_end)
+        events += [due for interval, due in self.reports.values() if interval]
+        return max(0.0, min(events) - now)
+
+    def queue_move(self, duration, now):
+        if not self.planner:
+            self.head_end = now + duration
+            if self.empty_since is not None and self.stats.active:
+                self.stats.starvations += 1
+                self.stats.starved += now - self.empty_since
+        self.empty_since = None
+        self.planner.append(duration)
+
+    def temp_string(self):
+        return "T:%.2f /%.2f B:%.2f /%.2f @:0 B@:0" % (self.temp["T"], self.target["T"], self.temp["B"],
+                                                       self.target["B"])
+
+    def report(self, code):
+        if code == "M155":
+            return self.temp_string()
+        if code == "M154":
+            p = self.pos
+            return "X:%.2f Y:%.2f Z:%.2f E:%.2f Count X:%d Y:%d Z:%d" % (p["X"], p["Y"], p["Z"], p["E"],
+                                                                        p["X"] * 80, p["Y"] * 80, p["Z"] * 400)
+        return "Not SD printing"
+
+    # gcodes
+
+    def check_line(self, line):
+        """Strip the line number and checksum, None if the line must be sent again"""
+        if not line.startswith("N"):
+            return line
+
+        star = line.rfind("*")
+        match = re.match(r"N(\d+)\s*", line)
+        number = int(match.group(1)) if match else -1
+
+        if star >= 0:
+            checksum = 0
+            for c in line[:star].encode():
+                checksum ^= c
+            if not line[star + 1:].isdigit() or int(line[star + 1:]) != checksum:
+                self.resend("checksum mismatch")
+                return None
+            line = line[:star]
+
+        if match is None:
+            self.resend("No Line Number with checksum")
+            return None
+
+        command = line[match.end():]
+        if command.startswith("M110"):
+            number = self.param(command, "N", number)
+        elif number != self.last_line + 1 and not self.rrf:  # RRF only checks the checksum
+            self.resend("Line Number is not Last Line Number+1")
+            return None
+
+        self.last_line = int(number)
+        return command
+
+    def resend(self, error):
+        self.stats.resends += 1
+        self.send("Error:%s, Last Line: %d" % (error, self.last_line))
+        self.send("Resend: %d" % (self.last_line + 1))
+
+    @staticmethod
+    def param(command, letter, default=None):
+        match = re.search(r"(?:^|\s)" + letter + r"(-?\d*\.?\d+)", command)
+        return float(match.group(1)) if match else default
+
+    def move(self, command, now):
+        if len(self.planner) >= self.args.planner:
+            return False  # the "ok" waits for a free block
+
+        target = dict(self.pos)
+        for axis in target:
+            value = self.param(command, axis)
+            if value is not None:
+                relative = self.relative_e if axis == "E" else self.relative
+                target[axis] = target[axis] + value if relative else value
+
+        self.feedrate = self.param(command, "F", self.feedrate) or self.feedrate
+        distance = math.sqrt(sum((target[a] - self.pos[a]) ** 2 for a in "XYZ")) or abs(target["E"] - self.pos["E"])
+        self.pos = target
+
+        if distance > 0:
+            speed = self.feedrate * max(self.feed_percent, 1) / 100 / 60  # mm/s
+            self.queue_move(distance / speed / self.args.speed, now)
+            self.stats.moves += 1
+
+        return True
+
+    def wait(self, command, now):
+        """Long commands: run the planner empty, then wait for their end with the keepalive messages"""
+        if self.waiting is None:
+            code = command.split()[0]
+            if code in ("M109", "M190"):
+                heater = "T" if code == "M109" else "B"
+                self.target[heater] = self.param(command, "S", self.param(command, "R", self.target[heater]))
+                self.waiting = lambda t: abs(self.temp[heater] - self.target[heater]) < 1
+            elif code == "G28":
+                end = [None]
+                def homed(t):
+                    end[0] = end[0] or t + self.args.home_time / self.args.speed
+                    return t >= end[0]
+                self.waiting = homed
+            elif code == "G4":
+                end = [None]
+                seconds = self.param(command, "S", 0) + self.param(command, "P", 0) / 1000
+                def dwelled(t):
+                    end[0] = end[0] or t + seconds / self.args.speed
+                    return t >= end[0]
+                self.waiting = dwelled
+            else:  # M400
+                self.waiting = lambda t: True
+            self.next_busy = now + BUSY_INTERVAL
+            self.next_temp = now + TEMP_INTERVAL
+            self.empty_since = None
+
+        if now >= self.next_busy:
+            self.next_busy = now + BUSY_INTERVAL
+            self.send("echo:busy: processing")
+
+        if command.startswith(("M109", "M190")) and now >= self.next_temp:
+            self.next_temp = now + TEMP_INTERVAL
+            self.send(self.temp_string() + " W:?")
+
+        if self.planner or not self.waiting(now):
+            return False
+
+        self.waiting = None
+        if command.startswith("G28"):
+            self.pos.update({"X": 0.0, "Y": 0.0, "Z": 0.0})
+        return True
+
+    def execute(self, command, now):
+        """Run a gcode, False while it can't complete (planner full or long command)"""
+        word = command.split()[0].upper()
+
+        if word in ("G0", "G1", "G2", "G3"):
+            if not self.move(command, now):
+                return False
+        elif word in ("G28", "G4", "M109", "M190", "M400"):
+            if not self.wait(command, now):
+                return False
+        elif word == "G90":
+            self.relative = self.relative_e = False
+        elif word == "G91":
+            self.relative = self.relative_e = True
+        elif word == "M82":
+            self.relative_e = False
+        elif word == "M83":
+            self.relative_e = True
+        elif word == "G92":
+            for axis in self.pos:
+                self.pos[axis] = self.param(command, axis, self.pos[axis])
+        elif word in ("M104", "M140"):
+            self.target["T" if word == "M104" else "B"] = self.param(command, "S", 0)
+        elif word in ("M155", "M154", "M27") and self.param(command, "S") is not None:
+            interval = self.param(command, "S")
+            self.reports[word] = [interval, now + interval]
+        elif word == "M105":
+            self.ok(now, " " + self.temp_string())
+            return True
+        elif word in ("M114", "M27"):
+            self.send(self.report("M154" if word == "M114" else "M27"))
+        elif word == "M115":
+            self.firmware_info()
+        elif word == "M220":
+            self.feed_percent = int(self.param(command, "S", self.feed_percent))
+            self.send("FR:%d%%" % self.feed_percent)
+        elif word == "M221":
+            self.flow_percent = int(self.param(command, "S", self.flow_percent))
+            self.send("E0 Flow: %d%%" % self.flow_percent)
+        elif word == "M92" or word == "M503":
+            self.send("echo:  M92 X80.00 Y80.00 Z400.00 E93.00")
+        elif word == "M211":
+            self.send("echo:Soft endstops: On   Min:  X0.00 Y0.00 Z0.00   Max:  X235.00 Y235.00 Z250.00")
+        elif word in ("M408", "M409") and self.rrf:
+            self.rrf_status(command)
+            return True  # the JSON reply is the acknowledge
+        elif not re.match(r"^[GMT]\d+$", word):
+            self.send('echo:Unknown command: "%s"' % command)
+
+        self.ok(now)
+        return True
+
+    def firmware_info(self):
+        if self.rrf:
+            self.send("FIRMWARE_NAME: RepRapFirmware for Duet 3 Mini 5+ FIRMWARE_VERSION: 3.4.1 "
+                      "ELECTRONICS: Emulator FIRMWARE_DATE: 2022-06-01")
+            return
+
+        self.send("FIRMWARE_NAME:Marlin bugfix-2.1.x (Emulator) SOURCE_CODE_URL:github.com/MarlinFirmware/Marlin "
+                  "PROTOCOL_VERSION:1.0 MACHINE_TYPE:Emulator EXTRUDER_COUNT:1")
+        for cap in MARLIN_CAPS + ["ADVANCED_OK:%d" % self.args.advanced_ok]:
+            self.send("Cap:" + cap)
+
+    def rrf_status(self, command):
+        if command.startswith("M409"):
+            self.send('{"key":"job.file.fileName","flags":"","result":null}')
+            return
+
+        self.send('{"status":"%s","heaters":[%.1f,%.1f],"active":[%.1f,%.1f],"standby":[0,0],"hstat":[%d,%d],'
+                  '"pos":[%.2f,%.2f,%.2f],"sfactor":%d,"efactor":[%d],"babystep":0,"tool":0,"probe":"0",'
+                  '"fanPercent":[0],"homed":[1,1,1],"fraction_printed":0,"msgBox.mode":-1}' %
+                  ("P" if self.planner else "I", self.temp["B"], self.temp["T"], self.target["B"], self.target["T"],
+                   2 if self.target["B"] else 0, 2 if self.target["T"] else 0, self.pos["X"], self.pos["Y"],
+                   self.pos["Z"], self.feed_percent, self.flow_percent))
+
+    def process(self, now):
+        while self.lines:
+            command = self.lines[0] if self.waiting else self.check_line(self.lines[0])
+
+            if command is None:  # rejected, the "ok" still follows the error
+                self.lines.popleft()
+                self.ok(now)
+                continue
+
+            self.lines[0] = command
+            if not command or command.startswith(";"):
+                self.lines.popleft()
+                self.ok(now)
+                continue
+
+            if not self.execute(command, now):
+                return
+
+            self.lines.popleft()
+            self.stats.commands += 1
+            if not self.stats.active and self.stats.start == 0 and self.args.run is None and self.stats.moves:
+                self.stats.begin(now)  # attached to a running TFT, the print starts with the first move
+
+def run(args):
+    stats = Stats()
+    printer = Printer(args, stats)
+    program = None
+    inputs = []
+
+    if args.run is not None:
+        env = dict(os.environ, TFT_NATIVE_RUN="print", TFT_NATIVE_PTY="1", TFT_NATIVE_FILE=args.print)
+        env.setdefault("TFT_NATIVE_DIR", os.getcwd())
+        program = subprocess.Popen([args.run], stdout=subprocess.PIPE, env=env)
+        inputs.append(program.stdout.fileno())
+        program_out = b""
+    else:
+        printer.attach(args.port)
+        inputs.append(printer.fd)
+
+    try:
+        while inputs:
+            now = time.monotonic()
+            ready, _, _ = select.select(inputs, [], [], printer.next_event(now))
+            now = time.monotonic()
+
+            if program is not None and program.stdout.fileno() in ready:
+                data = os.read(program.stdout.fileno(), 4096)
+                if not data:
+                    break
+                program_out += data
+                while b"\n" in program_out:
+                    line, program_out = program_out.split(b"\n", 1)
+                    line = line.decode(errors="replace")
+                    print("tft: " + line)
+                    if line.startswith("printer port: ") and printer.fd < 0:
+                        printer.attach(line[len("printer port: "):])
+                        inputs.append(printer.fd)
+                    elif line.startswith("print: ") and line.endswith(" started"):
+                        stats.begin(now)
+                    elif line.startswith("print: ") and " done" in line:
+                        stats.finish(now)
+
+            if printer.fd in ready:
+                printer.receive(now)
+
+            if printer.fd >= 0 and not printer.closed:
+                printer.tick(now)
+                printer.process(now)
+
+            if printer.closed and printer.fd in inputs:  # disconnected, the stats are still reported
+                inputs.remove(printer.fd)
+    except KeyboardInterrupt:
+        pass
+
+    stats.report(time.monotonic())
+
+    if program is not None:
+        if program.poll() is None:
+            program.terminate()
+        return program.wait()
+    return 0
+
+def main():
+    parser = argparse.ArgumentParser(description="Printer emulator for the native build of the TFT firmware")
+    target = parser.add_mutually_exclusive_group(required=True)
+    target.add_argument("--port", help="pseudo terminal of a running native build")
+    target.add_argument("--run", help="native build to run, printing --print")
+    parser.add_argument("--print", help="gcode file to print, from the root of the SD card of the native build")
+    parser.add_argument("--firmware", choices=["marlin", "reprap"], default="marlin")
+    parser.add_argument("--planner", type=int, default=16, help="planner buffer size (moves)")
+    parser.add_argument("--bufsize", type=int, default=4, help="serial command buffer size (ADVANCED_OK B)")
+    parser.add_argument("--advanced-ok", type=int, choices=[0, 1], default=0)
+    parser.add_argument("--error-rate", type=float, default=0.0, help="probability of a line received corrupted")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--speed", type=float, default=1.0, help="time scale of the moves, homing and heating")
+    parser.add_argument("--heat-rate", type=float, default=5.0, help="heating and cooling rate (degrees/s)")
+    parser.add_argument("--home-time", type=float, default=2.0, help="G28 duration (s)")
+    parser.add_argument("--verbose", action="store_true", help="print the lines received (>) and sent (<)")
+    args = parser.parse_args()
+
+    if args.run is not None and args.print is None:
+        parser.error("--run needs --print")
+
+    sys.exit(run(args))
+
+if __name__ == "__main__":
+    main()